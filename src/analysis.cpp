@@ -5,22 +5,32 @@
 #include "reactioncoordinate.h"
 #include "multipole.h"
 #include "potentials.h"
+#include "celllistimpl.h"
 #include "aux/iteratorsupport.h"
 #include "aux/eigensupport.h"
 #include "aux/arange.h"
 #include "aux/matrixmarket.h"
 #include <range/v3/numeric/accumulate.hpp>
 #include <range/v3/algorithm/for_each.hpp>
+#include <range/v3/algorithm/copy.hpp>
 #include <range/v3/view/cache1.hpp>
 #include <spdlog/spdlog.h>
 #include <spdlog/fmt/ostr.h>
-#include <zstr.hpp>
-#include <cereal/types/memory.hpp>
-#include <cereal/archives/binary.hpp>
+#include <doctest/doctest.h>
 
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <thread>
+#include <future>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <typeinfo>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace Faunus::Analysis {
 
@@ -48,13 +58,11 @@ void Analysisbase::to_disk() { _to_disk(); }
 void Analysisbase::sample() {
     try {
         number_of_steps++;
-        if (sample_interval > 0 && number_of_steps > number_of_skipped_steps) {
-            if ((number_of_steps % sample_interval) == 0) {
-                number_of_samples++;
-                timer.start();
-                _sample();
-                timer.stop();
-            }
+        if (isSampleStep(number_of_steps)) {
+            number_of_samples++;
+            timer.start();
+            _sample();
+            timer.stop();
         }
     } catch (std::exception& e) {
         throw std::runtime_error(name + ": " + e.what());
@@ -99,6 +107,39 @@ void Analysisbase::_from_json(const json&) {}
 
 int Analysisbase::getNumberOfSteps() const { return number_of_steps; }
 
+/**
+ * Used to let an instance start at a given step of a trajectory; the sample interval and
+ * skipped steps thus refer to the absolute frame number.
+ */
+void Analysisbase::advanceSteps(int steps) { number_of_steps += steps; }
+
+/**
+ * This is virtual and must be overridden by analyses whose samples can be combined
+ */
+void Analysisbase::_merge(const Analysisbase&) { throw std::runtime_error("merging is unsupported"); }
+
+/**
+ * The other instance is assumed to have sampled different steps. The sample counts are
+ * added while the step count is the largest of the two, as each instance is advanced over
+ * steps sampled by others (see `advanceSteps()`).
+ */
+void Analysisbase::merge(const Analysisbase& other) {
+    try {
+        if (typeid(*this) != typeid(other) || name != other.name) {
+            throw std::runtime_error("cannot merge with "s + other.name);
+        }
+        _merge(other);
+        number_of_samples += other.number_of_samples;
+        number_of_steps = std::max(number_of_steps, other.number_of_steps);
+    } catch (std::exception& e) {
+        throw std::runtime_error(name + ": " + e.what());
+    }
+}
+
+bool Analysisbase::isSampleStep(int step) const {
+    return sample_interval > 0 && step > number_of_skipped_steps && (step % sample_interval) == 0;
+}
+
 Analysisbase::Analysisbase(const Space& spc, std::string_view name) : spc(spc), name(name) { assert(!name.empty()); }
 
 Analysisbase::Analysisbase(const Space& spc, std::string_view name, int sample_interval, int number_of_skipped_steps)
@@ -116,7 +157,7 @@ Analysisbase::Analysisbase(const Space& spc, std::string_view name, int sample_i
  * @return shared pointer to created analysis base class
  */
 std::unique_ptr<Analysisbase> createAnalysis(const std::string& name, const json& j, Space& spc,
-                                             Energy::Hamiltonian& pot) {
+                                             Energy::Hamiltonian& pot, const json& input) {
     try {
         if (name == "atomprofile") {
             return std::make_unique<AtomProfile>(j, spc);
@@ -181,7 +222,7 @@ std::unique_ptr<Analysisbase> createAnalysis(const std::string& name, const json
         } else if (name == "virtualtranslate") {
             return std::make_unique<VirtualTranslate>(j, spc, pot);
         } else if (name == "widom") {
-            return std::make_unique<WidomInsertion>(j, spc, pot);
+            return std::make_unique<WidomInsertion>(j, spc, pot, input);
         } else if (name == "xtcfile") {
             return std::make_unique<XTCtraj>(j, spc);
         } else if (name == "spacetraj") {
@@ -195,32 +236,266 @@ std::unique_ptr<Analysisbase> createAnalysis(const std::string& name, const json
     }
 }
 
+/**
+ * @brief Fixed number of threads executing tasks in submission order
+ */
+class CombinedAnalysis::ThreadPool {
+    std::vector<std::thread> threads;
+    std::deque<std::packaged_task<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable task_available;
+    bool stopping = false;
+
+    void run() {
+        while (true) {
+            std::packaged_task<void()> task;
+            {
+                std::unique_lock lock(mutex);
+                task_available.wait(lock, [&] { return stopping || !tasks.empty(); });
+                if (tasks.empty()) {
+                    return; // stopping and nothing left to do
+                }
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task(); // exceptions are stored in the associated future
+        }
+    }
+
+  public:
+    explicit ThreadPool(int number_of_threads) {
+        std::generate_n(std::back_inserter(threads), number_of_threads, [&] { return std::thread([&] { run(); }); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        task_available.notify_all();
+        std::for_each(threads.begin(), threads.end(), [](auto& thread) { thread.join(); });
+    }
+
+    std::future<void> submit(std::function<void()> function) {
+        std::packaged_task<void()> task(std::move(function));
+        auto result = task.get_future();
+        {
+            std::lock_guard lock(mutex);
+            tasks.push_back(std::move(task));
+        }
+        task_available.notify_one();
+        return result;
+    }
+};
+
+/**
+ * @brief Analysis operating on the shared snapshot of the system
+ *
+ * Step counting is deferred, so that the analysis is touched only by the thread pool while
+ * a sample is pending. All steps since the last submission, including non-sampling steps,
+ * are handed over in a single task.
+ */
+struct CombinedAnalysis::AsynchronousAnalysis {
+    std::shared_ptr<Analysisbase> analysis; //!< Analysis bound to the shared snapshot
+    std::future<void> pending_sample;       //!< Result of latest submitted task
+    int submitted_steps = 0;                //!< Steps handed over to the thread pool
+    int deferred_steps = 0;                 //!< Steps not yet handed over
+
+    void wait() {
+        if (pending_sample.valid()) {
+            pending_sample.get(); // rethrows exceptions from the worker
+        }
+    }
+
+    void sampleSteps(int number_of_steps) const {
+        for (int i = 0; i < number_of_steps; ++i) {
+            analysis->sample();
+        }
+    }
+
+    bool isDue() const { return analysis->isSampleStep(submitted_steps + deferred_steps); }
+
+    void submit(ThreadPool& thread_pool) {
+        pending_sample = thread_pool.submit([this, steps = deferred_steps] { sampleSteps(steps); });
+        submitted_steps += std::exchange(deferred_steps, 0);
+    }
+
+    /** Complete all steps; deferred steps are never sample steps */
+    void synchronize() {
+        wait();
+        sampleSteps(deferred_steps);
+        submitted_steps += std::exchange(deferred_steps, 0);
+    }
+};
+
+void CombinedAnalysis::waitForSnapshot() {
+    for (auto& analysis : asynchronous_analyses) {
+        analysis->wait();
+    }
+}
+
+/**
+ * The snapshot is updated at most once per step, and only if an asynchronous analysis
+ * samples. Both kinds of analyses are then sampled in input order.
+ */
 void CombinedAnalysis::sample() {
-    for (auto& analysis : this->vec) {
-        analysis->sample();
+    auto update_snapshot = false;
+    for (auto& analysis : asynchronous_analyses) {
+        analysis->deferred_steps++;
+        update_snapshot = update_snapshot || analysis->isDue();
+    }
+    if (update_snapshot) {
+        waitForSnapshot(); // back-pressure: the snapshot is in use until all previous samples are done
+        Change everything;
+        everything.everything = true;
+        snapshot->sync(spc, everything);
+    }
+    for (size_t i = 0; i < vec.size(); ++i) {
+        if (auto* asynchronous = asynchronous_in_input_order[i]) {
+            if (update_snapshot && asynchronous->isDue()) {
+                asynchronous->submit(*thread_pool);
+            }
+        } else {
+            vec[i]->sample();
+        }
+    }
+}
+
+/** Complete all steps and leave the snapshot identical to the simulation */
+void CombinedAnalysis::synchronize() {
+    for (auto& analysis : asynchronous_analyses) {
+        analysis->synchronize();
     }
+    if (snapshot) {
+        Change everything;
+        everything.everything = true;
+        snapshot->sync(spc, everything);
+    }
+}
+
+/**
+ * Pending samples are completed as the output must include all steps. As this does not change
+ * the (logical) state of the analyses, it is allowed on a const instance.
+ */
+void to_json(json& j, const CombinedAnalysis& analysis) {
+    const_cast<CombinedAnalysis&>(analysis).synchronize();
+    Faunus::to_json(j, static_cast<const BasePointerVector<Analysisbase>&>(analysis));
 }
 
 void CombinedAnalysis::to_disk() {
+    synchronize();
     for (auto& analysis : this->vec) {
         analysis->to_disk();
     }
 }
 
-CombinedAnalysis::CombinedAnalysis(const json& json_array, Space& spc, Energy::Hamiltonian& pot) {
+void CombinedAnalysis::advanceSteps(int steps) {
+    synchronize();
+    for (auto& analysis : asynchronous_analyses) {
+        analysis->submitted_steps += steps;
+    }
+    for (auto& analysis : this->vec) {
+        analysis->advanceSteps(steps);
+    }
+}
+
+/**
+ * Both instances must be created from the same input; all pending samples are completed first.
+ */
+void CombinedAnalysis::merge(CombinedAnalysis& other) {
+    if (other.size() != size()) {
+        throw std::runtime_error("cannot merge different analyses");
+    }
+    synchronize();
+    other.synchronize();
+    for (size_t i = 0; i < size(); ++i) {
+        vec[i]->merge(*other.vec[i]);
+    }
+}
+
+/**
+ * Analyses whose samples from several instances, each visiting different steps, can be
+ * combined with `merge()`.
+ */
+bool CombinedAnalysis::isMergeable(const std::string& name) {
+    static const std::set<std::string> names = {"atomrdf", "molrdf", "atom_density", "molecule_density"};
+    return names.contains(name);
+}
+
+/**
+ * Analyses that only read the Space they are constructed with, and touch no other
+ * mutable state such as the Hamiltonian or the global random number generator.
+ */
+bool CombinedAnalysis::isSnapshotSafe(const std::string& name, const json& parameters) {
+    if (name == "electricpotential") { // random target policies draw from the global random number generator
+        return parameters.value("policy", ElectricPotential::Policies::FIXED) == ElectricPotential::Policies::FIXED;
+    }
+    static const std::set<std::string> names = {
+        "atomprofile",      "displacement", "displacement_com", "atomrdf",          "atomdipdipcorr",
+        "molecule_density", "atom_density", "chargefluctuations", "molrdf",         "multipole",
+        "atominertia",      "inertia",      "moleculeconformation", "multipolemoments", "multipoledist",
+        "polymershape",     "qrfile",       "psctraj",          "reactioncoordinate", "scatter",
+        "sliceddensity",    "xtcfile",      "spacetraj"};
+    return names.contains(name);
+}
+
+CombinedAnalysis::CombinedAnalysis(const json& json_array, Space& spc, Energy::Hamiltonian& pot,
+                                   const json& input)
+    : spc(spc) {
     if (!json_array.is_array()) {
         throw ConfigurationError("json array expected");
     }
+    const auto number_of_threads = input.is_object() ? input.value("analysis_threads", 0) : 0;
+    if (number_of_threads < 0) {
+        throw ConfigurationError("analysis_threads must be non-negative");
+    }
+    if (number_of_threads > 0) {
+        thread_pool = std::make_unique<ThreadPool>(number_of_threads);
+    }
     for (const auto& j : json_array) {
         try {
             const auto& [key, json_parameters] = jsonSingleItem(j);
-            vec.emplace_back(createAnalysis(key, json_parameters, spc, pot));
+            if (thread_pool && isSnapshotSafe(key, json_parameters)) {
+                if (!snapshot) {
+                    createSnapshot(input);
+                }
+                auto& asynchronous = asynchronous_analyses.emplace_back(std::make_unique<AsynchronousAnalysis>());
+                asynchronous->analysis = createAnalysis(key, json_parameters, *snapshot, pot, input);
+                vec.push_back(asynchronous->analysis);
+                asynchronous_in_input_order.push_back(asynchronous.get());
+            } else {
+                vec.emplace_back(createAnalysis(key, json_parameters, spc, pot, input));
+                asynchronous_in_input_order.push_back(nullptr);
+            }
         } catch (std::exception& e) {
             throw ConfigurationError("analysis: {}", e.what()).attachJson(j);
         }
     }
 }
 
+void CombinedAnalysis::createSnapshot(const json& input) {
+    const auto original_log_level = faunus_logger->level();
+    const auto original_random = Faunus::random; // space construction must not affect the chain
+    faunus_logger->set_level(spdlog::level::off);
+    snapshot = std::make_unique<Space>(input);
+    faunus_logger->set_level(original_log_level);
+    Faunus::random = original_random;
+    Change everything;
+    everything.everything = true;
+    snapshot->sync(spc, everything);
+}
+
+/**
+ * Pending samples are completed before the thread pool is joined
+ */
+CombinedAnalysis::~CombinedAnalysis() {
+    for (auto& analysis : asynchronous_analyses) {
+        if (analysis->pending_sample.valid()) {
+            analysis->pending_sample.wait(); // exceptions cannot be propagated from a destructor
+        }
+    }
+}
+
 void SystemEnergy::normalize() {
     const auto sum = energy_histogram.sumy();
     for (auto& i : energy_histogram.getMap()) {
@@ -228,13 +503,39 @@ void SystemEnergy::normalize() {
     }
 }
 
+/**
+ * Tracked energies are O(1) to obtain while the full recalculation is typically O(N^2).
+ * The difference between the two is recorded to monitor the drift of the tracked energies.
+ */
+std::vector<double> SystemEnergy::currentEnergies() {
+    const auto& tracked_energies = hamiltonian.trackedEnergies();
+    const auto check_drift = drift_check_interval <= 1 || number_of_samples % drift_check_interval == 0;
+    if (!tracked_energies.empty() && !check_drift) {
+        return tracked_energies;
+    }
+    auto energies = calculateEnergies();
+    if (!tracked_energies.empty()) {
+        const auto drift = std::fabs(ranges::accumulate(energies, 0.0) - ranges::accumulate(tracked_energies, 0.0));
+        max_energy_drift = std::max(max_energy_drift, drift);
+        number_of_drift_checks++;
+    }
+    hamiltonian.resetTrackedEnergies(energies);
+    return energies;
+}
+
 void SystemEnergy::_sample() {
-    const auto energies = calculateEnergies(); // current energy from all terms in Hamiltonian
+    const auto energies = currentEnergies(); // current energy from all terms in Hamiltonian
     const auto total_energy = ranges::accumulate(energies, 0.0);
     if (std::isfinite(total_energy)) {
         mean_energy += total_energy;
         mean_squared_energy += total_energy * total_energy;
     }
+    if (column_writer) {
+        row.assign({static_cast<double>(getNumberOfSteps()), total_energy});
+        row.insert(row.end(), energies.begin(), energies.end());
+        column_writer->addRow(row);
+        return;
+    }
     *output_stream << fmt::format("{:10d}{}{:.6E}", getNumberOfSteps(), separator, total_energy);
     for (auto energy : energies) {
         *output_stream << fmt::format("{}{:.6E}", separator, energy);
@@ -244,7 +545,11 @@ void SystemEnergy::_sample() {
 }
 
 void SystemEnergy::_to_json(json& j) const {
-    j = {{"file", file_name}, {"init", initial_energy}, {"final", calculateEnergies()}};
+    j = {{"file", file_name}, {"init", initial_energy}, {"final", calculateEnergies()},
+         {"drift_check", drift_check_interval}};
+    if (number_of_drift_checks > 0) {
+        j["max drift"] = max_energy_drift;
+    }
     if (!mean_energy.empty()) {
         j["mean"] = mean_energy.avg();
         j["Cv/kB"] = mean_squared_energy.avg() - std::pow(mean_energy.avg(), 2);
@@ -254,8 +559,17 @@ void SystemEnergy::_to_json(json& j) const {
     // ehist.save( "distofstates.dat" );
 }
 
-void SystemEnergy::_from_json(const json& j) { file_name = MPI::prefix + j.at("file").get<std::string>(); }
+void SystemEnergy::_from_json(const json& j) {
+    file_name = MPI::prefix + j.at("file").get<std::string>();
+    drift_check_interval = j.value("drift_check", drift_check_interval);
+}
 void SystemEnergy::createOutputStream() {
+    if (ColumnWriter::isColumnFile(file_name)) {
+        std::vector<ColumnWriter::Column> columns = {{"step"}, {"total"}};
+        ranges::for_each(hamiltonian, [&](auto& energy) { columns.push_back({energy->name}); });
+        column_writer = std::make_unique<ColumnWriter>(file_name, columns);
+        return;
+    }
     output_stream = IO::openCompressedOutputStream(file_name, true);
     if (auto suffix = file_name.substr(file_name.find_last_of('.') + 1); suffix == "csv") {
         separator = ",";
@@ -283,7 +597,11 @@ std::vector<double> SystemEnergy::calculateEnergies() const {
 }
 
 void SystemEnergy::_to_disk() {
-    output_stream->flush(); // empty buffer
+    if (column_writer) {
+        column_writer->flush();
+    } else {
+        output_stream->flush(); // empty buffer
+    }
 }
 
 // --------------------------------
@@ -372,7 +690,15 @@ PairMatrixAnalysis::PairMatrixAnalysis(const json& j, const Space& spc)
     , spc(spc) {
     from_json(j);
     filename = j.at("file").get<std::string>();
-    matrix_stream = IO::openCompressedOutputStream(filename, true);
+    if (ColumnWriter::isColumnFile(filename)) {
+        column_writer = std::make_unique<ColumnWriter>(
+            filename, std::vector<ColumnWriter::Column>{{"step"},
+                                                        {"row", ColumnWriter::Type::FLOAT32},
+                                                        {"column", ColumnWriter::Type::FLOAT32},
+                                                        {"value"}});
+    } else {
+        matrix_stream = IO::openCompressedOutputStream(filename, true);
+    }
 
     if (auto it = j.find("filter"); it != j.end()) {
         value_filter = createValueFilter("function", *it, true);
@@ -385,14 +711,35 @@ void PairMatrixAnalysis::_to_json([[maybe_unused]] json& j) const {}
 
 void PairMatrixAnalysis::_from_json([[maybe_unused]] const json& j) {}
 
+/**
+ * For column files, each non-zero element in the lower triangle is a row with the step
+ * and the zero-based matrix indices.
+ */
 void PairMatrixAnalysis::_sample() {
-    assert(matrix_stream);
     setPairMatrix();
+    if (column_writer) {
+        const auto step = static_cast<double>(getNumberOfSteps());
+        for (int col = 0; col < pair_matrix.outerSize(); ++col) {
+            for (Eigen::SparseMatrix<double>::InnerIterator it(pair_matrix, col); it; ++it) {
+                if (col <= it.row()) {
+                    column_writer->addRow({step, static_cast<double>(it.row()), static_cast<double>(col), it.value()});
+                }
+            }
+        }
+        return;
+    }
+    assert(matrix_stream);
     Faunus::streamMarket(pair_matrix, *matrix_stream, true);
     *matrix_stream << "\n"; // separare frames w. blank line
 }
 
-void PairMatrixAnalysis::_to_disk() { matrix_stream->flush(); }
+void PairMatrixAnalysis::_to_disk() {
+    if (column_writer) {
+        column_writer->flush();
+    } else {
+        matrix_stream->flush();
+    }
+}
 
 // --------------------------------
 
@@ -449,9 +796,22 @@ void SaveState::_sample() {
     }
 }
 
+void SaveState::_to_disk() {
+    if (checkpoint_writer) {
+        checkpoint_writer->flush();
+    }
+}
+
 SaveState::~SaveState() {
-    if (sample_interval == -1) { // writes data just before destruction
-        writeFunc(filename);
+    try {
+        if (sample_interval == -1) { // writes data just before destruction
+            writeFunc(filename);
+        }
+        if (checkpoint_writer) {
+            checkpoint_writer->flush();
+        }
+    } catch (std::exception& e) {
+        faunus_logger->error("error saving state to {}: {}", filename, e.what());
     }
 }
 
@@ -481,6 +841,19 @@ void SaveState::setWriteFunction(const Space& spc) {
         writeFunc = [&](auto& file) { saveJsonStateFile(file, spc); };
     } else if (suffix == "ubj") { // Universal Binary JSON state file
         writeFunc = [&](auto& file) { saveBinaryJsonStateFile(file, spc); };
+    } else if (SpaceCheckpoint::isCheckpointFile(filename)) { // binary checkpoint; written in the background
+        checkpoint_writer = std::make_unique<BackgroundWriter<PendingCheckpoint>>(
+            [](const PendingCheckpoint& pending) { pending.checkpoint.save(pending.filename); }, 1);
+        writeFunc = [&](auto& file) {
+            checkpoint_writer->push([&](PendingCheckpoint& pending) {
+                pending.filename = file;
+                if (save_random_number_generator_state) {
+                    pending.checkpoint.copy(spc, &Move::MoveBase::slump, &random);
+                } else {
+                    pending.checkpoint.copy(spc);
+                }
+            });
+        };
     } else {
         throw ConfigurationError("unknown file extension for '{}'", filename);
     }
@@ -529,6 +902,10 @@ PairFunctionBase::PairFunctionBase(const Space& spc, const json& j, const std::s
 void PairFunctionBase::_to_json(json& j) const {
     j = {{"dr", dr / 1.0_angstrom}, {"name1", name1},       {"name2", name2},        {"file", file},
          {"dim", dimensions},       {"slicedir", slicedir}, {"thickness", thickness}};
+    if (std::isfinite(max_distance)) {
+        j["rmax"] = max_distance / 1.0_angstrom;
+        j["cell_list"] = useCellList();
+    }
 }
 
 void PairFunctionBase::_from_json(const json& j) {
@@ -539,20 +916,127 @@ void PairFunctionBase::_from_json(const json& j) {
     dr = j.value("dr", 0.1) * 1.0_angstrom;
     slicedir = j.value("slicedir", slicedir);
     thickness = j.value("thickness", 0);
+    max_distance = j.value("rmax", pc::infty) * 1.0_angstrom;
+    if (max_distance <= 0.0) {
+        throw ConfigurationError("{}: rmax must be positive", name);
+    }
+    if (std::isfinite(max_distance) && slicedir.sum() > 0) {
+        throw ConfigurationError("{}: rmax cannot be combined with slicedir", name);
+    }
     histogram.setResolution(dr, 0);
 }
+
+/**
+ * The cell list spans the bounding box, which equals the periodic cell only for orthogonal coordinates
+ */
+bool PairFunctionBase::useCellList() const {
+    const auto& boundary_conditions = spc.geometry.boundaryConditions();
+    return std::isfinite(max_distance) && boundary_conditions.isPeriodic().count() == 3 &&
+           boundary_conditions.coordinates == Geometry::Coordinates::ORTHOGONAL;
+}
+
+/**
+ * The cell length is at least `max_distance` whereby all pairs within range of a given
+ * position are found in the surrounding cells. For small `max_distance`, the cell length
+ * is increased to roughly one position per cell to limit the memory of the dense cell list.
+ * The periodic grid removes duplicate neighbour cells when there are less than three cells
+ * in a direction.
+ */
+void PairFunctionBase::samplePairs(const std::vector<Point>& positions1, const std::vector<Point>& positions2) {
+    using CellListType =
+        CellList::CellListSpatial<CellList::CellListType<size_t, CellList::Grid::Grid3DPeriodic, CellList::CellListBase,
+                                                         CellList::Container::DenseContainer>>;
+    using CellCoord = typename CellListType::Grid::CellCoord;
+
+    const auto identical = &positions1 == &positions2;
+    const auto size1 = static_cast<double>(positions1.size());
+    const auto size2 = static_cast<double>(positions2.size());
+    const auto number_of_pairs = identical ? 0.5 * size1 * (size1 - 1.0) : size1 * size2;
+    const auto max_distance_squared = max_distance * max_distance;
+
+    std::unique_ptr<CellListType> cell_list;
+    std::vector<CellCoord> cell_offsets;
+    const Point half_box = 0.5 * spc.geometry.getLength();
+    if (useCellList() && !positions2.empty()) {
+        const auto volume_per_position = spc.geometry.getVolume() / size2;
+        const auto cell_length = std::max(max_distance, std::cbrt(volume_per_position));
+        cell_list = std::make_unique<CellListType>(spc.geometry.getLength(), cell_length);
+        for (size_t j = 0; j < positions2.size(); ++j) {
+            cell_list->insertMember(j, positions2[j] + half_box);
+        }
+        for (auto i = -1; i <= 1; ++i) {
+            for (auto j = -1; j <= 1; ++j) {
+                for (auto k = -1; k <= 1; ++k) {
+                    cell_offsets.emplace_back(i, j, k);
+                }
+            }
+        }
+    }
+
+    double number_of_sampled_pairs = 0.0;
+#pragma omp parallel
+    {
+        auto private_histogram = Equidistant2DTable<double, double>(dr, 0.0);
+        double private_number_of_sampled_pairs = 0.0;
+
+        auto sample = [&](const Point& position1, const Point& position2) {
+            const auto distance_squared = spc.geometry.sqdist(position1, position2);
+            if (distance_squared < max_distance_squared) {
+                private_histogram(std::sqrt(distance_squared))++;
+                private_number_of_sampled_pairs++;
+            }
+        };
+
+#pragma omp for schedule(dynamic, 64)
+        for (size_t i = 0; i < positions1.size(); ++i) {
+            const auto& position1 = positions1[i];
+            if (cell_list) {
+                const auto center_cell = cell_list->getGrid().coordinatesAt(position1 + half_box);
+                for (const auto& offset : cell_offsets) {
+                    for (const auto j : cell_list->getNeighborMembers(center_cell, offset)) {
+                        if (!identical || j > i) {
+                            sample(position1, positions2[j]);
+                        }
+                    }
+                }
+            } else {
+                for (size_t j = identical ? i + 1 : 0; j < positions2.size(); ++j) {
+                    sample(position1, positions2[j]);
+                }
+            }
+        }
+#pragma omp critical
+        {
+            for (size_t bin = 0; bin < private_histogram.size(); ++bin) {
+                const auto [distance, counts] = private_histogram[bin];
+                if (counts > 0.0) {
+                    histogram(distance + 0.5 * dr) += counts; // bin center avoids round-off at the lower edge
+                }
+            }
+            number_of_sampled_pairs += private_number_of_sampled_pairs;
+        }
+    }
+    skipped_pairs += number_of_pairs - number_of_sampled_pairs;
+}
 void PairFunctionBase::_to_disk() {
     if (std::ofstream f(MPI::prefix + file); f) {
         histogram.stream_decorator = [&](std::ostream& o, double r, double N) {
             const auto volume_at_r = volumeElement(r);
             if (volume_at_r > 0.0) {
-                const auto total_number_of_samples = histogram.sumy();
+                const auto total_number_of_samples = histogram.sumy() + skipped_pairs;
                 o << fmt::format("{:.6E} {:.6E}\n", r, N * mean_volume.avg() / (volume_at_r * total_number_of_samples));
             }
         };
         f << histogram;
     }
 }
+void PairFunctionBase::_merge(const Analysisbase& other_analysis) {
+    const auto& other = dynamic_cast<const PairFunctionBase&>(other_analysis);
+    histogram += other.histogram;
+    mean_volume = mean_volume + other.mean_volume;
+    skipped_pairs += other.skipped_pairs;
+}
+
 double PairFunctionBase::volumeElement(double r) const {
     switch (dimensions) {
     case 3:
@@ -597,13 +1081,18 @@ void PerturbationAnalysisBase::_to_disk() {
     if (stream) {
         stream->flush(); // empty buffer
     }
+    if (column_writer) {
+        column_writer->flush();
+    }
 }
 PerturbationAnalysisBase::PerturbationAnalysisBase(const std::string& name, Energy::Energybase& pot, Space& spc,
                                                    const std::string& filename)
     : Analysisbase(spc, name), mutable_space(spc), pot(pot), filename(filename) {
     if (!filename.empty()) {
         this->filename = MPI::prefix + filename;
-        stream = IO::openCompressedOutputStream(this->filename, true); // throws if error
+        if (!ColumnWriter::isColumnFile(filename)) {
+            stream = IO::openCompressedOutputStream(this->filename, true); // throws if error
+        }
     }
 }
 
@@ -651,22 +1140,37 @@ void VirtualVolumeMove::sanityCheck(const double old_energy) {
     }
 }
 void VirtualVolumeMove::writeToFileStream(const Point& scale, const double energy_change) const {
-    if (stream) {
-        const auto mean_excess_pressure = -meanFreeEnergy() / volume_displacement; // units of kT/Å³
-        *stream << fmt::format("{:d} {:.3E} {:.6E} {:.6E} {:.6E}", getNumberOfSteps(), volume_displacement,
-                               energy_change, std::exp(-energy_change), mean_excess_pressure);
+    if (!stream && !column_writer) {
+        return;
+    }
+    const auto mean_excess_pressure = -meanFreeEnergy() / volume_displacement; // units of kT/Å³
 
-        // if anisotropic scaling, add an extra column with area or length perturbation
-        const auto box_length = spc.geometry.getLength();
-        if (volume_scaling_method == Geometry::VolumeMethod::XY) {
-            const auto area_change = box_length.x() * box_length.y() * (scale.x() * scale.y() - 1.0);
-            *stream << fmt::format(" {:.6E}", area_change);
-        } else if (volume_scaling_method == Geometry::VolumeMethod::Z) {
-            const auto length_change = box_length.z() * (scale.z() - 1.0);
-            *stream << fmt::format(" {:.6E}", length_change);
+    // if anisotropic scaling, add an extra column with area or length perturbation
+    const auto box_length = spc.geometry.getLength();
+    std::optional<double> area_or_length_change;
+    if (volume_scaling_method == Geometry::VolumeMethod::XY) {
+        area_or_length_change = box_length.x() * box_length.y() * (scale.x() * scale.y() - 1.0);
+    } else if (volume_scaling_method == Geometry::VolumeMethod::Z) {
+        area_or_length_change = box_length.z() * (scale.z() - 1.0);
+    }
+
+    if (column_writer) {
+        const auto step = static_cast<double>(getNumberOfSteps());
+        if (area_or_length_change) {
+            column_writer->addRow({step, volume_displacement, energy_change, std::exp(-energy_change),
+                                   mean_excess_pressure, area_or_length_change.value()});
+        } else {
+            column_writer->addRow(
+                {step, volume_displacement, energy_change, std::exp(-energy_change), mean_excess_pressure});
         }
-        *stream << "\n"; // trailing newline
+        return;
     }
+    *stream << fmt::format("{:d} {:.3E} {:.6E} {:.6E} {:.6E}", getNumberOfSteps(), volume_displacement, energy_change,
+                           std::exp(-energy_change), mean_excess_pressure);
+    if (area_or_length_change) {
+        *stream << fmt::format(" {:.6E}", area_or_length_change.value());
+    }
+    *stream << "\n"; // trailing newline
 }
 
 void VirtualVolumeMove::_from_json(const json& j) {
@@ -696,6 +1200,19 @@ VirtualVolumeMove::VirtualVolumeMove(const json& j, Space& spc, Energy::Energyba
     from_json(j);
     change.volume_change = true;
     change.everything = true;
+    if (ColumnWriter::isColumnFile(filename)) {
+        std::vector<ColumnWriter::Column> columns = {{"step"},
+                                                     {"dV/" + unicode::angstrom + unicode::cubed},
+                                                     {"du/kT"},
+                                                     {"exp(-du/kT)"},
+                                                     {"<Pex>/kT/" + unicode::angstrom + unicode::cubed}};
+        if (volume_scaling_method == Geometry::VolumeMethod::XY) {
+            columns.push_back({"dA/" + unicode::angstrom + unicode::squared});
+        } else if (volume_scaling_method == Geometry::VolumeMethod::Z) {
+            columns.push_back({"dL/" + unicode::angstrom});
+        }
+        column_writer = std::make_unique<ColumnWriter>(filename, columns);
+    }
     if (stream) {
         *stream << "# steps dV/" + unicode::angstrom + unicode::cubed + " du/kT exp(-du/kT) <Pex>/kT/" +
                        unicode::angstrom + unicode::cubed;
@@ -724,29 +1241,55 @@ MolecularConformationID::MolecularConformationID(const json& j, const Space& spc
     molid = Faunus::findMoleculeByName(molname).id();
 }
 
-void QRtraj::_sample() { write_to_file(); }
+/**
+ * The frame is formatted into a recycled string which is then compressed and
+ * written by the background writer.
+ */
+void QRtraj::_sample() {
+    if (!background_writer) {
+        write_to_file(*stream);
+        return;
+    }
+    background_writer->push([&](std::string& frame) {
+        frame.clear();
+        frame_stream.str(std::move(frame)); // recycle capacity of a previously written frame
+        write_to_file(frame_stream);
+        frame = std::move(frame_stream).str();
+    });
+}
 
-void QRtraj::_to_json(json& j) const { j = {{"file", filename}}; }
+void QRtraj::_to_json(json& j) const { j = {{"file", filename}, {"buffer", buffer_size}}; }
 
 QRtraj::QRtraj(const json& j, const Space& spc, const std::string &name) : Analysisbase(spc, name) {
     from_json(j);
     filename = MPI::prefix + j.value("file", "qrtraj.dat"s);
+    buffer_size = j.value("buffer", 4);
+    if (buffer_size < 0) {
+        throw ConfigurationError("buffer must be non-negative");
+    }
     stream = IO::openCompressedOutputStream(filename, true);
-    write_to_file = [&groups = spc.groups, &stream = stream]() {
+    if (buffer_size > 0) {
+        background_writer = std::make_unique<BackgroundWriter<std::string>>(
+            [&stream = *stream](const std::string& frame) { stream << frame; }, buffer_size);
+    }
+    write_to_file = [&groups = spc.groups](std::ostream& stream) {
         for (const auto& group : groups) {
             for (auto it = group.begin(); it != group.trueend(); ++it) { // loop over *all* particles
                 if (it < group.end()) {                                  // active particles...
-                    *stream << fmt::format("{} {} ", it->charge, it->traits().sigma * 0.5);
-                } else {               // inactive particles...
-                    *stream << "0 0 "; // ... have zero charge and size
+                    stream << fmt::format("{} {} ", it->charge, it->traits().sigma * 0.5);
+                } else {              // inactive particles...
+                    stream << "0 0 "; // ... have zero charge and size
                 }
             }
         }
-        *stream << "\n"; // newline for every frame
+        stream << "\n"; // newline for every frame
     };
 }
 
 void QRtraj::_to_disk() {
+    if (background_writer) {
+        background_writer->flush(); // all sampled frames are handed to the stream
+    }
     if (*stream) {
         stream->flush(); // empty buffer
     }
@@ -757,17 +1300,16 @@ PatchySpheroCylinderTrajectory::PatchySpheroCylinderTrajectory(const json& j, co
     if (!j.contains("file")) {
         throw ConfigurationError("missing filename");
     }
-    write_to_file = [&]() {
-        assert(stream);
-        *stream << fmt::format("{}\nsweep {}; box ", spc.particles.size(), getNumberOfSteps())
-                << spc.geometry.getLength().transpose() << "\n";
+    write_to_file = [&](std::ostream& stream) {
+        stream << fmt::format("{}\nsweep {}; box ", spc.particles.size(), getNumberOfSteps())
+               << spc.geometry.getLength().transpose() << "\n";
 
         for (const auto& group : spc.groups) {
             for (auto it = group.begin(); it != group.trueend(); ++it) {
                 const auto particle_is_active = it < group.end();
                 const auto scale = static_cast<double>(particle_is_active);
-                *stream << scale * it->pos.transpose() << " " << scale * it->getExt().scdir.transpose() << " "
-                        << scale * it->getExt().patchdir.transpose() << "\n";
+                stream << scale * it->pos.transpose() << " " << scale * it->getExt().scdir.transpose() << " "
+                       << scale * it->getExt().patchdir.transpose() << "\n";
             }
         }
     };
@@ -782,7 +1324,7 @@ void FileReactionCoordinate::_to_json(json& j) const {
     j["type"] = rcjson.begin().key();
     j.erase("range");      // these are for penalty function
     j.erase("resolution"); // use only, so no need to show
-    if (stream) {
+    if (stream || column_writer) {
         j["file"] = MPI::prefix + filename;
     }
     if (mean_reaction_coordinate) {
@@ -793,7 +1335,9 @@ void FileReactionCoordinate::_to_json(json& j) const {
 void FileReactionCoordinate::_sample() {
     const auto value = reaction_coordinate->operator()();
     mean_reaction_coordinate += value;
-    if (stream) {
+    if (column_writer) {
+        column_writer->addRow({static_cast<double>(getNumberOfSteps()), value, mean_reaction_coordinate.avg()});
+    } else if (stream) {
         (*stream) << fmt::format("{} {:.6f} {:.6f}\n", getNumberOfSteps(), value, mean_reaction_coordinate.avg());
     }
 }
@@ -806,6 +1350,9 @@ FileReactionCoordinate::FileReactionCoordinate(
     , reaction_coordinate(std::move(reaction_coordinate)) {
     if (filename.empty()) {
         faunus_logger->warn("{}: no filename given - only the mean coordinate will be saved", name);
+    } else if (ColumnWriter::isColumnFile(filename)) {
+        column_writer = std::make_unique<ColumnWriter>(
+            MPI::prefix + filename, std::vector<ColumnWriter::Column>{{"step"}, {"value"}, {"average"}});
     } else {
         stream = IO::openCompressedOutputStream(MPI::prefix + filename, true);
     }
@@ -822,6 +1369,9 @@ void FileReactionCoordinate::_to_disk() {
     if (stream) {
         stream->flush(); // empty buffer
     }
+    if (column_writer) {
+        column_writer->flush();
+    }
 }
 
 AtomicDisplacement::AtomicDisplacement(const json& j, const Space& spc, std::string_view name)
@@ -982,6 +1532,15 @@ void WidomInsertion::_sample() {
     selectGhostGroup(); // will prepare `change`
     if (change.empty()) {
         faunus_logger->warn("{}: no inactive {} groups available", name, Faunus::molecules[molid].name);
+        return;
+    }
+    const auto bias = updateCavityBias();
+    if (std::isinf(bias)) { // no cavities: all insertions overlap
+        for (int cnt = 0; cnt < number_of_insertions; ++cnt) {
+            collectWidomAverage(bias);
+        }
+    } else if (!workers.empty()) {
+        sampleParallel(bias);
     } else {
         auto& group = mutable_space.groups.at(change.groups.at(0).group_index); // inactive "ghost" group
         group.resize(group.capacity());                                         // activate ghost
@@ -991,13 +1550,121 @@ void WidomInsertion::_sample() {
                 inserter->operator()(mutable_space.geometry, Faunus::molecules[molid], spc.particles); // random pos&orientation
             updateGroup(group, particles);
             const auto energy_change = pot.energy(change); // in kT
-            collectWidomAverage(energy_change);
+            collectWidomAverage(energy_change + bias);
         }
         group.resize(0); // de-activate ghost
     }
 }
 
-void WidomInsertion::updateGroup(Space::GroupType& group, const ParticleVector& particles) {
+/**
+ * Insertions into the empty cells of the cavity grid are biased by the inverse
+ * empty volume fraction, f, for each inserted point. Molecular groups are placed by
+ * their mass center, whereas each of the k atoms of an atomic molecule is placed
+ * independently, whereby insertion energies are shifted by -k ln(f).
+ *
+ * @returns Bias energy (kT); zero if cavity bias is disabled, infinite if no cells are empty
+ */
+double WidomInsertion::updateCavityBias() {
+    if (!cavity_inserter) {
+        return 0.0;
+    }
+    cavity_inserter->update(spc.geometry.getLength(), spc.activeParticles());
+    const auto empty_fraction = cavity_inserter->emptyVolumeFraction();
+    if (empty_fraction > 0.0) {
+        const auto& molecule = Faunus::molecules.at(molid);
+        const auto number_of_inserted_points = molecule.atomic ? molecule.atoms.size() : 1;
+        return -static_cast<double>(number_of_inserted_points) * std::log(empty_fraction);
+    }
+    return pc::infty;
+}
+
+/**
+ * Insertions are generated serially, using the same random number sequence as
+ * the serial algorithm, whereafter energies are evaluated in parallel.
+ */
+void WidomInsertion::sampleParallel(const double bias) {
+    const auto group_index = change.groups.at(0).group_index;
+    const auto& ghost = spc.groups.at(group_index);
+    insertions.resize(number_of_insertions);
+    for (auto& particles : insertions) {
+        particles = inserter->operator()(mutable_space.geometry, Faunus::molecules[molid], spc.particles);
+    }
+
+    synchronizeWorkers();
+    for (auto& worker : workers) {
+        worker->spc->groups.at(group_index).resize(ghost.capacity()); // activate ghost
+    }
+
+    energy_changes.resize(insertions.size());
+    std::exception_ptr exception = nullptr; // exceptions must not escape the parallel region
+#pragma omp parallel for schedule(static) num_threads(workers.size())
+    for (int i = 0; i < static_cast<int>(insertions.size()); ++i) {
+        try {
+#ifdef _OPENMP
+            auto& worker = *workers.at(omp_get_thread_num());
+#else
+            auto& worker = *workers.front();
+#endif
+            updateGroup(worker.spc->groups.at(group_index), insertions[i]);
+            energy_changes[i] = worker.pot->energy(change); // in kT
+        } catch (...) {
+#pragma omp critical
+            exception = std::current_exception();
+        }
+    }
+    for (auto& worker : workers) {
+        worker->spc->groups.at(group_index).resize(0); // de-activate ghost
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+    std::for_each(energy_changes.begin(), energy_changes.end(),
+                  [&](auto energy_change) { collectWidomAverage(energy_change + bias); });
+}
+
+/**
+ * Between sample events all workers are identical, so the system is compared with the first
+ * worker only. This read-only pass is much cheaper than copying the whole system and
+ * re-initializing all energy terms. Only groups with differing active particles are copied;
+ * geometry, implicit molecules, group sizes, and particle extensions trigger a full update.
+ */
+void WidomInsertion::synchronizeWorkers() {
+    const auto& worker_space = *workers.front()->spc;
+    worker_change.clear();
+    worker_change.everything = !workers_initialized ||
+                               spc.geometry.getLength() != worker_space.geometry.getLength() ||
+                               spc.getImplicitReservoir() != worker_space.getImplicitReservoir();
+    workers_initialized = true;
+    auto same_particle = [](const Particle& a, const Particle& b) {
+        return a.id == b.id && a.charge == b.charge && a.pos == b.pos && !a.hasExtension() && !b.hasExtension();
+    };
+    for (size_t group_index = 0; group_index < spc.groups.size() && !worker_change.everything; ++group_index) {
+        const auto& group = spc.groups[group_index];
+        const auto& other = worker_space.groups[group_index];
+        if (group.size() != other.size()) {
+            worker_change.everything = true; // matter change
+        } else if (group.mass_center != other.mass_center || group.conformation_id != other.conformation_id ||
+                   !std::equal(group.begin(), group.end(), other.begin(), same_particle)) {
+            auto& group_change = worker_change.groups.emplace_back();
+            group_change.group_index = group_index;
+            group_change.all = true;
+            group_change.internal = true;
+        }
+    }
+    if (worker_change.everything) {
+        worker_change.groups.clear();
+    }
+    for (auto& worker : workers) {
+        worker->spc->sync(spc, worker_change);
+        worker->pot->sync(&pot, worker_change);
+        worker->pot->state = pot.state;
+        if (worker_change.everything) {
+            worker->pot->init();
+        }
+    }
+}
+
+void WidomInsertion::updateGroup(Space::GroupType& group, const ParticleVector& particles) const {
     assert(particles.size() == group.size());
     std::copy(particles.begin(), particles.end(), group.begin()); // copy to ghost group
     if (absolute_z_coords) {
@@ -1017,25 +1684,73 @@ void WidomInsertion::_to_json(json& j) const {
              {"absz", absolute_z_coords},
              {"insertscheme", *inserter},
              {unicode::mu + "/kT", {{"excess", excess_chemical_potential}}}};
+        if (number_of_threads > 1) {
+            j["threads"] = number_of_threads;
+        }
     }
 }
 
 void WidomInsertion::_from_json(const json& j) {
     number_of_insertions = j.at("ninsert").get<int>();
     absolute_z_coords = j.value("absz", false);
+    const auto molecule_name = j.at("molecule").get<std::string>();
+    molid = findMoleculeByName(molecule_name).id();
+
+    if (const auto cell_length = j.value("cavity", 0.0); cell_length > 0.0) {
+        if (spc.geometry.type != Geometry::Variant::CUBOID) {
+            throw ConfigurationError("cavity bias requires a cuboidal geometry");
+        }
+        if (j.contains("dir") || absolute_z_coords) {
+            throw ConfigurationError("cavity bias cannot be combined with 'dir' or 'absz'");
+        }
+        cavity_inserter = std::make_shared<CavityInserter>(cell_length);
+        cavity_inserter->checkCellSize(Faunus::molecules.at(molid));
+        inserter = cavity_inserter;
+    }
     if (auto ptr = std::dynamic_pointer_cast<RandomInserter>(inserter); ptr) {
         ptr->dir = j.value("dir", Point({1, 1, 1}));
     } // set insert directions for RandomInserter
 
-    const auto molecule_name = j.at("molecule").get<std::string>();
-    molid = findMoleculeByName(molecule_name).id();
+    number_of_threads = j.value("threads", 1);
+    if (number_of_threads < 1) {
+        throw ConfigurationError("at least one thread required");
+    }
+#ifndef _OPENMP
+    if (number_of_threads > 1) {
+        faunus_logger->warn("{}: openmp unavailable; falling back to a single thread", name);
+        number_of_threads = 1;
+    }
+#endif
+}
+
+void WidomInsertion::createWorkers(const json& input) {
+    if (input.is_null()) {
+        throw ConfigurationError("multiple threads unsupported in this context");
+    }
+    for (const auto& j_energy : input.at("energy")) {
+        if (j_energy.contains("penalty")) { // copies would save their own penalty function on destruction
+            throw ConfigurationError("penalty energies are unsupported with multiple threads");
+        }
+    }
+    const auto original_log_level = faunus_logger->level();
+    faunus_logger->set_level(spdlog::level::off); // do not duplicate log info
+    std::generate_n(std::back_inserter(workers), number_of_threads, [&] {
+        auto worker = std::make_unique<Worker>();
+        worker->spc = std::make_unique<Space>(input);
+        worker->pot = std::make_unique<Energy::Hamiltonian>(*worker->spc, input.at("energy"));
+        return worker;
+    });
+    faunus_logger->set_level(original_log_level);
 }
 
-WidomInsertion::WidomInsertion(const json& j, Space& spc, Energy::Hamiltonian& pot)
+WidomInsertion::WidomInsertion(const json& j, Space& spc, Energy::Hamiltonian& pot, const json& input)
     : PerturbationAnalysisBase("widom", pot, spc) {
     cite = "doi:10/dkv4s6";
     inserter = std::make_shared<RandomInserter>();
     from_json(j);
+    if (number_of_threads > 1) {
+        createWorkers(input);
+    }
 }
 
 double DensityBase::updateVolumeStatistics() {
@@ -1095,6 +1810,34 @@ void DensityBase::_to_disk() {
     }
 }
 
+/**
+ * Add table values for each id; tables are copied if missing
+ */
+template <typename Map> static void mergeTables(Map& tables, const Map& other_tables) {
+    for (const auto& [id, other_table] : other_tables) {
+        if (auto [it, inserted] = tables.try_emplace(id, other_table); !inserted) {
+            it->second += other_table;
+        }
+    }
+}
+
+void DensityBase::_merge(const Analysisbase& other_analysis) {
+    const auto& other = dynamic_cast<const DensityBase&>(other_analysis);
+    for (const auto& [id, density] : other.mean_density) {
+        mean_density[id] = mean_density[id] + density;
+    }
+    mergeTables(probability_density, other.probability_density);
+    mean_cubic_root_of_volume = mean_cubic_root_of_volume + other.mean_cubic_root_of_volume;
+    mean_volume = mean_volume + other.mean_volume;
+    mean_inverse_volume = mean_inverse_volume + other.mean_inverse_volume;
+}
+
+void AtomDensity::_merge(const Analysisbase& other_analysis) {
+    DensityBase::_merge(other_analysis);
+    mergeTables(atomswap_probability_density,
+                dynamic_cast<const AtomDensity&>(other_analysis).atomswap_probability_density);
+}
+
 void AtomDensity::_sample() {
     DensityBase::_sample();
     std::set<id_type> unique_reactive_atoms;
@@ -1267,22 +2010,38 @@ void AtomRDF::_sample() {
         sampleIdentical();
     }
 }
+
+/**
+ * Slices are sampled serially via `sampleDistance()`, while full distances are
+ * handed to the cell list and thread-parallel `samplePairs()`.
+ */
 void AtomRDF::sampleIdentical() {
     auto particles = spc.findAtoms(id1); // (id1 == id2)
-    for (auto i = particles.begin(); i != particles.end(); ++i) {
-        for (auto j = i; ++j != particles.end();) {
-            sampleDistance(*i, *j);
+    if (slicedir.sum() > 0) {
+        for (auto i = particles.begin(); i != particles.end(); ++i) {
+            for (auto j = i; ++j != particles.end();) {
+                sampleDistance(*i, *j);
+            }
         }
+        return;
     }
+    const auto positions = particles | ranges::cpp20::views::transform(&Particle::pos) | ranges::to_vector;
+    samplePairs(positions, positions);
 }
 void AtomRDF::sampleDifferent() {
     auto particles1 = spc.findAtoms(id1);
     auto particles2 = spc.findAtoms(id2);
-    for (const auto& i : particles1) {
-        for (const auto& j : particles2) {
-            sampleDistance(i, j);
+    if (slicedir.sum() > 0) {
+        for (const auto& i : particles1) {
+            for (const auto& j : particles2) {
+                sampleDistance(i, j);
+            }
         }
+        return;
     }
+    const auto positions1 = particles1 | ranges::cpp20::views::transform(&Particle::pos) | ranges::to_vector;
+    const auto positions2 = particles2 | ranges::cpp20::views::transform(&Particle::pos) | ranges::to_vector;
+    samplePairs(positions1, positions2);
 }
 AtomRDF::AtomRDF(const json& j, const Space& spc) : PairFunctionBase(spc, j, "atomrdf") {
     id1 = Faunus::findAtomByName(name1).id();
@@ -1298,28 +2057,19 @@ void MoleculeRDF::_sample() {
     }
 }
 void MoleculeRDF::sampleIdentical() {
-    auto groups = spc.findMolecules(id1);
-    for (auto i = groups.begin(); i != groups.end(); ++i) {
-        for (auto j = i; ++j != groups.end();) {
-            sampleDistance(*i, *j);
-        }
-    }
-}
-void MoleculeRDF::sampleDifferent() {
-    auto ids1 = spc.findMolecules(id1);
-    auto ids2 = spc.findMolecules(id2);
-    for (const auto& i : ids1) {
-        for (const auto& j : ids2) {
-            sampleDistance(i, j);
-        }
-    }
+    const auto mass_centers = massCenters(id1);
+    samplePairs(mass_centers, mass_centers);
 }
+void MoleculeRDF::sampleDifferent() { samplePairs(massCenters(id1), massCenters(id2)); }
 
-void MoleculeRDF::sampleDistance(const Group& group_i, const Group& group_j) {
-    assert(group_i.massCenter().has_value());
-    assert(group_j.massCenter().has_value());
-    const auto distance = sqrt(spc.geometry.sqdist(group_i.mass_center, group_j.mass_center));
-    histogram(distance)++;
+std::vector<Point> MoleculeRDF::massCenters(index_type molid) const {
+    auto groups = spc.findMolecules(molid);
+    std::vector<Point> mass_centers;
+    for (const auto& group : groups) {
+        assert(group.massCenter().has_value());
+        mass_centers.push_back(group.mass_center);
+    }
+    return mass_centers;
 }
 
 MoleculeRDF::MoleculeRDF(const json& j, const Space& spc) : PairFunctionBase(spc, j, "molrdf") {
@@ -1389,10 +2139,19 @@ XTCtraj::XTCtraj(const Space& spc, const std::string& filename, const std::vecto
 XTCtraj::XTCtraj(const json& j, const Space& spc)
     : XTCtraj(spc, MPI::prefix + j.at("file").get<std::string>(), j.value("molecules", std::vector<std::string>())) {
     Analysisbase::from_json(j);
+    buffer_size = j.value("buffer", 4);
+    if (buffer_size < 0) {
+        throw ConfigurationError("buffer must be non-negative");
+    }
+    if (buffer_size > 0) {
+        background_writer = std::make_unique<BackgroundWriter<TrajectoryFrame>>(
+            [&writer = *writer](const TrajectoryFrame& frame) { writer.writeNext(frame); }, buffer_size);
+    }
 }
 
 void XTCtraj::_to_json(json& j) const {
     j["file"] = writer->filename;
+    j["buffer"] = buffer_size;
     if (!group_ids.empty()) {
         j["molecules"] = group_ids |
                          ranges::cpp20::views::transform([](auto id) { return Faunus::molecules.at(id).name; }) |
@@ -1405,13 +2164,28 @@ void XTCtraj::_to_json(json& j) const {
  */
 void XTCtraj::_sample() {
     namespace rv = ranges::cpp20::views;
+    auto write = [&](auto positions) {
+        if (!background_writer) {
+            writer->writeNext(spc.geometry.getLength(), positions.begin(), positions.end());
+            return;
+        }
+        background_writer->push([&](TrajectoryFrame& frame) { // compression and I/O in background thread
+            frame.box = spc.geometry.getLength();
+            frame.coordinates.clear();
+            ranges::copy(positions, std::back_inserter(frame.coordinates));
+        });
+    };
     if (group_ids.empty()) {
-        auto positions = spc.particles | rv::transform(&Particle::pos);
-        writer->writeNext(spc.geometry.getLength(), positions.begin(), positions.end());
+        write(spc.particles | rv::transform(&Particle::pos));
     } else {
-        auto positions = group_indices | rv::transform([&](auto i) { return spc.groups.at(i).all(); }) |
-                         ranges::views::cache1 | rv::join | rv::transform(&Particle::pos);
-        writer->writeNext(spc.geometry.getLength(), positions.begin(), positions.end());
+        write(group_indices | rv::transform([&](auto i) { return spc.groups.at(i).all(); }) | ranges::views::cache1 |
+              rv::join | rv::transform(&Particle::pos));
+    }
+}
+
+void XTCtraj::_to_disk() {
+    if (background_writer) {
+        background_writer->flush();
     }
 }
 
@@ -1997,6 +2771,12 @@ void ScatteringFunction::_sample() {
             IO::writeKeyValuePairs(filename + "." + suffix, debye->getIntensity());
         }
         break;
+    case Schemes::DEBYE_HISTOGRAM:
+        debye_histogram->sample(scatter_positions, 1.0, spc.geometry.getVolume());
+        if (save_after_sample) {
+            IO::writeKeyValuePairs(filename + "." + suffix, debye_histogram->getIntensity());
+        }
+        break;
     case Schemes::EXPLICIT_PBC:
         explicit_average_pbc->sample(scatter_positions, spc.geometry.getLength());
         if (save_after_sample) {
@@ -2019,6 +2799,12 @@ void ScatteringFunction::_to_json(json& j) const {
         j["scheme"] = "debye";
         std::tie(j["qmin"], j["qmax"], std::ignore) = debye->getQMeshParameters();
         break;
+    case Schemes::DEBYE_HISTOGRAM:
+        j["scheme"] = "debye";
+        j["algorithm"] = "histogram";
+        j["dr"] = debye_histogram->getBinWidth();
+        std::tie(j["qmin"], j["qmax"], std::ignore) = debye_histogram->getQMeshParameters();
+        break;
     case Schemes::EXPLICIT_PBC:
         j["scheme"] = "explicit";
         j["pmax"] = explicit_average_pbc->getQMultiplier();
@@ -2044,8 +2830,15 @@ ScatteringFunction::ScatteringFunction(const json& j, const Space& spc) try : An
     const auto cuboid = std::dynamic_pointer_cast<Geometry::Cuboid>(spc.geometry.asSimpleGeometry());
 
     if (const auto scheme_str = j.value("scheme", "explicit"s); scheme_str == "debye") {
-        scheme = Schemes::DEBYE;
-        debye = std::make_unique<Scatter::DebyeFormula<Tformfactor>>(j);
+        if (const auto algorithm = j.value("algorithm", "pairwise"s); algorithm == "pairwise") {
+            scheme = Schemes::DEBYE;
+            debye = std::make_unique<Scatter::DebyeFormula<Tformfactor>>(j);
+        } else if (algorithm == "histogram") {
+            scheme = Schemes::DEBYE_HISTOGRAM;
+            debye_histogram = std::make_unique<Scatter::DebyeHistogramFormula<>>(j);
+        } else {
+            throw ConfigurationError("unknown algorithm");
+        }
         if (cuboid) {
             faunus_logger->warn("cuboidal cell detected: consider using the `explicit` scheme");
         }
@@ -2074,6 +2867,9 @@ void ScatteringFunction::_to_disk() {
     case Schemes::DEBYE:
         IO::writeKeyValuePairs(filename, debye->getIntensity());
         break;
+    case Schemes::DEBYE_HISTOGRAM:
+        IO::writeKeyValuePairs(filename, debye_histogram->getIntensity());
+        break;
     case Schemes::EXPLICIT_PBC:
         IO::writeKeyValuePairs(filename, explicit_average_pbc->getSampling());
         break;
@@ -2096,8 +2892,13 @@ void VirtualTranslate::_from_json(const json& j) {
 
     if (filename = j.value("file", ""s); !filename.empty()) {
         filename = MPI::prefix + filename;
-        stream = IO::openCompressedOutputStream(filename, true); // throws if error
-        *stream << "# steps dL/Å du/kT <force>/kT/Å\n"s;
+        if (ColumnWriter::isColumnFile(filename)) {
+            column_writer = std::make_unique<ColumnWriter>(
+                filename, std::vector<ColumnWriter::Column>{{"step"}, {"dL/Å"}, {"du/kT"}, {"<force>/kT/Å"}});
+        } else {
+            stream = IO::openCompressedOutputStream(filename, true); // throws if error
+            *stream << "# steps dL/Å du/kT <force>/kT/Å\n"s;
+        }
     }
 }
 void VirtualTranslate::_sample() {
@@ -2118,7 +2919,11 @@ void VirtualTranslate::_sample() {
 }
 
 void VirtualTranslate::writeToFileStream(const double energy_change) const {
-    if (stream) { // file to disk?
+    if (column_writer) {
+        const auto mean_force = -meanFreeEnergy() / perturbation_distance;
+        column_writer->addRow(
+            {static_cast<double>(getNumberOfSteps()), perturbation_distance, energy_change, mean_force});
+    } else if (stream) { // file to disk?
         const auto mean_force = -meanFreeEnergy() / perturbation_distance;
         *stream << fmt::format("{:d} {:.3E} {:.6E} {:.6E}\n", getNumberOfSteps(), perturbation_distance, energy_change,
                                mean_force);
@@ -2156,24 +2961,17 @@ VirtualTranslate::VirtualTranslate(const json& j, Space& spc, Energy::Energybase
     from_json(j);
 }
 
-SpaceTrajectory::SpaceTrajectory(const json& j, const Space& spc)
-    : Analysisbase(spc, "space trajectory"), groups(spc.groups) {
+SpaceTrajectory::SpaceTrajectory(const json& j, const Space& spc) : Analysisbase(spc, "space trajectory") {
     from_json(j);
     filename = j.at("file").get<std::string>();
-
-    if (useCompression()) {
-        stream = std::make_unique<zstr::ofstream>(MPI::prefix + filename, std::ios::binary);
-    } else {
-        stream = std::make_unique<std::ofstream>(MPI::prefix + filename, std::ios::binary);
-    }
-
-    if (stream != nullptr && *stream) {
-        archive = std::make_unique<cereal::BinaryOutputArchive>(*stream);
-    }
-
-    if (not archive) {
+    keyframe_interval = j.value("keyframe", keyframe_interval);
+    const auto compression =
+        useCompression() ? FormatSpaceTrajectory::Compression::ZLIB : FormatSpaceTrajectory::Compression::NONE;
+    stream = std::make_unique<std::ofstream>(MPI::prefix + filename, std::ios::binary);
+    if (!*stream) {
         throw std::runtime_error("error creating "s + filename);
     }
+    trajectory = std::make_unique<FormatSpaceTrajectory>(*stream, spc, compression, keyframe_interval);
 }
 
 bool SpaceTrajectory::useCompression() const {
@@ -2189,28 +2987,132 @@ bool SpaceTrajectory::useCompression() const {
 }
 
 void SpaceTrajectory::_sample() {
-    assert(archive);
-    for (auto& group : groups) {
-        (*archive)(group);
-    }
+    assert(trajectory);
+    trajectory->save(spc);
 }
 
-void SpaceTrajectory::_to_json(json& j) const { j = {{"file", filename}}; }
+void SpaceTrajectory::_to_json(json& j) const {
+    j = {{"file", filename}, {"keyframe", keyframe_interval}, {"frames", trajectory->numberOfFrames()}};
+}
 
 void SpaceTrajectory::_to_disk() { stream->flush(); }
 
 // -----------------------------
 
+/**
+ * Charged, active particles are stored as separate coordinate and charge arrays so that
+ * distances to a target can be computed in a single vectorizable loop. For fully periodic,
+ * orthogonal cells with a finite cutoff, the charges are sorted by cell whereby the
+ * charges of each cell form a contiguous range, and only the 27 cells surrounding a target
+ * are visited.
+ */
+struct ElectricPotential::ChargeArrays {
+    using Grid = CellList::Grid::Grid3DPeriodic;
+    std::vector<double> x, y, z, charge;
+    std::unique_ptr<Grid> grid;       //!< Cell grid; only if a cell list is used
+    std::vector<size_t> cell_begin;   //!< Charges in cell `i` are in the range [cell_begin[i], cell_begin[i + 1])
+    std::vector<size_t> cell_indices; //!< Cell index of each charge (temporary storage for sorting)
+    std::vector<double> buffer;       //!< Temporary storage for sorting
+    std::vector<Grid::CellCoord> cell_offsets;
+    Point half_box = {0.0, 0.0, 0.0};
+    Point len_or_zero = {0.0, 0.0, 0.0}; //!< Box length if periodic in a direction; zero otherwise
+    bool orthogonal = true;              //!< False if minimum image must be handled by the geometry
+
+    ChargeArrays() {
+        for (auto i = -1; i <= 1; ++i) {
+            for (auto j = -1; j <= 1; ++j) {
+                for (auto k = -1; k <= 1; ++k) {
+                    cell_offsets.emplace_back(i, j, k);
+                }
+            }
+        }
+    }
+
+    //! Reorder `values` so that `values[i]` ends up at `destination[i]`
+    static void permute(std::vector<double>& values, const std::vector<size_t>& destination,
+                        std::vector<double>& buffer) {
+        buffer.resize(values.size());
+        for (size_t i = 0; i < values.size(); ++i) {
+            buffer[destination[i]] = values[i];
+        }
+        std::swap(values, buffer);
+    }
+
+    void update(const Space& spc, double cutoff) {
+        const auto& boundary_conditions = spc.geometry.boundaryConditions();
+        const auto periodic = boundary_conditions.isPeriodic();
+        const Point box = spc.geometry.getLength();
+        orthogonal = boundary_conditions.coordinates == Geometry::Coordinates::ORTHOGONAL;
+        half_box = 0.5 * box;
+        len_or_zero = box.cwiseProduct(periodic.cast<double>());
+
+        x.clear();
+        y.clear();
+        z.clear();
+        charge.clear();
+        for (const auto& particle : spc.activeParticles()) {
+            if (particle.charge != 0.0) {
+                x.push_back(particle.pos.x());
+                y.push_back(particle.pos.y());
+                z.push_back(particle.pos.z());
+                charge.push_back(particle.charge);
+            }
+        }
+        if (!(std::isfinite(cutoff) && orthogonal && periodic.count() == 3)) {
+            grid.reset();
+            return;
+        }
+        grid = std::make_unique<Grid>(box, cutoff);
+        cell_indices.resize(x.size());
+        for (size_t i = 0; i < x.size(); ++i) {
+            cell_indices[i] = grid->indexAt(Point(x[i], y[i], z[i]) + half_box);
+        }
+        cell_begin.assign(grid->size() + 1, 0); // counting sort by cell index
+        for (const auto cell_index : cell_indices) {
+            cell_begin[cell_index + 1]++;
+        }
+        std::partial_sum(cell_begin.begin(), cell_begin.end(), cell_begin.begin());
+        auto next_free = cell_begin;
+        for (auto& cell_index : cell_indices) {
+            cell_index = next_free[cell_index]++; // cell index -> destination index
+        }
+        for (auto* values : {&x, &y, &z, &charge}) {
+            permute(*values, cell_indices, buffer);
+        }
+    }
+
+    //! Call `function(first, last)` for each range of charges that may be within the cutoff of `target`
+    template <typename Function> void forEachRange(const Space::GeometryType& geometry, Point target,
+                                                   Function function) const {
+        if (!grid) {
+            function(size_t(0), x.size());
+            return;
+        }
+        geometry.boundary(target);
+        const auto center_cell = grid->coordinatesAt(target + half_box);
+        for (const auto& offset : cell_offsets) {
+            if (grid->isNeighborCell(center_cell, offset)) {
+                const auto cell_index = grid->index(center_cell + offset);
+                function(cell_begin[cell_index], cell_begin[cell_index + 1]);
+            }
+        }
+    }
+};
+
 ElectricPotential::ElectricPotential(const json& j, const Space& spc)
     : Analysisbase(spc, "electricpotential"), potential_correlation_histogram(histogram_resolution) {
     from_json(j);
     coulomb = std::make_unique<Potential::NewCoulombGalore>();
     Potential::from_json(j, *coulomb);
+    cutoff = j.value("cutoff", pc::infty);
+    charges = std::make_unique<ChargeArrays>();
     getTargets(j);
     setPolicy(j);
     calculations_per_sample_event = j.value("ncalc", 1);
 }
 
+ElectricPotential::~ElectricPotential() = default;
+
 void ElectricPotential::setPolicy(const json& j) {
     output_information.clear();
     policy = j.value("policy", Policies::FIXED);
@@ -2276,11 +3178,14 @@ void ElectricPotential::getTargets(const json& j) {
 }
 
 void ElectricPotential::_sample() {
+    charges->update(spc, cutoff); // particles are unaffected by the policy
     for (unsigned int i = 0; i < calculations_per_sample_event; i++) {
         applyPolicy();
+        calcPotentialOnTargets();
         auto potential_correlation = 1.0; // phi1 * phi2 * ...
-        for (auto& target : targets) {    // loop over each target point
-            auto potential = calcPotentialOnTarget(target);
+        auto potential_it = target_potentials.cbegin();
+        for (auto& target : targets) { // loop over each target point
+            const auto potential = *potential_it++;
             target.potential_histogram->add(potential);
             target.mean_potential += potential;
             potential_correlation *= potential;
@@ -2290,13 +3195,55 @@ void ElectricPotential::_sample() {
     }
 }
 
-double ElectricPotential::calcPotentialOnTarget(const ElectricPotential::Target& target) {
-    auto potential_from_particle = [&](const Particle& particle) {
-        const auto distance_to_target = std::sqrt(spc.geometry.sqdist(particle.pos, target.position));
-        return coulomb->getCoulombGalore().ion_potential(particle.charge, distance_to_target);
-    };
-    auto potentials = spc.activeParticles() | ranges::cpp20::views::transform(potential_from_particle);
-    return std::accumulate(potentials.begin(), potentials.end(), 0.0);
+/**
+ * Targets are distributed over OpenMP threads. For each range of charges, squared distances are first
+ * computed in a SIMD loop using the same branchless minimum image convention as
+ * `Geometry::Chameleon::sqdist()`, followed by summation of the potentials within the cutoff.
+ */
+void ElectricPotential::calcPotentialOnTargets() {
+    target_potentials.resize(targets.size());
+    const auto& galore = coulomb->getCoulombGalore();
+    const auto squared_cutoff = cutoff * cutoff;
+    const auto& c = *charges;
+
+#pragma omp parallel
+    {
+        std::vector<double> squared_distances;
+#pragma omp for schedule(dynamic)
+        for (size_t t = 0; t < targets.size(); ++t) {
+            const Point& target = targets[t].position;
+            auto potential = 0.0;
+            c.forEachRange(spc.geometry, target, [&](const size_t first, const size_t last) {
+                squared_distances.resize(last - first);
+                if (c.orthogonal) {
+                    const auto* x = c.x.data() + first;
+                    const auto* y = c.y.data() + first;
+                    const auto* z = c.z.data() + first;
+                    auto* r2 = squared_distances.data();
+#pragma omp simd
+                    for (size_t k = 0; k < last - first; ++k) {
+                        auto dx = std::fabs(x[k] - target.x());
+                        auto dy = std::fabs(y[k] - target.y());
+                        auto dz = std::fabs(z[k] - target.z());
+                        dx -= c.len_or_zero.x() * static_cast<double>(dx > c.half_box.x());
+                        dy -= c.len_or_zero.y() * static_cast<double>(dy > c.half_box.y());
+                        dz -= c.len_or_zero.z() * static_cast<double>(dz > c.half_box.z());
+                        r2[k] = dx * dx + dy * dy + dz * dz;
+                    }
+                } else {
+                    for (size_t k = first; k < last; ++k) {
+                        squared_distances[k - first] = spc.geometry.sqdist(Point(c.x[k], c.y[k], c.z[k]), target);
+                    }
+                }
+                for (size_t k = first; k < last; ++k) {
+                    if (const auto r2 = squared_distances[k - first]; r2 < squared_cutoff) {
+                        potential += galore.ion_potential(c.charge[k], std::sqrt(r2));
+                    }
+                }
+            });
+            target_potentials[t] = potential;
+        }
+    }
 }
 
 void ElectricPotential::_to_json(json& j) const {
@@ -2362,4 +3309,368 @@ void SavePenaltyEnergy::_sample() {
     }
 }
 
+TEST_CASE("[Faunus] WidomInsertion") {
+    const auto original_atoms = Faunus::atoms;
+    const auto original_molecules = Faunus::molecules;
+    const auto original_random = Faunus::random;
+    auto input = R"({
+        "atomlist": [{"A": {"sigma": 2.0, "eps": 0.5}}],
+        "moleculelist": [{"salt": {"atoms": ["A"], "atomic": true}},
+                         {"dimer": {"structure": [{"A": [0.0, 0.0, 0.0]}, {"A": [2.0, 0.0, 0.0]}]}}],
+        "insertmolecules": [{"salt": {"N": 30}}, {"dimer": {"N": 2}}, {"dimer": {"N": 1, "inactive": true}}],
+        "geometry": {"type": "cuboid", "length": 20},
+        "energy": [{"nonbonded": {"default": [{"lennardjones": {"mixing": "LB"}}]}}]
+    })"_json;
+    Faunus::atoms = input["atomlist"].get<decltype(Faunus::atoms)>();
+    Faunus::molecules = input["moleculelist"].get<decltype(Faunus::molecules)>();
+
+    // fixed seed gives identical results regardless of the number of threads; the system is perturbed
+    // between sample events so that workers must be synchronized
+    auto excess_chemical_potential = [&](int number_of_threads) {
+        Faunus::random = original_random;
+        Space spc(input);
+        Energy::Hamiltonian pot(spc, input.at("energy"));
+        const json j = {{"molecule", "dimer"}, {"ninsert", 20}, {"nstep", 1}, {"threads", number_of_threads}};
+        WidomInsertion widom(j, spc, pot, input);
+        Random displacement_random;
+        for (int sample = 0; sample < 10; ++sample) {
+            widom.sample();
+            auto& group = spc.groups.at(sample % 3 == 0 ? 1 : 0); // a dimer or the salt
+            for (auto& particle : group) {
+                particle.pos += Point(displacement_random(), displacement_random(), displacement_random());
+                spc.geometry.boundary(particle.pos);
+            }
+            if (auto mass_center = group.massCenter()) {
+                (*mass_center).get() = Geometry::massCenter(group.begin(), group.end(),
+                                                            spc.geometry.getBoundaryFunc(), -group.begin()->pos);
+            }
+        }
+        return json(widom).at("widom").at(unicode::mu + "/kT").at("excess").get<double>();
+    };
+    const auto serial = excess_chemical_potential(1);
+    CHECK(std::isfinite(serial));
+#ifdef _OPENMP
+    CHECK(excess_chemical_potential(2) == doctest::Approx(serial));
+    CHECK(excess_chemical_potential(3) == doctest::Approx(serial));
+#endif
+    Faunus::atoms = original_atoms;
+    Faunus::molecules = original_molecules;
+    Faunus::random = original_random;
+}
+
+TEST_CASE("[Faunus] WidomInsertion - cavity bias") {
+    const auto original_atoms = Faunus::atoms;
+    const auto original_molecules = Faunus::molecules;
+    const auto original_random = Faunus::random;
+    auto input = R"({
+        "atomlist": [{"A": {"sigma": 4.0}}],
+        "moleculelist": [{"salt": {"atoms": ["A"], "atomic": true}},
+                         {"ghost": {"atoms": ["A"], "atomic": true}}],
+        "insertmolecules": [{"salt": {"N": 10}}, {"ghost": {"N": 1, "inactive": true}}],
+        "geometry": {"type": "cuboid", "length": 20},
+        "energy": [{"nonbonded": {"default": [{"hardsphere": {}}]}}]
+    })"_json;
+    Faunus::atoms = input["atomlist"].get<decltype(Faunus::atoms)>();
+    Faunus::molecules = input["moleculelist"].get<decltype(Faunus::molecules)>();
+    Space spc(input);
+    Energy::Hamiltonian pot(spc, input.at("energy"));
+
+    // cell diagonal (3.5 Å) is below the contact distance (4 Å); both estimates target the same configuration
+    auto excess_chemical_potential = [&](json j) {
+        j.update({{"molecule", "ghost"}, {"ninsert", 20000}, {"nstep", 1}});
+        WidomInsertion widom(j, spc, pot, input);
+        widom.sample();
+        return json(widom).at("widom").at(unicode::mu + "/kT").at("excess").get<double>();
+    };
+    const auto unbiased = excess_chemical_potential(json::object());
+    const auto biased = excess_chemical_potential({{"cavity", 2.0}});
+    CHECK(unbiased > 0.1);
+    CHECK(biased == doctest::Approx(unbiased).epsilon(0.05));
+    Faunus::atoms = original_atoms;
+    Faunus::molecules = original_molecules;
+    Faunus::random = original_random;
+}
+
+TEST_CASE("[Faunus] CombinedAnalysis - asynchronous sampling") {
+    const auto original_atoms = Faunus::atoms;
+    const auto original_molecules = Faunus::molecules;
+    auto input = R"({
+        "atomlist": [{"A": {"sigma": 2.0, "q": 1.0}}, {"B": {"sigma": 2.0, "q": -1.0}}],
+        "moleculelist": [{"salt": {"atoms": ["A", "B"], "atomic": true}},
+                         {"dimer": {"structure": [{"A": [0.0, 0.0, 0.0]}, {"B": [2.0, 0.0, 0.0]}]}}],
+        "insertmolecules": [{"salt": {"N": 10}}, {"dimer": {"N": 3}}],
+        "geometry": {"type": "cuboid", "length": 20},
+        "energy": []
+    })"_json;
+    Faunus::atoms = input["atomlist"].get<decltype(Faunus::atoms)>();
+    Faunus::molecules = input["moleculelist"].get<decltype(Faunus::molecules)>();
+    const auto analyses = R"([{"atom_density": {"nstep": 2}},
+                              {"sanity": {"nstep": 1}},
+                              {"multipole": {"nstep": 3}}])"_json;
+
+    SUBCASE("snapshot safety") {
+        CHECK(CombinedAnalysis::isSnapshotSafe("atomrdf", json::object()));
+        CHECK(CombinedAnalysis::isSnapshotSafe("electricpotential", json::object()));
+        CHECK(CombinedAnalysis::isSnapshotSafe("electricpotential", {{"policy", "fixed"}}));
+        CHECK_FALSE(CombinedAnalysis::isSnapshotSafe("electricpotential", {{"policy", "random_walk"}}));
+        CHECK_FALSE(CombinedAnalysis::isSnapshotSafe("systemenergy", json::object()));
+    }
+
+    // the system is perturbed between samples, so that stale snapshots would change the result
+    auto sample = [&](int number_of_threads) {
+        input["analysis_threads"] = number_of_threads;
+        Space spc(input);
+        Energy::Hamiltonian pot(spc, input.at("energy"));
+        CombinedAnalysis analysis(analyses, spc, pot, input);
+        Random displacement_random;
+        for (int step = 0; step < 20; ++step) {
+            analysis.sample();
+            auto& group = spc.groups.at(step % spc.groups.size());
+            for (auto& particle : group) {
+                particle.pos += Point(displacement_random(), displacement_random(), displacement_random());
+                spc.geometry.boundary(particle.pos);
+            }
+            if (auto mass_center = group.massCenter()) {
+                (*mass_center).get() = Geometry::massCenter(group.begin(), group.end(),
+                                                            spc.geometry.getBoundaryFunc(), -group.begin()->pos);
+            }
+        }
+        json j = analysis;
+        for (auto& item : j) {
+            item.begin()->erase("relative time");
+        }
+        return j;
+    };
+
+    SUBCASE("identical to synchronous sampling") {
+        const auto synchronous = sample(0);
+        REQUIRE(synchronous.size() == 3);
+        CHECK(synchronous[0].contains("atom_density")); // input order is kept
+        CHECK(synchronous[2].contains("multipole"));
+        CHECK(sample(2) == synchronous);
+    }
+    Faunus::atoms = original_atoms;
+    Faunus::molecules = original_molecules;
+}
+
+TEST_CASE("[Faunus] PairFunctionBase - cell list") {
+    const auto original_atoms = Faunus::atoms;
+    const auto original_molecules = Faunus::molecules;
+    auto input = R"({
+        "atomlist": [{"A": {"sigma": 1.0}}],
+        "moleculelist": [{"salt": {"atoms": ["A"], "atomic": true}}],
+        "insertmolecules": [{"salt": {"N": 200}}],
+        "geometry": {"type": "cuboid", "length": [20, 25, 30]}
+    })"_json;
+    Faunus::atoms = input["atomlist"].get<decltype(Faunus::atoms)>();
+    Faunus::molecules = input["moleculelist"].get<decltype(Faunus::molecules)>();
+
+    // exposes the histogram of `samplePairs()`
+    class PairFunctionProbe : public PairFunctionBase {
+        void _sample() override {}
+
+      public:
+        using PairFunctionBase::PairFunctionBase;
+        using PairFunctionBase::samplePairs;
+        const auto& getHistogram() const { return histogram; }
+    };
+
+    auto positions_in = [](const Space& spc) {
+        return spc.activeParticles() | ranges::cpp20::views::transform(&Particle::pos) | ranges::to_vector;
+    };
+    auto total_counts = [](const auto& histogram) {
+        double sum = 0.0;
+        for (size_t bin = 0; bin < histogram.size(); ++bin) {
+            sum += histogram[bin].second;
+        }
+        return sum;
+    };
+    const auto max_distance = 6.0;
+    const json brute_force_input = {{"file", "rdf.dat"}, {"name1", "A"}, {"name2", "A"}, {"dr", 0.2}};
+    auto cell_list_input = brute_force_input;
+    cell_list_input["rmax"] = max_distance;
+
+    SUBCASE("cuboid: identical to brute force") {
+        Space spc(input);
+        PairFunctionProbe cell_list(spc, cell_list_input, "probe");
+        PairFunctionProbe brute_force(spc, brute_force_input, "probe");
+        CHECK(json(cell_list).at("probe").at("cell_list") == true);
+        const auto positions = positions_in(spc);
+        cell_list.samplePairs(positions, positions);
+        brute_force.samplePairs(positions, positions);
+        const auto& histogram = cell_list.getHistogram();
+        REQUIRE(histogram.size() > 0);
+        for (size_t bin = 0; bin < histogram.size(); ++bin) {
+            const auto [distance, counts] = histogram[bin];
+            if (distance + 0.2 < max_distance) {
+                CHECK(counts == brute_force.getHistogram()(distance + 0.1));
+            }
+        }
+        CHECK(total_counts(histogram) > 0.0);
+    }
+
+    SUBCASE("truncated octahedron: brute force") {
+        input["geometry"] = R"({"type": "octahedron", "length": 25})"_json;
+        Space spc(input);
+        PairFunctionProbe probe(spc, cell_list_input, "probe");
+        CHECK(json(probe).at("probe").at("cell_list") == false);
+        const auto positions = positions_in(spc);
+        probe.samplePairs(positions, positions);
+        double pairs_within_range = 0.0;
+        for (size_t i = 0; i < positions.size(); ++i) {
+            for (size_t j = i + 1; j < positions.size(); ++j) {
+                if (spc.geometry.sqdist(positions[i], positions[j]) < max_distance * max_distance) {
+                    pairs_within_range++;
+                }
+            }
+        }
+        CHECK(total_counts(probe.getHistogram()) == pairs_within_range);
+    }
+    Faunus::atoms = original_atoms;
+    Faunus::molecules = original_molecules;
+}
+
+TEST_CASE("[Faunus] ElectricPotential") {
+    const auto original_atoms = Faunus::atoms;
+    const auto original_molecules = Faunus::molecules;
+    auto input = R"({
+        "atomlist": [{"A": {"sigma": 2.0, "q": 1.0}}, {"B": {"sigma": 2.0, "q": -1.0}}, {"C": {"sigma": 2.0}}],
+        "moleculelist": [{"salt": {"atoms": ["A", "B", "B", "C"], "atomic": true}}],
+        "insertmolecules": [{"salt": {"N": 100}}],
+        "geometry": {"type": "cuboid", "length": [30, 35, 40]}
+    })"_json;
+    Faunus::atoms = input["atomlist"].get<decltype(Faunus::atoms)>();
+    Faunus::molecules = input["moleculelist"].get<decltype(Faunus::molecules)>();
+    json j = {{"nstep", 1},
+              {"epsr", 80.0},
+              {"type", "plain"},
+              {"structure", {{0.0, 0.0, 0.0}, {5.0, -7.0, 11.0}, {14.0, 17.0, -19.0}}}};
+
+    // per particle loop over all active particles, as before vectorization
+    auto reference_potentials = [&](const Space& spc) {
+        Potential::NewCoulombGalore coulomb;
+        Potential::from_json(j, coulomb);
+        const auto cutoff = j.value("cutoff", pc::infty);
+        std::vector<double> potentials;
+        for (const auto& target : j.at("structure").get<PointVector>()) {
+            auto potential = 0.0;
+            for (const auto& particle : spc.activeParticles()) {
+                if (const auto distance = std::sqrt(spc.geometry.sqdist(particle.pos, target)); distance < cutoff) {
+                    potential += coulomb.getCoulombGalore().ion_potential(particle.charge, distance);
+                }
+            }
+            potentials.push_back(potential);
+        }
+        return potentials;
+    };
+
+    auto check_against_reference = [&] {
+        Space spc(input);
+        ElectricPotential analysis(j, spc);
+        analysis.sample();
+        const auto potentials =
+            json(analysis).at("electricpotential").at("mean potentials βe⟨ϕᵢ⟩").get<std::vector<double>>();
+        const auto reference = reference_potentials(spc);
+        REQUIRE(potentials.size() == reference.size());
+        for (size_t i = 0; i < reference.size(); ++i) {
+            CHECK(potentials[i] == doctest::Approx(reference[i]));
+        }
+    };
+
+    SUBCASE("cuboid") { check_against_reference(); }
+    SUBCASE("cuboid with cell list") {
+        j["type"] = "fanourgakis";
+        j["cutoff"] = 9.0;
+        check_against_reference();
+    }
+    SUBCASE("truncated octahedron") {
+        input["geometry"] = R"({"type": "octahedron", "length": 40})"_json;
+        check_against_reference();
+    }
+    Faunus::atoms = original_atoms;
+    Faunus::molecules = original_molecules;
+}
+
+TEST_CASE("[Faunus] CombinedAnalysis - merge") {
+    const auto original_atoms = Faunus::atoms;
+    const auto original_molecules = Faunus::molecules;
+    const auto input = R"({
+        "atomlist": [{"A": {"sigma": 2.0}}, {"B": {"sigma": 2.0}}],
+        "moleculelist": [{"salt": {"atoms": ["A", "B"], "atomic": true}}],
+        "insertmolecules": [{"salt": {"N": 20}}],
+        "geometry": {"type": "cuboid", "length": 20},
+        "energy": []
+    })"_json;
+    Faunus::atoms = input["atomlist"].get<decltype(Faunus::atoms)>();
+    Faunus::molecules = input["moleculelist"].get<decltype(Faunus::molecules)>();
+
+    // trajectory of random walks
+    std::vector<PointVector> frames;
+    {
+        Space spc(input);
+        Random displacement_random;
+        for (int frame = 0; frame < 10; ++frame) {
+            for (auto& particle : spc.particles) {
+                particle.pos += Point(displacement_random(), displacement_random(), displacement_random());
+                spc.geometry.boundary(particle.pos);
+            }
+            frames.push_back(spc.positions() | ranges::to_vector);
+        }
+    }
+
+    // each instance samples the given frames; the merged g(r) and json output are returned
+    auto sample = [&](const std::vector<std::vector<size_t>>& frames_per_instance) {
+        auto analysis_input = R"([{"atomrdf": {"file": "merge_rdf.dat", "name1": "A", "name2": "B",
+                                               "dr": 0.5, "nstep": 1}},
+                                  {"atom_density": {"nstep": 2}}])"_json;
+        std::vector<std::unique_ptr<Space>> spaces;
+        std::vector<std::unique_ptr<Energy::Hamiltonian>> hamiltonians;
+        std::vector<std::unique_ptr<CombinedAnalysis>> analyses;
+        for (const auto& frame_indices : frames_per_instance) {
+            auto& spc = *spaces.emplace_back(std::make_unique<Space>(input));
+            auto& pot = *hamiltonians.emplace_back(std::make_unique<Energy::Hamiltonian>(spc, input.at("energy")));
+            auto& analysis = *analyses.emplace_back(std::make_unique<CombinedAnalysis>(analysis_input, spc, pot));
+            size_t next_frame = 0;
+            for (const auto frame_index : frame_indices) {
+                analysis.advanceSteps(static_cast<int>(frame_index - next_frame));
+                std::copy(frames[frame_index].begin(), frames[frame_index].end(), spc.positions().begin());
+                analysis.sample();
+                next_frame = frame_index + 1;
+            }
+        }
+        std::for_each(std::next(analyses.begin()), analyses.end(),
+                      [&](auto& other) { analyses.front()->merge(*other); });
+        json j = *analyses.front();
+        for (auto& item : j) {
+            item.begin()->erase("relative time");
+        }
+        analyses.front()->vec.front()->to_disk();
+        std::vector<double> rdf;
+        std::ifstream stream("merge_rdf.dat");
+        for (double value; stream >> value;) {
+            rdf.push_back(value);
+        }
+        std::remove("merge_rdf.dat");
+        return std::make_pair(j, rdf);
+    };
+
+    const auto single_run = sample({{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}});
+    const auto& [single_json, single_rdf] = single_run;
+    REQUIRE_FALSE(single_rdf.empty());
+    CHECK(single_json[1].at("atom_density").at("samples") == 5);
+
+    auto check_against_single_run = [&](const std::vector<std::vector<size_t>>& frames_per_instance) {
+        const auto [merged_json, merged_rdf] = sample(frames_per_instance);
+        CHECK(merged_json == single_run.first);
+        REQUIRE(merged_rdf.size() == single_run.second.size());
+        for (size_t i = 0; i < merged_rdf.size(); ++i) {
+            CHECK(merged_rdf[i] == doctest::Approx(single_run.second[i]));
+        }
+    };
+    SUBCASE("contiguous blocks") { check_against_single_run({{0, 1, 2, 3, 4}, {5, 6, 7, 8, 9}}); }
+    SUBCASE("interleaved frames") { check_against_single_run({{0, 2, 3, 6, 9}, {1, 4, 5, 7, 8}}); }
+    Faunus::atoms = original_atoms;
+    Faunus::molecules = original_molecules;
+}
+
 } // namespace Faunus::Analysis
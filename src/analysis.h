@@ -10,10 +10,7 @@
 #include <aux/sparsehistogram.h>
 #include <Eigen/SparseCore>
 #include <set>
-
-namespace cereal {
-class BinaryOutputArchive;
-}
+#include <sstream>
 
 namespace Faunus::Potential {
 class NewCoulombGalore;
@@ -51,6 +48,7 @@ class Analysisbase {
     virtual void _from_json(const json&);                 //!< setup from json
     virtual void _sample() = 0;                           //!< perform sample event
     virtual void _to_disk();                              //!< save sampled data to disk
+    virtual void _merge(const Analysisbase& other);       //!< add sampled data from another instance
     int number_of_steps = 0;                              //!< counter for total number of steps
     int number_of_skipped_steps = 0;                      //!< steps to skip before sampling (do not modify)
     TimeRelativeOfTotal<std::chrono::microseconds> timer; //!< timer to benchmark `_sample()`
@@ -67,7 +65,10 @@ class Analysisbase {
     void from_json(const json& j); //!< configure from json object
     void to_disk();                //!< Save data to disk (if defined)
     void sample();                 //!< Increase step count and sample
+    void advanceSteps(int steps);  //!< Increase step count without sampling
+    void merge(const Analysisbase& other); //!< Add samples from an identically configured instance
     int getNumberOfSteps() const;  //!< Number of steps
+    bool isSampleStep(int step) const; //!< True if `_sample()` is called at given step count
     Analysisbase(const Space& spc, std::string_view name);
     Analysisbase(const Space& spc, std::string_view name, int sample_interval, int number_of_skipped_steps);
     virtual ~Analysisbase() = default;
@@ -81,13 +82,14 @@ void to_json(json& j, const Analysisbase& base);
  * @param j JSON input for analysis
  * @param spc Space the analysis should operate on
  * @param pot Hamiltonian representing the system
+ * @param input Complete simulation input; needed only by analyses creating thread-local copies of the system
  * @return Shared pointer to analysis
  *
  * After writing a new analysis, it must be added to this function in
  * order to be controlled from the main faunus input.
  */
 std::unique_ptr<Analysisbase> createAnalysis(const std::string& name, const json& j, Space& spc,
-                                             Energy::Hamiltonian& pot);
+                                             Energy::Hamiltonian& pot, const json& input = json());
 
 /**
  * @brief Aggregator class for storing and selecting multiple analysis instances
@@ -95,19 +97,50 @@ std::unique_ptr<Analysisbase> createAnalysis(const std::string& name, const json
  * Holds an arbitrary number of analysis instances and selects them at
  * random, based on user input. This is typically called from the
  * main simulation loop.
+ *
+ * If `analysis_threads` is given in the simulation input, analyses that only read
+ * the Space (see `isSnapshotSafe()`) operate on a snapshot of the system, shared among them
+ * and updated once at steps where any of them samples, and are sampled by a pool of worker
+ * threads while the Markov chain continues. The snapshot is not updated before all previous
+ * samples have finished. Analyses are still sampled in input order.
+ *
+ * Analyses listed in `isMergeable()` may also be sampled by several identically
+ * configured instances, each visiting its own part of a trajectory, and combined
+ * afterwards using `merge()`. This is used for offline trajectory analysis.
  */
 class CombinedAnalysis : public BasePointerVector<Analysisbase> {
+    class ThreadPool;
+    struct AsynchronousAnalysis;
+    const Space& spc;                                                    //!< Space of the Markov chain
+    std::unique_ptr<Space> snapshot;                                     //!< Read by asynchronous analyses
+    std::vector<std::unique_ptr<AsynchronousAnalysis>> asynchronous_analyses; //!< Sampled by `thread_pool`
+    std::vector<AsynchronousAnalysis*> asynchronous_in_input_order; //!< Same order as `vec`; nullptr if synchronous
+    std::unique_ptr<ThreadPool> thread_pool;                             //!< Set if `analysis_threads` > 0
+    void synchronize();       //!< Wait for all asynchronous analyses to catch up
+    void waitForSnapshot();   //!< Wait until no asynchronous analysis reads `snapshot`
+    void createSnapshot(const json& input); //!< Create `snapshot` from simulation input
+    friend void to_json(json& j, const CombinedAnalysis& analysis);
+
   public:
-    CombinedAnalysis(const json& json_array, Space& spc, Energy::Hamiltonian& pot);
+    CombinedAnalysis(const json& json_array, Space& spc, Energy::Hamiltonian& pot, const json& input = json());
+    ~CombinedAnalysis();
     void sample();
     void to_disk(); //!< prompt all analysis to save to disk if appropriate
+    void advanceSteps(int steps);               //!< Increase step count of all analyses without sampling
+    void merge(CombinedAnalysis& other);        //!< Add samples from an identically configured instance
+    static bool isSnapshotSafe(const std::string& name,
+                               const json& parameters); //!< Can analysis operate on a snapshot?
+    static bool isMergeable(const std::string& name);    //!< Can samples from several instances be merged?
 };
 
+void to_json(json& j, const CombinedAnalysis& analysis); //!< Completes all pending samples first
+
 /**
  * @brief Base class for perturbation analysis
  *
  * This class provides basic data and functions to support Widom Particle Insertion, Virtual Volume Move
  * etc. If a non-empty `filename` is given, a (compressed) output file used for streaming will be opened.
+ * For binary column files (.fcol, .zfcol), `column_writer` must instead be created by derived classes.
  *
  * @note Constructor throws if non-empty filename cannot to opened for writing
  */
@@ -120,6 +153,7 @@ class PerturbationAnalysisBase : public Analysisbase {
     Energy::Energybase& pot;
     std::string filename;                                 //!< output filename (optional)
     std::unique_ptr<std::ostream> stream = nullptr;       //!< output file stream if filename given
+    std::unique_ptr<ColumnWriter> column_writer = nullptr; //!< replaces `stream` for .fcol/.zfcol files
     Change change;                                        //!< Change object to describe perturbation
     Average<double> mean_exponentiated_energy_change;     //!< < exp(-du/kT) >
     bool collectWidomAverage(const double energy_change); //!< add to exp(-du/kT) incl. safety checks
@@ -136,6 +170,7 @@ class FileReactionCoordinate : public Analysisbase {
     Average<double> mean_reaction_coordinate;
     const std::string filename;
     std::unique_ptr<std::ostream> stream = nullptr;
+    std::unique_ptr<ColumnWriter> column_writer = nullptr; //!< replaces `stream` for .fcol/.zfcol files
     const std::unique_ptr<ReactionCoordinate::ReactionCoordinateBase> reaction_coordinate;
 
     void _to_json(json& j) const override;
@@ -202,22 +237,44 @@ class MassCenterDisplacement : public AtomicDisplacement {
 /**
  * @brief Excess chemical potential of molecules
  *
+ * With more than one thread, all insertions of a sample event are first generated
+ * and then evaluated in parallel by workers holding their own copy of the system
+ * and Hamiltonian. Before each sample event, only groups that differ from the copies
+ * are synchronized, and the energies are collected in insertion order, so that results
+ * match a serial run.
+ *
  * @todo Migrate `absolute_z_coords` into new `MoleculeInserter` policy
  */
 class WidomInsertion : public PerturbationAnalysisBase {
+    //! Thread-local copy of the system
+    struct Worker {
+        std::unique_ptr<Space> spc;
+        std::unique_ptr<Energy::Hamiltonian> pot;
+    };
     std::shared_ptr<MoleculeInserter> inserter; //!< Insertion method
+    std::shared_ptr<CavityInserter> cavity_inserter; //!< Set if insertions are cavity biased; same as `inserter`
     int number_of_insertions;                   //!< Number of insertions per sample event
+    int number_of_threads = 1;                  //!< Number of threads used to evaluate insertion energies
     MoleculeData::index_type molid;             //!< Molecule id
     bool absolute_z_coords = false;             //!< Apply abs() on all inserted z coordinates?
+    std::vector<std::unique_ptr<Worker>> workers; //!< Used if `number_of_threads` > 1
+    std::vector<ParticleVector> insertions;       //!< Generated insertions for parallel evaluation
+    std::vector<double> energy_changes;           //!< Energy change for each of `insertions` (kT)
+    Change worker_change;                         //!< Difference between system and `workers` before sampling
+    bool workers_initialized = false;             //!< False until `workers` have been fully synchronized
 
     void selectGhostGroup(); //!< Select inactive group to act as group particle
-    void updateGroup(Space::GroupType& group, const ParticleVector& particles);
+    void updateGroup(Space::GroupType& group, const ParticleVector& particles) const;
+    void createWorkers(const json& input); //!< Create thread-local system copies from simulation input
+    void sampleParallel(double bias);      //!< Evaluate insertions using `workers`
+    void synchronizeWorkers();             //!< Copy changes since the previous sample event to `workers`
+    double updateCavityBias();             //!< Update cavity grid and return insertion bias (kT)
     void _sample() override; //!< Called for each sample event
     void _to_json(json& j) const override;
     void _from_json(const json& j) override;
 
   public:
-    WidomInsertion(const json& j, Space& spc, Energy::Hamiltonian& pot);
+    WidomInsertion(const json& j, Space& spc, Energy::Hamiltonian& pot, const json& input = json());
 };
 
 /**
@@ -237,13 +294,17 @@ class ElectricPotential : public Analysisbase {
         std::unique_ptr<SparseHistogram<double>> potential_histogram; //!< Histogram of observed potentials
     };
     std::vector<Target> targets;                             //!< List of target points where to sample the potential
+    std::vector<double> target_potentials;                   //!< Latest potential at each target
     Policies policy;                                         //!< Policy to apply to targets before each sample event
     std::unique_ptr<Potential::NewCoulombGalore> coulomb;    //!< Class for calculating the potential
+    double cutoff = pc::infty;                               //!< Coulomb cutoff; charges beyond are skipped
+    struct ChargeArrays;                                     //!< Charges in structure-of-arrays layout
+    std::unique_ptr<ChargeArrays> charges;                   //!< Active charges, updated for each sample event
     Average<double> mean_potential_correlation;              //!< Correlation between targets, <phi1 x phi2 x ... >
     SparseHistogram<double> potential_correlation_histogram; //!< Distribution of correlations, P(<phi1 x phi2 x ... >)
     void getTargets(const json& j);                          //!< Get user defined target positions
     void setPolicy(const json& j);                           //!< Set user defined position setting policy
-    double calcPotentialOnTarget(const Target& target);      //!< Evaluate net potential of target position
+    void calcPotentialOnTargets();                           //!< Evaluate net potential of all target positions
     bool overlapWithParticles(const Point& position) const;  //!< Check if position is within the radius of any particle
     std::function<void()> applyPolicy;                       //!< Lambda for position setting policy
     json output_information;                                 //!< json output generated during construction
@@ -253,6 +314,7 @@ class ElectricPotential : public Analysisbase {
 
   public:
     ElectricPotential(const json& j, const Space& spc);
+    ~ElectricPotential() override;
 };
 
 NLOHMANN_JSON_SERIALIZE_ENUM(ElectricPotential::Policies,
@@ -323,6 +385,7 @@ class DensityBase : public Analysisbase {
     void _sample() override;
     void _to_json(json &j) const override;
     void writeTable(std::string_view name, Table& table);
+    void _merge(const Analysisbase& other) override;
   private:
     virtual std::map<id_type, int> count() const = 0;
     std::map<MoleculeData::index_type, Table> probability_density;
@@ -360,6 +423,7 @@ class AtomDensity : public DensityBase {
     std::map<id_type, Table> atomswap_probability_density;
     void _sample() override;
     void _to_disk() override;
+    void _merge(const Analysisbase& other) override;
     std::map<id_type, int> count() const override;
 
   public:
@@ -389,6 +453,7 @@ std::function<bool(double)> createValueFilter(const std::string& name, const jso
 class PairMatrixAnalysis : public Analysisbase {
   private:
     std::unique_ptr<std::ostream> matrix_stream; //!< Pair matrix output stream
+    std::unique_ptr<ColumnWriter> column_writer; //!< Non-zero elements as columns for .fcol/.zfcol files
     std::string filename;                        //!< cluster fraction filename
     virtual void setPairMatrix() = 0;            //!< Fills in `pair_matrix` with sampled values
     void _to_json(json& j) const override;
@@ -466,6 +531,10 @@ class Multipole : public Analysisbase {
 
 /**
  * @brief Save system energy to disk
+ *
+ * Energies are taken from the running per term energies maintained by the Hamiltonian
+ * from accepted Monte Carlo moves. A full recalculation is done every `drift_check_interval`
+ * samples, or whenever the running energies are unknown, and used to re-anchor them.
  */
 class SystemEnergy : public Analysisbase {
   private:
@@ -473,11 +542,17 @@ class SystemEnergy : public Analysisbase {
     std::string file_name;
     std::string separator;
     std::unique_ptr<std::ostream> output_stream;
+    std::unique_ptr<ColumnWriter> column_writer; //!< replaces `output_stream` for .fcol/.zfcol files
+    std::vector<double> row;                     //!< reused buffer for `column_writer`
     std::vector<double> calculateEnergies() const;
     Average<double> mean_energy;
     Average<double> mean_squared_energy;
     Table2D<double, double> energy_histogram; // Density histograms
     double initial_energy = 0.0;
+    int drift_check_interval = 100;  //!< Samples between full recalculations; tracked energies in between
+    int number_of_drift_checks = 0;  //!< Number of full recalculations compared with tracked energies
+    double max_energy_drift = 0.0;   //!< Largest absolute difference between tracked and recalculated energy (kT)
+    std::vector<double> currentEnergies(); //!< Tracked energies if available; otherwise full recalculation
 
     void createOutputStream();
     void normalize();
@@ -524,9 +599,15 @@ class SaveState : public Analysisbase {
     bool use_numbered_files = true;
     bool convert_hexagonal_prism_to_cuboid = false;
     std::string filename;
+    struct PendingCheckpoint {
+        std::string filename;
+        SpaceCheckpoint checkpoint;
+    };
+    std::unique_ptr<BackgroundWriter<PendingCheckpoint>> checkpoint_writer; //!< Writes `.ckpt` files
 
     void _to_json(json& j) const override;
     void _sample() override;
+    void _to_disk() override;
     void saveAsCuboid(const std::string& filename, const Space& spc, StructureFileWriter& writer) const;
     void saveJsonStateFile(const std::string& filename, const Space& spc) const;
     void saveBinaryJsonStateFile(const std::string& filename, const Space& spc) const;
@@ -554,12 +635,26 @@ class PairFunctionBase : public Analysisbase {
     Average<double> mean_volume;                  //!< average volume (angstrom^3)
     Eigen::Vector3i slicedir = {0, 0, 0};
     double thickness = 0;
+    double max_distance = pc::infty; //!< pairs beyond this distance are not histogrammed
+    double skipped_pairs = 0;        //!< number of pairs beyond `max_distance`; needed for normalization
+
+    /**
+     * @brief Histogram all pair distances between two sets of positions
+     *
+     * If the same vector is passed twice, each unique pair is sampled once.
+     * Periodic cuboids with a finite `max_distance` use a cell list; otherwise all
+     * pairs are visited. In both cases the outer loop is split across OpenMP threads
+     * with private histograms that are merged at the end.
+     */
+    void samplePairs(const std::vector<Point>& positions1, const std::vector<Point>& positions2);
 
   private:
     void _from_json(const json& j) override;
     void _to_json(json& j) const override;
     void _to_disk() override;
+    void _merge(const Analysisbase& other) override;
     double volumeElement(double r) const;
+    bool useCellList() const; //!< True if the geometry and `max_distance` allow for a cell list
 
   public:
     PairFunctionBase(const Space& spc, const json &j, const std::string_view name);
@@ -585,7 +680,7 @@ class AtomRDF : public PairFunctionBase {
 class MoleculeRDF : public PairFunctionBase {
   private:
     void _sample() override;
-    void sampleDistance(const Group& group_i, const Group& group_j);
+    std::vector<Point> massCenters(index_type molid) const; //!< mass centers of active groups
     void sampleDifferent(); //!< group types are different (id1!=id2)
     void sampleIdentical(); //!< group types are identical (id1==id2)
 
@@ -624,6 +719,9 @@ class AtomDipDipCorr : public PairAngleFunctionBase {
  * This will save both active and inactive particles as the XTC format must have the
  * same number of particles on all frames. See `QRtraj` for a solution how to disable
  * inactive groups in e.g. VMD.
+ *
+ * Positions are copied into recycled frames, which by default are compressed and written by a
+ * background thread; `to_disk()` waits until all sampled frames are written.
  */
 class XTCtraj : public Analysisbase {
   private:
@@ -631,8 +729,11 @@ class XTCtraj : public Analysisbase {
     std::vector<index_type> group_ids;      //!< group ids to save to disk (empty = all)
     std::vector<std::size_t> group_indices; //!< indices of groups to save (active AND inactive)
     std::unique_ptr<XTCWriter> writer;
+    int buffer_size = 4; //!< frames buffered for the background writer (0 = write in calling thread)
+    std::unique_ptr<BackgroundWriter<TrajectoryFrame>> background_writer; //!< Must be destroyed before `writer`
     void _to_json(json& j) const override;
     void _sample() override;
+    void _to_disk() override;
     XTCtraj(const Space& spc, const std::string& filename, const std::vector<std::string>& molecule_names);
 
   public:
@@ -730,7 +831,7 @@ class MultipoleDistribution : public Analysisbase {
  */
 class ScatteringFunction : public Analysisbase {
   private:
-    enum class Schemes { DEBYE, EXPLICIT_PBC, EXPLICIT_IPBC }; // three different schemes
+    enum class Schemes { DEBYE, DEBYE_HISTOGRAM, EXPLICIT_PBC, EXPLICIT_IPBC }; // four different schemes
     Schemes scheme = Schemes::DEBYE;
     bool mass_center_scattering;             //!< scatter from mass center, only?
     bool save_after_sample = false;          //!< if true, save average S(q) after each sample point
@@ -741,6 +842,7 @@ class ScatteringFunction : public Analysisbase {
     using Tformfactor = Scatter::FormFactorUnity<double>;
 
     std::unique_ptr<Scatter::DebyeFormula<Tformfactor>> debye;
+    std::unique_ptr<Scatter::DebyeHistogramFormula<>> debye_histogram;
     std::unique_ptr<Scatter::StructureFactorPBC<>> explicit_average_pbc;
     std::unique_ptr<Scatter::StructureFactorIPBC<>> explicit_average_ipbc;
     void _sample() override;
@@ -853,15 +955,19 @@ class PolymerShape : public Analysisbase {
  *
  * For use with VMD to visualize charge fluctuations and grand canonical ensembles. Inactive
  * particles have zero charge and radius. If the `filename` ends with `.gz` a GZip compressed
- * file is created.
+ * file is created. Frames are formatted in the calling thread, while compression and
+ * writing are by default done in a background thread.
  */
 class QRtraj : public Analysisbase {
   protected:
-    std::function<void()> write_to_file;            //!< Write a single frame to stream
-    std::unique_ptr<std::ostream> stream = nullptr; //!< Output stream
+    std::function<void(std::ostream&)> write_to_file; //!< Write a single frame to stream
+    std::unique_ptr<std::ostream> stream = nullptr;   //!< Output stream
 
   private:
     std::string filename;    //!< Output filename
+    int buffer_size = 4;     //!< frames buffered for the background writer (0 = write in calling thread)
+    std::ostringstream frame_stream; //!< Formatted frame handed to `background_writer`
+    std::unique_ptr<BackgroundWriter<std::string>> background_writer; //!< Must be destroyed before `stream`
     void _sample() override; //!< Samples one frame and outputs to stream
     void _to_json(json& j) const override;
     void _to_disk() override;
@@ -900,10 +1006,10 @@ class PatchySpheroCylinderTrajectory : public QRtraj {
  */
 class SpaceTrajectory : public Analysisbase {
   private:
-    const Space::GroupVector& groups; // reference to all groups
     std::string filename;
+    unsigned int keyframe_interval = 10;                 //!< Frames between full (non-delta) frames
     std::unique_ptr<std::ostream> stream;
-    std::unique_ptr<cereal::BinaryOutputArchive> archive;
+    std::unique_ptr<FormatSpaceTrajectory> trajectory; //!< Must be destroyed before `stream`
     void _sample() override;
     void _to_json(json& j) const override;
     void _to_disk() override;
@@ -1,6 +1,7 @@
 #pragma once
 #include <doctest/doctest.h>
 #include <vector>
+#include <algorithm>
 #include <cmath>
 #include <string>
 #include <limits>
@@ -152,6 +153,16 @@ template <typename Tx = double, typename Ty = Tx, bool centerbin = false> class
         return vec.at(i);
     } // return y value for given x
 
+    auto& operator+=(const Equidistant2DTable& other) {
+        assert(other._xmin == _xmin && other._dxinv == _dxinv);
+        if (other.vec.size() > vec.size()) {
+            vec.resize(other.vec.size(), Ty());
+        }
+        std::transform(other.vec.begin(), other.vec.end(), vec.begin(), vec.begin(),
+                       [](const auto& y_other, const auto& y) { return y + y_other; });
+        return *this;
+    } // add y-values of table with identical resolution
+
     // can be optinally used to customize streaming out, normalise etc.
     std::function<void(std::ostream &, Tx, Ty)> stream_decorator = nullptr;
 
@@ -219,6 +230,17 @@ TEST_CASE("[Faunus] Equidistant2DTable") {
         CHECK(y(1.0) == Approx(0.5));
         CHECK(y.xmax() == Approx(1.0));
     }
+
+    SUBCASE("merge") {
+        Equidistant2DTable<double> y(0.5, -3.0), z(0.5, -3.0);
+        y(-3.0) = 1.0;
+        z(-3.0) = 2.0;
+        z(1.0) = 3.0;
+        y += z;
+        CHECK(y(-3.0) == Approx(3.0));
+        CHECK(y(1.0) == Approx(3.0));
+        CHECK(y.size() == z.size());
+    }
 }
 
 } // namespace Faunus
\ No newline at end of file
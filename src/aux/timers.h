@@ -24,6 +24,8 @@ template <typename Tunit = std::chrono::microseconds> class TimeRelativeOfTotal
 
     void stop() { delta += std::chrono::duration_cast<Tunit>(std::chrono::steady_clock::now() - tx); }
 
+    Tunit duration() const { return delta; } //!< Accumulated time between `start()` and `stop()` calls
+
     double result() const {
         auto now = std::chrono::steady_clock::now();
         auto total = std::chrono::duration_cast<Tunit>(now - t0);
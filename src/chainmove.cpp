@@ -1,6 +1,8 @@
 #include "chainmove.h"
 #include "aux/iteratorsupport.h"
 #include "bonds.h"
+#include "energy.h"
+#include <doctest/doctest.h>
 
 namespace Faunus {
 namespace Move {
@@ -87,6 +89,7 @@ void ChainRotationMove::store_change(Change &change) {
         change_data.group_index = Faunus::distance(spc.groups.begin(), &chain); // integer *index* of moved group
         change_data.all = false;
         change_data.internal = true;          // trigger internal interactions
+        change_data.rigid_segment = true;     // segment is rotated as a rigid body
         change.groups.push_back(change_data); // add to list of moved groups
     }
 }
@@ -205,5 +208,67 @@ size_t PivotMove::select_segment() {
     return segment_size;
 }
 
+TEST_CASE("[Faunus] PivotMove - rigid segment energy change") {
+    const auto original_atoms = Faunus::atoms;
+    const auto original_molecules = Faunus::molecules;
+    const auto original_move_random = MoveBase::slump;
+    auto input = R"({
+        "atomlist": [{"A": {"sigma": 2.0, "eps": 0.5}}, {"B": {"sigma": 3.0, "eps": 0.5}}],
+        "moleculelist": [
+            {"chain": {"excluded_neighbours": 1,
+                       "structure": [{"A": [0.0, 0.0, 0.0]}, {"A": [2.0, 0.5, 0.0]}, {"B": [4.0, 0.0, 0.5]},
+                                     {"A": [6.0, 0.5, 0.0]}, {"B": [8.0, 0.0, 0.5]}, {"A": [10.0, 0.5, 0.0]}],
+                       "bondlist": [{"harmonic": {"index": [0, 1], "k": 1.0, "req": 2.0}},
+                                    {"harmonic": {"index": [1, 2], "k": 1.0, "req": 2.0}},
+                                    {"harmonic": {"index": [2, 3], "k": 1.0, "req": 2.0}},
+                                    {"harmonic": {"index": [3, 4], "k": 1.0, "req": 2.0}},
+                                    {"harmonic": {"index": [4, 5], "k": 1.0, "req": 2.0}},
+                                    {"harmonic_torsion": {"index": [0, 1, 2], "k": 0.5, "aeq": 120}},
+                                    {"periodic_dihedral": {"index": [0, 1, 2, 3], "k": 2.0, "phi": 0.0, "n": 3}},
+                                    {"periodic_dihedral": {"index": [2, 3, 4, 5], "k": 2.0, "phi": 0.0, "n": 3}}]}},
+            {"salt": {"atoms": ["B"], "atomic": true}}],
+        "insertmolecules": [{"chain": {"N": 1}}, {"salt": {"N": 10}}],
+        "geometry": {"type": "cuboid", "length": 30},
+        "energy": [{"bonded": {}}, {"nonbonded": {"default": [{"lennardjones": {"mixing": "LB"}}]}}]
+    })"_json;
+    Faunus::atoms = input["atomlist"].get<decltype(Faunus::atoms)>();
+    Faunus::molecules = input["moleculelist"].get<decltype(Faunus::molecules)>();
+
+    Change everything;
+    everything.everything = true;
+    Space spc(input);
+    Space trial_spc(input);
+    trial_spc.sync(spc, everything);
+    Energy::Hamiltonian hamiltonian(spc, input.at("energy"));
+    Energy::Hamiltonian trial_hamiltonian(trial_spc, input.at("energy"));
+    PivotMove pivot(trial_spc);
+    pivot.from_json({{"molecule", "chain"}, {"dprot", 2.0}});
+
+    // the segment's internal pairs are skipped, but bonded and segment-to-rest terms must match a full evaluation
+    int number_of_pivots = 0;
+    Change change;
+    for (int i = 0; i < 50; ++i) {
+        pivot.move(change);
+        if (change.empty()) {
+            continue;
+        }
+        ++number_of_pivots;
+        CHECK(change.groups.at(0).rigid_segment);
+        trial_hamiltonian.updateState(change);
+        const auto energy_change = trial_hamiltonian.energy(change) - hamiltonian.energy(change);
+        const auto old_energy = hamiltonian.energy(everything);
+        const auto full_energy_change = trial_hamiltonian.energy(everything) - old_energy;
+        // full energies may be large, e.g. from overlapping salt, whereby their difference is inexact
+        CHECK(energy_change == doctest::Approx(full_energy_change).epsilon(1e-9).scale(std::fabs(old_energy)));
+        spc.sync(trial_spc, change); // accept
+        hamiltonian.sync(&trial_hamiltonian, change);
+        pivot.accept(change);
+    }
+    CHECK(number_of_pivots > 10);
+    Faunus::atoms = original_atoms;
+    Faunus::molecules = original_molecules;
+    MoveBase::slump = original_move_random;
+}
+
 } // end of namespace Move
 } // namespace Faunus
@@ -1,8 +1,10 @@
 #include "clustermove.h"
+#include "celllistimpl.h"
 #include "aux/eigensupport.h"
 #include <range/v3/view/cartesian_product.hpp>
 #include <range/v3/range/conversion.hpp>
 #include <range/v3/algorithm/for_each.hpp>
+#include <doctest/doctest.h>
 
 namespace Faunus {
 namespace Move {
@@ -35,6 +37,69 @@ void to_json(json &j, const ClusterShapeAnalysis &shape) {
     }
 }
 
+/**
+ * Groups are stored by index under their mass center. The cell length is at least the
+ * largest cluster threshold whereby all groups within the threshold of a given point
+ * are found in the 27 surrounding cells. The grid is kept between searches and only
+ * groups that changed cell are moved; it must be recreated if the box changes.
+ */
+struct FindCluster::MassCenterGrid {
+    using CellListType =
+        CellList::CellListSpatial<CellList::CellListType<size_t, CellList::Grid::Grid3DPeriodic, CellList::CellListBase,
+                                                         CellList::Container::SparseContainer>>;
+    using CellCoord = typename CellListType::Grid::CellCoord;
+    CellListType cell_list;
+    const Point box;      //!< Box dimensions that the grid was built for
+    const Point half_box; //!< Shifts positions to the [0, box) range of the cell list
+    std::vector<CellCoord> cell_offsets;
+    std::vector<size_t> members; //!< Sorted index of groups in the grid
+
+    MassCenterGrid(const Point& box, double cell_length)
+        : cell_list(box, cell_length), box(box), half_box(0.5 * box) {
+        for (auto i = -1; i <= 1; ++i) {
+            for (auto j = -1; j <= 1; ++j) {
+                for (auto k = -1; k <= 1; ++k) {
+                    cell_offsets.emplace_back(i, j, k);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Set grid members to the given groups at their current mass centers
+     * @param group_indices Sorted index of groups to keep in the grid
+     * @param groups All groups in the system
+     */
+    void update(const std::vector<size_t>& group_indices, const Space::GroupVector& groups) {
+        for (const auto group_index : members) {
+            if (!std::binary_search(group_indices.begin(), group_indices.end(), group_index)) {
+                cell_list.removeMember(group_index);
+            }
+        }
+        for (const auto group_index : group_indices) {
+            const Point position = groups[group_index].mass_center + half_box;
+            if (std::binary_search(members.begin(), members.end(), group_index)) {
+                cell_list.updateMemberAt(group_index, position);
+            } else {
+                cell_list.insertMember(group_index, position);
+            }
+        }
+        members.assign(group_indices.begin(), group_indices.end());
+    }
+
+    //! Call `function` with the index of all groups in the cells surrounding `position`
+    template <typename Function> void forEachNeighbor(const Point& position, Function function) {
+        const auto center_cell = cell_list.getGrid().coordinatesAt(position + half_box);
+        for (const auto& offset : cell_offsets) {
+            for (const auto group_index : cell_list.getNeighborMembers(center_cell, offset)) {
+                function(group_index);
+            }
+        }
+    }
+};
+
+FindCluster::~FindCluster() = default;
+
 FindCluster::FindCluster(const Space& spc, const json& j)
     : spc(spc) {
     single_layer = j.value("single_layer", false);
@@ -50,6 +115,12 @@ FindCluster::FindCluster(const Space& spc, const json& j)
     // read satellite ids (molecules NOT to be considered as cluster centers)
     registerSatellites(j.value("satellites", std::vector<std::string>()));
     parseThresholds(j.at("threshold"));
+
+    for (auto [id1, id2] : ranges::views::cartesian_product(molids, molids)) {
+        max_threshold = std::max(max_threshold, std::sqrt(thresholds_squared(id1, id2)));
+    }
+    const auto periodic_dimensions = spc.geometry.asSimpleGeometry()->boundary_conditions.isPeriodic().count();
+    use_cell_list = use_mass_center_threshold && periodic_dimensions == 3 && max_threshold > 0.0;
 }
 
 double FindCluster::clusterProbability(const Group& group1, const Group& group2) const {
@@ -154,56 +225,150 @@ std::optional<size_t> FindCluster::findSeed(Random &random) {
     return *random.sample(not_satellites.begin(), not_satellites.end());
 }
 
+/**
+ * Marks all groups in `molecule_index` as candidates and, if enabled, updates their
+ * cells in the cell list as mass centers may have changed since the previous search.
+ * The cell list is rebuilt only if the box dimensions have changed.
+ */
+void FindCluster::updateCandidates() {
+    in_pool.assign(spc.groups.size(), false);
+    for (const auto index : molecule_index) {
+        in_pool[index] = true;
+    }
+    if (use_cell_list) {
+        if (!mass_center_grid || mass_center_grid->box != spc.geometry.getLength()) {
+            mass_center_grid = std::make_unique<MassCenterGrid>(spc.geometry.getLength(), max_threshold);
+        }
+        mass_center_grid->update(molecule_index, spc.groups);
+    }
+}
+
 /**
  * Find cluster
  *
+ * For mass center thresholds in periodic boxes, only groups in cells surrounding each
+ * cluster member are tested; otherwise all remaining candidates are tested.
+ * Since the cluster probability is currently either zero or one, random numbers
+ * are drawn only for intermediate probabilities.
+ *
  * @param seed_index Index of seed_index group to evaluate the cluster around
  * @returns Pair w. vector for group indices in cluster and a bool if the cluster
  *          can be safely rotated in a PBC environment
  */
 std::pair<std::vector<size_t>, bool> FindCluster::findCluster(size_t seed_index) {
-    namespace rv = ranges::cpp20::views;
-    assert(seed_index < spc.particles.size());
-    std::set<size_t> pool(molecule_index.begin(), molecule_index.end()); // decreasing pool of candidate groups
-    assert(pool.count(seed_index) == 1);
+    assert(seed_index < spc.groups.size());
+    updateCandidates();
+    assert(in_pool.at(seed_index));
 
     std::vector<size_t> cluster;            // molecular index
     cluster.reserve(molecule_index.size()); // ensures safe resizing without invalidating iterators
     cluster.push_back(seed_index);          // 'seed_index' is the index of the seed molecule
-    pool.erase(seed_index);                 // ...which is already in the cluster and not part of pool
+    in_pool[seed_index] = false;            // ...which is already in the cluster and not part of pool
 
     // cluster search algorithm
-    for (auto it1 = cluster.begin(); it1 != cluster.end(); it1++) {
-        for (auto it2 = pool.begin(); it2 != pool.end();) {
-            const auto p = clusterProbability(spc.groups.at(*it1), spc.groups.at(*it2)); // probability to cluster
-            if (MoveBase::slump() <= p) {                                                // is group part of cluster?
-                cluster.push_back(*it2);                                                 // yes, expand cluster...
-                it2 = pool.erase(it2);                                                   // ...and remove from pool
-            } else {
-                ++it2; // not part of cluster, move along to next group in pool
+    for (size_t i = 0; i < cluster.size(); ++i) {
+        const auto& group1 = spc.groups.at(cluster[i]);
+        auto add_if_clustering = [&](const size_t index) {
+            if (in_pool[index]) {
+                const auto p = clusterProbability(group1, spc.groups[index]); // probability to cluster
+                if (p >= 1.0 || (p > 0.0 && MoveBase::slump() <= p)) {       // is group part of cluster?
+                    cluster.push_back(index);                                 // yes, expand cluster...
+                    in_pool[index] = false;                                   // ...and remove from pool
+                }
             }
+        };
+        if (mass_center_grid) {
+            mass_center_grid->forEachNeighbor(group1.mass_center, add_if_clustering);
+        } else {
+            std::for_each(molecule_index.begin(), molecule_index.end(), add_if_clustering);
         }
         if (single_layer) { // stop after one iteration around 'seed_index'
             break;
         }
     }
     std::sort(cluster.begin(), cluster.end()); // required for correct energy evaluation
+    assert(std::adjacent_find(cluster.begin(), cluster.end()) == cluster.end()); // check for duplicates
+    const auto safe_to_rotate = isSafeToRotate(cluster);
+    return {cluster, safe_to_rotate};
+}
 
-    // check if cluster is too large to be rotated (larger than half the box length)
-    auto mass_centers = cluster | rv::transform([&](auto i) -> const Point& { return spc.groups.at(i).mass_center; });
+/**
+ * Check if cluster is too large to be rotated, i.e. if any two mass centers are separated
+ * by more than half the shortest box length.
+ */
+bool FindCluster::isSafeToRotate(const std::vector<size_t>& cluster) const {
     const auto max = 0.5 * spc.geometry.getLength().minCoeff();
-    bool safe_to_rotate = true;
-    for (auto i = mass_centers.begin(); i != mass_centers.end(); ++i) {
-        for (auto j = i; ++j != mass_centers.end();) {
-            if (spc.geometry.sqdist(*i, *j) < max * max) {
-                continue;
+    const auto max_squared = max * max;
+    for (auto i = cluster.begin(); i != cluster.end(); ++i) {
+        const auto& mass_center = spc.groups[*i].mass_center;
+        for (auto j = std::next(i); j != cluster.end(); ++j) {
+            if (spc.geometry.sqdist(mass_center, spc.groups[*j].mass_center) >= max_squared) {
+                return false;
             }
-            safe_to_rotate = false;
-            break;
         }
     }
-    assert(std::adjacent_find(cluster.begin(), cluster.end()) == cluster.end()); // check for duplicates
-    return {cluster, safe_to_rotate};
+    return true;
+}
+
+TEST_CASE("[Faunus] FindCluster - cell list") {
+    const auto original_atoms = Faunus::atoms;
+    const auto original_molecules = Faunus::molecules;
+    auto input = R"({
+        "atomlist": [{"A": {"sigma": 1.0}}],
+        "moleculelist": [{"M": {"structure": [{"A": [0.0, 0.0, 0.0]}]}}],
+        "insertmolecules": [{"M": {"N": 60}}],
+        "geometry": {"type": "cuboid", "length": 20}
+    })"_json;
+    Faunus::atoms = input["atomlist"].get<decltype(Faunus::atoms)>();
+    Faunus::molecules = input["moleculelist"].get<decltype(Faunus::molecules)>();
+    Space spc(input);
+    Random random;
+
+    auto randomize_positions = [&] {
+        for (auto& group : spc.groups) {
+            spc.geometry.randompos(group.begin()->pos, random);
+            group.mass_center = group.begin()->pos;
+        }
+        // a pair that only clusters across the periodic boundary
+        const Point near_boundary = 0.5 * spc.geometry.getLength() - Point(0.1, 0.0, 0.0);
+        spc.groups[0].mass_center = spc.groups[0].begin()->pos = near_boundary;
+        spc.groups[1].mass_center = spc.groups[1].begin()->pos = -near_boundary;
+    };
+    auto linear_scan = [&](size_t seed_index, double threshold) {
+        std::vector<size_t> cluster = {seed_index};
+        std::vector<bool> in_cluster(spc.groups.size(), false);
+        in_cluster[seed_index] = true;
+        for (size_t i = 0; i < cluster.size(); ++i) {
+            for (size_t j = 0; j < spc.groups.size(); ++j) {
+                const auto distance_squared = spc.geometry.sqdist(spc.groups[cluster[i]].mass_center,
+                                                                  spc.groups[j].mass_center);
+                if (!in_cluster[j] && distance_squared <= threshold * threshold) {
+                    in_cluster[j] = true;
+                    cluster.push_back(j);
+                }
+            }
+        }
+        std::sort(cluster.begin(), cluster.end());
+        return cluster;
+    };
+
+    // thresholds around the cell length (20 / 4 Å) and with less than three cells per dimension
+    for (const auto threshold : {4.999, 5.0, 5.001, 7.0, 10.5}) {
+        FindCluster find_cluster(spc, {{"molecules", {"M"}}, {"threshold", threshold}});
+        for (int configuration = 0; configuration < 5; ++configuration) {
+            if (configuration == 3) {
+                spc.geometry.setVolume(std::pow(22.0, 3)); // the grid must be rebuilt
+            }
+            randomize_positions();
+            CHECK(find_cluster.findCluster(0).first == linear_scan(0, threshold));
+            for (const auto seed_index : {7UL, 23UL, 59UL}) {
+                CHECK(find_cluster.findCluster(seed_index).first == linear_scan(seed_index, threshold));
+            }
+        }
+        spc.geometry.setVolume(std::pow(20.0, 3));
+    }
+    Faunus::atoms = original_atoms;
+    Faunus::molecules = original_molecules;
 }
 
 void to_json(json &j, const FindCluster &cluster) {
@@ -88,18 +88,25 @@ void to_json(json &j, const ClusterShapeAnalysis &shape);
  */
 class FindCluster {
   private:
+    struct MassCenterGrid; //!< Cell list with mass centers of candidate groups
     const Space& spc;
     bool use_mass_center_threshold = true;   //!< use distance threshold between mass-centers instead of particles
     bool single_layer = false;               //!< stop cluster search after first layer of neighbors
+    bool use_cell_list = false;              //!< search neighbors using `mass_center_grid`
     std::vector<std::string> molecule_names; //!< names of molecules to be considered
     std::vector<int> molids;                 //!< molecule id's of molecules to be considered (must be sorted!)
     std::set<int> satellites; //!< subset of molecule id's to cluster, but NOT act as nuclei (cluster centers)
     PairMatrix<double, true> thresholds_squared; //!< Cluster thresholds for pairs of groups
+    double max_threshold = 0.0;                  //!< Largest cluster threshold
+    std::vector<bool> in_pool;                   //!< Flags groups that can still join the cluster being searched
+    std::unique_ptr<MassCenterGrid> mass_center_grid; //!< Spatial index of candidate groups
 
     void parseThresholds(const json &j); //!< Read thresholds from json input
     double clusterProbability(const Group& group1, const Group& group2) const;
     void registerSatellites(const std::vector<std::string> &); //!< Register satellites
     void updateMoleculeIndex();                                //!< update `molecule_index`
+    void updateCandidates();                                   //!< Reset `in_pool` and `mass_center_grid`
+    bool isSafeToRotate(const std::vector<size_t>& cluster) const; //!< All mass centers closer than half box?
     friend void to_json(json &j, const FindCluster &cluster);
 
   public:
@@ -107,6 +114,7 @@ class FindCluster {
     std::optional<size_t> findSeed(Random &random); //!< Find first group; exclude satellites
     std::pair<std::vector<size_t>, bool> findCluster(size_t seed_index); //!< Find cluster
     FindCluster(const Space& spc, const json& j);
+    ~FindCluster(); //!< Required due to unique_ptr to incomplete type
 };
 
 void to_json(json &j, const FindCluster &cluster); //!< Serialize to json
@@ -6,6 +6,9 @@
 #include "random.h"
 #include "particle.h"
 #include <stdexcept>
+#include <atomic>
+#include <cstdlib>
+#include <new>
 #include <iomanip>
 #include <fstream>
 #include <spdlog/spdlog.h>
@@ -122,6 +125,15 @@ TipFromTheManual usageTip; // Global instance
 std::shared_ptr<spdlog::logger> faunus_logger = spdlog::create<spdlog::sinks::null_sink_st>("null");
 std::shared_ptr<spdlog::logger> mcloop_logger = faunus_logger;
 
+#ifdef FAUNUS_COUNT_ALLOCATIONS
+namespace {
+std::atomic<std::size_t> number_of_heap_allocations{0}; //!< Incremented by the global `operator new`
+}
+std::size_t heapAllocationCount() { return number_of_heap_allocations.load(std::memory_order_relaxed); }
+#else
+std::size_t heapAllocationCount() { return 0; }
+#endif
+
 std::string addGrowingSuffix(const std::string& file) {
     // using std::experimental::filesystem; // exp. c++17 feature, not available on MacOS (Dec. 2018)
     int cnt = 0;
@@ -438,3 +450,16 @@ void to_json(json& j, const Electrolyte& electrolyte) {
 } // namespace Faunus
 
 template class nlohmann::basic_json<>;
+
+#ifdef FAUNUS_COUNT_ALLOCATIONS
+// Replaced global allocation functions. Array and nothrow versions forward to these by default.
+void* operator new(std::size_t size) {
+    Faunus::number_of_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
@@ -162,6 +162,14 @@ Point rtp2xyz(const Point& rtp, const Point& origin = {0, 0, 0});
 
 std::string addGrowingSuffix(const std::string&); //!< Add growing suffix filename until non-existing name is found
 
+/**
+ * @brief Number of global `operator new` calls since program start (all threads)
+ *
+ * Counting is a debugging aid enabled by the CMake option `ENABLE_ALLOCATION_COUNTER` which
+ * replaces the global allocation operators. Otherwise zero is always returned.
+ */
+std::size_t heapAllocationCount();
+
 Point randomUnitVector(
     Random& rand,
     const Point& directions = Point::Ones()); //!< Random unit vector using Neuman's method ("sphere picking")
@@ -197,11 +197,7 @@ void PolicyIonIon::updateComplex(EwaldData& d, const Change& change, const Space
         for (auto &changed_group : change.groups) {
             auto& g_new = groups.at(changed_group.group_index);
             auto& g_old = oldgroups.at(changed_group.group_index);
-            const auto max_group_size = std::max(g_new.size(), g_old.size());
-            auto indices = (changed_group.all) ? ranges::cpp20::views::iota(0u, max_group_size) |
-                                                     ranges::to<std::vector<Change::index_type>>
-                                               : changed_group.relative_atom_indices;
-            for (auto i : indices) {
+            auto update = [&](const auto i) {
                 if (i < g_new.size()) {
                     double qr = q.dot(g_new[i].pos);
                     Q += g_new[i].charge * EwaldData::Tcomplex(std::cos(qr), std::sin(qr));
@@ -210,6 +206,17 @@ void PolicyIonIon::updateComplex(EwaldData& d, const Change& change, const Space
                     double qr = q.dot(g_old[i].pos);
                     Q -= g_old[i].charge * EwaldData::Tcomplex(std::cos(qr), std::sin(qr));
                 }
+            };
+            // iterate in place; materializing an index vector would allocate for every k-vector
+            if (changed_group.all) {
+                const auto max_group_size = std::max(g_new.size(), g_old.size());
+                for (size_t i = 0; i < max_group_size; ++i) {
+                    update(i);
+                }
+            } else {
+                for (const auto i : changed_group.relative_atom_indices) {
+                    update(i);
+                }
             }
         }
     }
@@ -227,6 +234,7 @@ TEST_CASE("[Faunus] Ewald - IonIonPolicy") {
     }
     Group g(0, spc.particles.begin(), spc.particles.end());
     spc.groups.push_back(g);
+    spc.updateMoleculeLookup();
 
     auto data = static_cast<EwaldData>(R"({
                 "epsr": 1.0, "alpha": 0.894427190999916, "epss": 1.0,
@@ -285,6 +293,7 @@ TEST_CASE("[Faunus] Ewald - IonIonPolicy Benchmarks") {
     }
     Group g(0, spc.particles.begin(), spc.particles.end());
     spc.groups.push_back(g);
+    spc.updateMoleculeLookup();
 
     EwaldData data(R"({
                 "epsr": 1.0, "alpha": 0.894427190999916, "epss": 1.0,
@@ -687,6 +696,8 @@ void Example2D::to_json(json &j) const {
     j["2D"] = use_2d;
 }
 
+double ContainerOverlap::minimumEnergy() const { return 0.0; }
+
 double ContainerOverlap::energy(const Change& change) {
     if (change && spc.geometry.type != Geometry::Variant::CUBOID) { // no need to check in PBC systems
         // *all* groups
@@ -819,12 +830,286 @@ double Constrain::energy(const Change& change) {
     }
     return 0.0;
 }
+double Constrain::minimumEnergy() const { return 0.0; }
+
 void Constrain::to_json(json &j) const {
     j = json(*coordinate).at(type);
     j.erase("resolution");
     j["type"] = type;
 }
 
+/**
+ * @param bonds Bonds with absolute particle indices
+ * @param first_particle_index Absolute index of first particle to include
+ * @param number_of_particles Number of particles to include
+ * @throw If a bond involves a particle outside the given range
+ */
+void BondAdjacency::build(const BasePointerVector<Potential::BondData>& bonds, const std::size_t first_particle_index,
+                          const std::size_t number_of_particles) {
+    this->first_particle_index = first_particle_index;
+    auto to_local_index = [&](const int index) {
+        const auto local_index = static_cast<std::size_t>(index) - first_particle_index;
+        if (index < 0 || static_cast<std::size_t>(index) < first_particle_index || local_index >= number_of_particles) {
+            throw std::out_of_range(fmt::format("bond index {} outside particle range", index));
+        }
+        return local_index;
+    };
+    offsets.assign(number_of_particles + 1, 0);
+    for (const auto& bond : bonds) { // count bonds per particle
+        for (const auto index : bond->indices) {
+            offsets[to_local_index(index) + 1]++;
+        }
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    bond_indices.resize(offsets.back());
+    auto next_position = offsets;
+    for (std::size_t bond_index = 0; bond_index < bonds.size(); ++bond_index) {
+        for (const auto index : bonds.at(bond_index)->indices) {
+            bond_indices[next_position[to_local_index(index)]++] = bond_index;
+        }
+    }
+}
+
+/**
+ * Particles outside the range of the lookup table have no bonds.
+ * The same bond may be appended multiple times if it involves the particle several times.
+ */
+void BondAdjacency::appendBondsOf(const std::size_t particle_index, std::vector<std::size_t>& target) const {
+    if (particle_index >= first_particle_index && particle_index - first_particle_index + 1 < offsets.size()) {
+        const auto local_index = particle_index - first_particle_index;
+        target.insert(target.end(), bond_indices.begin() + offsets[local_index],
+                      bond_indices.begin() + offsets[local_index + 1]);
+    }
+}
+
+TEST_CASE("[Faunus] BondAdjacency") {
+    using namespace Potential;
+    BasePointerVector<BondData> bonds;
+    bonds.push_back(std::make_shared<HarmonicBond>(1.0, 1.0, std::vector<int>{2, 3}));
+    bonds.push_back(std::make_shared<HarmonicBond>(1.0, 1.0, std::vector<int>{3, 4}));
+    bonds.push_back(std::make_shared<HarmonicTorsion>(1.0, 1.0, std::vector<int>{2, 3, 5}));
+    BondAdjacency adjacency;
+    adjacency.build(bonds, 2, 4);
+    CHECK(adjacency.offsets == std::vector<std::size_t>{0, 2, 5, 6, 7});
+    std::vector<std::size_t> found;
+    adjacency.appendBondsOf(3, found);
+    CHECK(found == std::vector<std::size_t>{0, 1, 2});
+    found.clear();
+    adjacency.appendBondsOf(5, found);
+    CHECK(found == std::vector<std::size_t>{2});
+    found.clear();
+    adjacency.appendBondsOf(1, found); // outside range
+    adjacency.appendBondsOf(6, found); // outside range
+    CHECK(found.empty());
+    CHECK_THROWS(adjacency.build(bonds, 3, 3));
+}
+
+void PackedBonds::pack(const BasePointerVector<Potential::BondData>& bonds) {
+    using namespace Potential;
+    *this = PackedBonds();
+    for (const auto& bond : bonds) {
+        const auto& index = bond->indices;
+        switch (bond->type()) {
+        case BondData::Variant::HARMONIC: {
+            const auto& harmonic_bond = dynamic_cast<const HarmonicBond&>(*bond);
+            harmonic.indices.push_back({index[0], index[1]});
+            harmonic.half_force_constant.push_back(harmonic_bond.half_force_constant);
+            harmonic.equilibrium_distance.push_back(harmonic_bond.equilibrium_distance);
+            break;
+        }
+        case BondData::Variant::FENE: {
+            const auto& fene_bond = dynamic_cast<const FENEBond&>(*bond);
+            fene.indices.push_back({index[0], index[1]});
+            fene.half_force_constant.push_back(fene_bond.half_force_constant);
+            fene.max_squared_distance.push_back(fene_bond.max_squared_distance);
+            break;
+        }
+        case BondData::Variant::FENEWCA: {
+            const auto& fene_wca_bond = dynamic_cast<const FENEWCABond&>(*bond);
+            fene_wca.indices.push_back({index[0], index[1]});
+            fene_wca.half_force_constant.push_back(fene_wca_bond.half_force_constant);
+            fene_wca.max_squared_distance.push_back(fene_wca_bond.max_distance_squared);
+            fene_wca.epsilon.push_back(fene_wca_bond.epsilon);
+            fene_wca.sigma_squared.push_back(fene_wca_bond.sigma_squared);
+            unpacked_force_bonds.push_back(bond);
+            break;
+        }
+        case BondData::Variant::HARMONIC_TORSION: {
+            const auto& torsion = dynamic_cast<const HarmonicTorsion&>(*bond);
+            harmonic_torsions.indices.push_back({index[0], index[1], index[2]});
+            harmonic_torsions.half_force_constant.push_back(torsion.half_force_constant);
+            harmonic_torsions.equilibrium_angle.push_back(torsion.equilibrium_angle);
+            unpacked_force_bonds.push_back(bond);
+            break;
+        }
+        case BondData::Variant::PERIODIC_DIHEDRAL: {
+            const auto& dihedral = dynamic_cast<const PeriodicDihedral&>(*bond);
+            periodic_dihedrals.indices.push_back({index[0], index[1], index[2], index[3]});
+            periodic_dihedrals.force_constant.push_back(dihedral.force_constant);
+            periodic_dihedrals.phase_angle.push_back(dihedral.phase_angle);
+            periodic_dihedrals.periodicity.push_back(dihedral.periodicity);
+            unpacked_force_bonds.push_back(bond);
+            break;
+        }
+        default:
+            unpacked_bonds.push_back(bond);
+            unpacked_force_bonds.push_back(bond);
+        }
+    }
+}
+
+/**
+ * The expressions are identical to those in the `energyFunc` functors of the respective bond types.
+ * @return Bond energy (kT); infinity if a FENE bond is stretched beyond its maximum length
+ */
+double PackedBonds::energy(const Space::GeometryType& geometry, const ParticleVector& particles) const {
+    double energy = 0.0;
+    for (std::size_t i = 0; i < harmonic.indices.size(); ++i) {
+        const auto& [a, b] = harmonic.indices[i];
+        const auto distance =
+            harmonic.equilibrium_distance[i] - geometry.vdist(particles[a].pos, particles[b].pos).norm();
+        energy += harmonic.half_force_constant[i] * distance * distance;
+    }
+    for (std::size_t i = 0; i < fene.indices.size(); ++i) {
+        const auto& [a, b] = fene.indices[i];
+        const auto squared_distance = geometry.vdist(particles[a].pos, particles[b].pos).squaredNorm();
+        const auto max_squared_distance = fene.max_squared_distance[i];
+        if (squared_distance >= max_squared_distance) {
+            return pc::infty;
+        }
+        energy -= fene.half_force_constant[i] * max_squared_distance * std::log(1.0 - squared_distance / max_squared_distance);
+    }
+    for (std::size_t i = 0; i < fene_wca.indices.size(); ++i) {
+        constexpr auto two_to_the_power_of_two_sixths = 1.01944064370214482816981563263103378007648819; // 2^((1/6)^2)
+        const auto& [a, b] = fene_wca.indices[i];
+        const auto squared_distance = geometry.vdist(particles[a].pos, particles[b].pos).squaredNorm();
+        const auto max_squared_distance = fene_wca.max_squared_distance[i];
+        if (squared_distance > max_squared_distance) {
+            return pc::infty;
+        }
+        double wca = 0.0;
+        if (squared_distance <= fene_wca.sigma_squared[i] * two_to_the_power_of_two_sixths) {
+            auto sigma6 = fene_wca.sigma_squared[i] / squared_distance;
+            sigma6 = sigma6 * sigma6 * sigma6;
+            wca = fene_wca.epsilon[i] * (sigma6 * sigma6 - sigma6 + 0.25);
+        }
+        energy += -fene_wca.half_force_constant[i] * max_squared_distance *
+                      std::log(1.0 - squared_distance / max_squared_distance) +
+                  wca;
+    }
+    for (std::size_t i = 0; i < harmonic_torsions.indices.size(); ++i) {
+        const auto& [a, b, c] = harmonic_torsions.indices[i];
+        const auto vec1 = geometry.vdist(particles[a].pos, particles[b].pos).normalized();
+        const auto vec2 = geometry.vdist(particles[c].pos, particles[b].pos).normalized();
+        const auto delta_angle = harmonic_torsions.equilibrium_angle[i] - std::acos(vec1.dot(vec2));
+        energy += harmonic_torsions.half_force_constant[i] * delta_angle * delta_angle;
+    }
+    for (std::size_t i = 0; i < periodic_dihedrals.indices.size(); ++i) {
+        const auto& [a, b, c, d] = periodic_dihedrals.indices[i];
+        const Point ab = geometry.vdist(particles[b].pos, particles[a].pos); // a->b
+        const Point bc = geometry.vdist(particles[c].pos, particles[b].pos); // b->c
+        const Point cd = geometry.vdist(particles[d].pos, particles[c].pos); // c->d
+        const Point normal_abc = ab.cross(bc);
+        const Point normal_bcd = bc.cross(cd);
+        const auto dihedral_angle =
+            std::atan2((normal_abc.cross(normal_bcd)).dot(bc) / bc.norm(), normal_abc.dot(normal_bcd));
+        energy += periodic_dihedrals.force_constant[i] *
+                  (1.0 + std::cos(periodic_dihedrals.periodicity[i] * dihedral_angle - periodic_dihedrals.phase_angle[i]));
+    }
+    if (!unpacked_bonds.empty()) {
+        const auto distance_function = geometry.getDistanceFunc();
+        for (const auto& bond : unpacked_bonds) {
+            energy += bond->energyFunc(distance_function);
+        }
+    }
+    return energy;
+}
+
+/**
+ * @param geometry Geometry used for minimum image distances
+ * @param particles Particles referred to by the bond indices
+ * @param forces Target force vector for *all* particles to which the bond forces are added
+ * @throw If a bond has no force function, or if a FENE bond is stretched beyond its maximum length
+ */
+void PackedBonds::force(const Space::GeometryType& geometry, const ParticleVector& particles,
+                        std::vector<Point>& forces) const {
+    for (std::size_t i = 0; i < harmonic.indices.size(); ++i) {
+        const auto& [a, b] = harmonic.indices[i];
+        const Point distance_vector = geometry.vdist(particles[a].pos, particles[b].pos);
+        const auto distance = distance_vector.norm();
+        const Point force = 2.0 * harmonic.half_force_constant[i] * (harmonic.equilibrium_distance[i] - distance) *
+                            distance_vector / distance;
+        forces.at(a) += force;
+        forces.at(b) -= force;
+    }
+    for (std::size_t i = 0; i < fene.indices.size(); ++i) {
+        const auto& [a, b] = fene.indices[i];
+        const Point ba = geometry.vdist(particles[a].pos, particles[b].pos); // b->a
+        const auto squared_distance = ba.squaredNorm();
+        const auto max_squared_distance = fene.max_squared_distance[i];
+        if (squared_distance >= max_squared_distance) {
+            throw std::runtime_error("Fene potential: Force undefined for distances greater than rmax.");
+        }
+        const auto force_magnitude =
+            -2.0 * fene.half_force_constant[i] * ba.norm() / (1.0 - squared_distance / max_squared_distance);
+        const Point force = force_magnitude * ba.normalized();
+        forces.at(a) += force;
+        forces.at(b) -= force;
+    }
+    if (!unpacked_force_bonds.empty()) {
+        const auto distance_function = geometry.getDistanceFunc();
+        for (const auto& bond : unpacked_force_bonds) {
+            if (!bond->hasForceFunction()) {
+                throw std::runtime_error("force not implemented!");
+            }
+            for (const auto& [index, force] : bond->forceFunc(distance_function)) {
+                forces.at(index) += force;
+            }
+        }
+    }
+}
+
+TEST_CASE("[Faunus] PackedBonds") {
+    using namespace Potential;
+    using doctest::Approx;
+    Geometry::Chameleon geometry = R"( {"type": "cuboid", "length": 10} )"_json;
+    ParticleVector particles(4);
+    particles[0].pos = {0.0, 0.0, 0.0};
+    particles[1].pos = {1.1, 0.0, 0.0};
+    particles[2].pos = {1.2, 0.9, 0.1};
+    particles[3].pos = {1.0, 1.3, 1.2};
+    BasePointerVector<BondData> bonds;
+    bonds.push_back(std::make_shared<HarmonicBond>(100.0, 1.0, std::vector<int>{0, 1}));
+    bonds.push_back(std::make_shared<FENEBond>(10.0, 2.0, std::vector<int>{1, 2}));
+    bonds.push_back(std::make_shared<FENEWCABond>(10.0, 2.0, 1.0, 1.0, std::vector<int>{2, 3}));
+    bonds.push_back(std::make_shared<HarmonicTorsion>(5.0, 1.5, std::vector<int>{0, 1, 2}));
+    bonds.push_back(std::make_shared<GromosTorsion>(5.0, 0.1, std::vector<int>{1, 2, 3}));
+    bonds.push_back(std::make_shared<PeriodicDihedral>(2.0, 0.3, 3.0, std::vector<int>{0, 1, 2, 3}));
+    std::for_each(bonds.begin(), bonds.end(), [&](auto& bond) { bond->setEnergyFunction(particles); });
+
+    PackedBonds packed;
+    packed.pack(bonds);
+    const auto distance_function = geometry.getDistanceFunc();
+    auto reference_energy = 0.0;
+    std::vector<Point> reference_forces(particles.size(), Point::Zero());
+    for (const auto& bond : bonds) {
+        reference_energy += bond->energyFunc(distance_function);
+        for (const auto& [index, force] : bond->forceFunc(distance_function)) {
+            reference_forces.at(index) += force;
+        }
+    }
+    CHECK(packed.energy(geometry, particles) == Approx(reference_energy));
+
+    std::vector<Point> forces(particles.size(), Point::Zero());
+    packed.force(geometry, particles, forces);
+    for (std::size_t i = 0; i < forces.size(); ++i) {
+        CHECK((forces[i] - reference_forces[i]).norm() == Approx(0.0));
+    }
+
+    particles[2].pos = {4.0, 0.0, 0.0}; // stretch FENE bond beyond maximum distance
+    CHECK(std::isinf(packed.energy(geometry, particles)));
+}
+
 void Bonded::updateGroupBonds(const Space::GroupType& group) {
     const auto first_particle_index = spc.getFirstParticleIndex(group);
     const auto group_index = spc.getGroupIndex(group);
@@ -834,29 +1119,21 @@ void Bonded::updateGroupBonds(const Space::GroupType& group) {
         bond->shiftIndices(first_particle_index); // shift to absolute particle index
         bond->setEnergyFunction(spc.particles);
     }
+    internal_adjacency[group_index].build(bonds, first_particle_index, group.capacity());
+    internal_packed[group_index].pack(bonds);
 }
 
 /**
- * Ensures that all internal bonds are updated according to bonds defined in the topology.
+ * Ensures that all internal bonds and their particle lookup tables are updated
+ * according to bonds defined in the topology.
  */
 void Bonded::updateInternalBonds() {
     internal_bonds.clear();
+    internal_adjacency.clear();
+    internal_packed.clear();
     std::for_each(spc.groups.begin(), spc.groups.end(), [&](auto& group) { updateGroupBonds(group); });
 }
 
-double Bonded::sumBondEnergy(const Bonded::BondVector& bonds) const {
-#if (defined(__clang__) && __clang_major__ >= 10) || (defined(__GNUC__) && __GNUC__ >= 10)
-    auto bond_energy = [&](const auto& bond) { return bond->energyFunc(spc.geometry.getDistanceFunc()); };
-    return std::transform_reduce(bonds.begin(), bonds.end(), 0.0, std::plus<>(), bond_energy);
-#else
-    double energy = 0.0;
-    for (const auto& bond : bonds) {
-        energy += bond->energyFunc(spc.geometry.getDistanceFunc());
-    }
-    return energy;
-#endif
-}
-
 Bonded::Bonded(const Space& spc, const BondVector& external_bonds = BondVector())
     : spc(spc), external_bonds(external_bonds) {
     name = "bonded";
@@ -864,6 +1141,8 @@ Bonded::Bonded(const Space& spc, const BondVector& external_bonds = BondVector()
     for (auto& bond : this->external_bonds) {
         bond->setEnergyFunction(spc.particles);
     }
+    external_adjacency.build(this->external_bonds, 0, spc.particles.size());
+    external_packed.pack(this->external_bonds);
 }
 
 Bonded::Bonded(const json& j, const Space& spc) : Bonded(spc, j.value("bondlist", BondVector())) {}
@@ -883,14 +1162,15 @@ void Bonded::to_json(json& j) const {
 double Bonded::energy(const Change& change) {
     double energy = 0.0;
     if (change) {
-        energy += sumBondEnergy(external_bonds);
         if (change.everything || change.volume_change) { // calc. for everything!
-            for (const auto& [group_index, bonds] : internal_bonds) {
+            energy += external_packed.energy(spc.geometry, spc.particles);
+            for (const auto& [group_index, bonds] : internal_packed) {
                 if (!spc.groups.at(group_index).empty()) {
-                    energy += sumBondEnergy(bonds);
+                    energy += bonds.energy(spc.geometry, spc.particles);
                 }
             }
         } else { // calc. for a subset of groups
+            energy += externalEnergy(change);
             for (const auto& group_change : change.groups) {
                 energy += internalGroupEnergy(group_change);
             }
@@ -899,6 +1179,40 @@ double Bonded::energy(const Change& change) {
     return energy;
 }
 
+/**
+ * Only inter-molecular bonds involving changed particles are included, whereby the
+ * returned energy differs from the total inter-molecular bond energy by a constant
+ * that cancels in energy differences. All particles (also inactive) in groups with
+ * `all` set are considered changed.
+ */
+double Bonded::externalEnergy(const Change& change) {
+    if (external_bonds.empty()) {
+        return 0.0;
+    }
+    changed_particle_indices.clear();
+    for (const auto& group_change : change.groups) {
+        const auto& group = spc.groups.at(group_change.group_index);
+        if (group.capacity() == 0) {
+            continue;
+        }
+        const auto first_particle_index = spc.getFirstParticleIndex(group);
+        if (group_change.all) {
+            for (std::size_t i = 0; i < group.capacity(); ++i) {
+                changed_particle_indices.push_back(first_particle_index + i);
+            }
+        } else {
+            for (const auto i : group_change.relative_atom_indices) {
+                changed_particle_indices.push_back(first_particle_index + i);
+            }
+        }
+    }
+    return sumEnergy(external_bonds, external_adjacency, changed_particle_indices);
+}
+
+/**
+ * For partial updates of rigidly moved segments (`Change::GroupChange::rigid_segment`),
+ * bonds entirely within the segment are skipped as their energy is unchanged.
+ */
 double Bonded::internalGroupEnergy(const Change::GroupChange& changed) {
     using namespace ranges::cpp20::views; // @todo cpp20 --> std::ranges
     double energy = 0.0;
@@ -906,12 +1220,13 @@ double Bonded::internalGroupEnergy(const Change::GroupChange& changed) {
     if (changed.internal && !group.empty()) {
         const auto& bonds = internal_bonds.at(changed.group_index);
         if (changed.all) { // all internal positions updated
-            energy += sumBondEnergy(bonds);
+            energy += internal_packed.at(changed.group_index).energy(spc.geometry, spc.particles);
         } else { // only partial update of affected atoms
             const auto first_particle_index = spc.getFirstParticleIndex(group);
             auto particle_indices = changed.relative_atom_indices |
                                     transform([first_particle_index](auto i) { return i + first_particle_index; });
-            energy += sumEnergy(bonds, particle_indices);
+            energy += sumEnergy(bonds, internal_adjacency.at(changed.group_index), particle_indices,
+                                changed.rigid_segment);
         }
     }
     return energy;
@@ -931,26 +1246,10 @@ double Bonded::internalGroupEnergy(const Change::GroupChange& changed) {
  * @warning Untested
  */
 void Bonded::force(std::vector<Point>& forces) {
-    auto distance_function = spc.geometry.getDistanceFunc();
-
-    auto calculateForces = [&](const auto& bond) {
-        if (!bond->hasForceFunction()) {
-            throw std::runtime_error("force not implemented!");
-        }
-        for (const auto& [index, force] : bond->forceFunc(distance_function)) {
-            forces.at(index) += force;
-        }
-    };
-
-    for ([[maybe_unused]] const auto& [group_index, bonds] : internal_bonds) {
-        for (const auto& bond : bonds) {
-            calculateForces(bond);
-        }
-    }
-
-    for (const auto& bond : external_bonds) {
-        calculateForces(bond);
+    for ([[maybe_unused]] const auto& [group_index, bonds] : internal_packed) {
+        bonds.force(spc.geometry, spc.particles, forces);
     }
+    external_packed.force(spc.geometry, spc.particles, forces);
 }
 
 //---------- Hamiltonian ------------
@@ -1010,6 +1309,8 @@ Hamiltonian::Hamiltonian(Space& spc, const json& j) : energy_terms(this->vec) {
                 if (key == "maxenergy") {
                     // looks like an unfortumate json scheme decision that requires special handling here
                     maximum_allowed_energy = value.get<double>();
+                } else if (key == "early_rejection") {
+                    early_rejection = value.get<bool>();
                 } else {
                     energy_terms.push_back(createEnergy(spc, key, value));
                     faunus_logger->debug("hamiltonian expanded with {}", key);
@@ -1024,6 +1325,10 @@ Hamiltonian::Hamiltonian(Space& spc, const json& j) : energy_terms(this->vec) {
         }
     }
     latest_energies.reserve(energy_terms.size());
+    term_statistics.resize(energy_terms.size());
+    evaluation_order.resize(energy_terms.size());
+    std::iota(evaluation_order.begin(), evaluation_order.end(), 0);
+    updateEvaluationOrder();
     checkBondedMolecules();
 }
 
@@ -1052,6 +1357,83 @@ double Hamiltonian::energy(const Change& change) {
     }
     return std::accumulate(latest_energies.begin(), latest_energies.end(), 0.0);
 }
+/**
+ * The terms are summed in an adaptive order and, as soon as the partial sum plus a lower bound of
+ * the remaining terms exceeds `maximum_energy`, summation stops and infinity is returned.
+ * This is used with a Metropolis threshold drawn before the energy is calculated, in which case
+ * `maximum_energy` is the largest new energy that could possibly be accepted.
+ * The result is exact as terms without a finite lower bound (see `Energybase::minimumEnergy()`)
+ * are always evaluated.
+ *
+ * @param change Change to calculate energy for
+ * @param maximum_energy Largest acceptable energy (kT)
+ * @return Energy (kT) or infinity if larger than `maximum_energy`
+ */
+double Hamiltonian::energy(const Change& change, const double maximum_energy) {
+    if (++number_of_budget_evaluations % reorder_interval == 0) {
+        updateEvaluationOrder();
+    }
+    latest_energies.assign(energy_terms.size(), 0.0);
+    auto partial_energy = 0.0;
+    for (size_t position = 0; position < evaluation_order.size(); ++position) {
+        const auto index = evaluation_order[position];
+        auto& energy_ptr = energy_terms[index];
+        energy_ptr->state = state;
+        energy_ptr->timer.start();
+        const auto energy = energy_ptr->energy(change);
+        energy_ptr->timer.stop();
+        latest_energies[index] = energy;
+        term_statistics[index].number_of_evaluations++;
+        partial_energy += energy;
+        if (energy >= maximum_allowed_energy || std::isnan(energy)) {
+            term_statistics[index].number_of_rejections++;
+            return std::accumulate(latest_energies.begin(), latest_energies.end(), 0.0);
+        }
+        if (partial_energy + remaining_minimum_energy[position] > maximum_energy) {
+            term_statistics[index].number_of_rejections++;
+            number_of_early_rejections++;
+            return pc::infty;
+        }
+    }
+    return std::accumulate(latest_energies.begin(), latest_energies.end(), 0.0); // original order
+}
+
+/**
+ * Terms are sorted by the measured time per evaluation (`Energybase::timer`) divided
+ * by the frequency with which they caused rejection, so that cheap terms that often
+ * reject are evaluated first.
+ */
+void Hamiltonian::updateEvaluationOrder() {
+    auto cost_per_rejection = [&](const auto index) {
+        const auto& statistics = term_statistics.at(index);
+        const auto evaluations = static_cast<double>(std::max(statistics.number_of_evaluations, 1UL));
+        const auto cost = energy_terms.at(index)->timer.result() / evaluations;
+        const auto rejection_frequency = (statistics.number_of_rejections + 1.0) / (evaluations + 1.0);
+        return cost / rejection_frequency;
+    };
+    if (number_of_budget_evaluations > 0) {
+        std::stable_sort(evaluation_order.begin(), evaluation_order.end(),
+                         [&](auto a, auto b) { return cost_per_rejection(a) < cost_per_rejection(b); });
+    }
+    remaining_minimum_energy.assign(evaluation_order.size(), 0.0);
+    auto minimum_energy = 0.0;
+    for (auto position = static_cast<int>(evaluation_order.size()) - 1; position >= 0; --position) {
+        remaining_minimum_energy[position] = minimum_energy;
+        minimum_energy += energy_terms.at(evaluation_order[position])->minimumEnergy();
+    }
+}
+
+bool Hamiltonian::earlyRejection() const { return early_rejection; }
+
+json Hamiltonian::earlyRejectionInfo() const {
+    json j = {{"evaluations", number_of_budget_evaluations}, {"early rejections", number_of_early_rejections}};
+    auto& j_order = j["evaluation order"] = json::array();
+    for (const auto index : evaluation_order) {
+        j_order.push_back(energy_terms.at(index)->name);
+    }
+    return j;
+}
+
 void Hamiltonian::init() {
     std::for_each(energy_terms.begin(), energy_terms.end(), [&](auto& energy) { energy->init(); });
 }
@@ -1075,6 +1457,83 @@ void Hamiltonian::sync(Energybase* other_hamiltonian, const Change& change) {
     throw std::runtime_error("hamiltonian mismatch");
 }
 
+TEST_CASE("[Faunus] Hamiltonian - energy with maximum") {
+    const auto original_atoms = Faunus::atoms;
+    const auto original_molecules = Faunus::molecules;
+    const auto input = R"({
+        "atomlist": [{"A": {"sigma": 2.0, "eps": 0.5}}],
+        "moleculelist": [{"particles": {"atoms": ["A"], "atomic": true}}],
+        "insertmolecules": [{"particles": {"N": 20}}],
+        "geometry": {"type": "cuboid", "length": 20},
+        "energy": [{"nonbonded": {"default": [{"lennardjones": {"mixing": "LB"}}]}},
+                   {"confine": {"type": "cuboid", "low": [-5, -5, -5], "high": [5, 5, 5],
+                                "molecules": ["particles"], "k": 1.0}},
+                   {"early_rejection": true}]
+    })"_json;
+    Faunus::atoms = input["atomlist"].get<decltype(Faunus::atoms)>();
+    Faunus::molecules = input["moleculelist"].get<decltype(Faunus::molecules)>();
+
+    Change everything;
+    everything.everything = true;
+    Space spc(input);
+    spc.particles.at(0).pos.setZero(); // inside the confining region
+    Space trial_spc(input);
+    trial_spc.sync(spc, everything);
+    Hamiltonian hamiltonian(spc, input.at("energy"));
+    Hamiltonian trial_hamiltonian(trial_spc, input.at("energy"));
+    REQUIRE(trial_hamiltonian.earlyRejection());
+
+    Change change; // move the first particle outside the confining region
+    Change::GroupChange group_change;
+    group_change.group_index = 0;
+    group_change.relative_atom_indices = {0};
+    change.groups.push_back(group_change);
+    trial_spc.particles.at(0).pos = Point(9.0, 9.0, 9.0);
+    trial_hamiltonian.updateState(change);
+
+    const auto energy = trial_hamiltonian.energy(change);
+    const auto energies = trial_hamiltonian.latestEnergies();
+    REQUIRE(energies.size() == 2);
+    REQUIRE(energies[1] > 0.0);
+
+    // below the maximum, the result is identical to the unbounded energy
+    CHECK(trial_hamiltonian.energy(change, pc::infty) == energy);
+    CHECK(trial_hamiltonian.latestEnergies() == energies);
+    CHECK(trial_hamiltonian.energy(change, energy) == energy);
+
+    // a sum exceeding the maximum is infinite...
+    CHECK(trial_hamiltonian.energy(change, std::nextafter(energy, pc::neg_infty)) == pc::infty);
+    CHECK(trial_hamiltonian.latestEnergies() == energies);
+
+    // ...and confinement is skipped if the nonbonded energy already exceeds the maximum
+    CHECK(trial_hamiltonian.energy(change, std::nextafter(energies[0], pc::neg_infty)) == pc::infty);
+    CHECK(trial_hamiltonian.latestEnergies()[0] == energies[0]);
+    CHECK(trial_hamiltonian.latestEnergies()[1] == 0.0);
+    const auto info = trial_hamiltonian.earlyRejectionInfo();
+    CHECK(info["evaluations"].get<int>() == 4);
+    CHECK(info["early rejections"].get<int>() == 2);
+
+    // rejecting after an early rejection restores the trial state...
+    trial_spc.sync(spc, change);
+    trial_hamiltonian.sync(&hamiltonian, change);
+    CHECK(trial_spc.particles.at(0).pos == spc.particles.at(0).pos);
+    CHECK(trial_hamiltonian.energy(everything) == hamiltonian.energy(everything));
+    CHECK(trial_hamiltonian.energy(change, pc::infty) == hamiltonian.energy(change));
+
+    // ...whereas accepting a change leaves both states identical
+    trial_spc.particles.at(0).pos = Point(9.0, 9.0, 9.0);
+    trial_hamiltonian.updateState(change);
+    REQUIRE(trial_hamiltonian.energy(change, pc::infty) == energy);
+    spc.sync(trial_spc, change);
+    hamiltonian.sync(&trial_hamiltonian, change);
+    CHECK(hamiltonian.latestEnergies() == energies);
+    CHECK(hamiltonian.energy(everything) == trial_hamiltonian.energy(everything));
+    CHECK(hamiltonian.energy(change) == energy);
+
+    Faunus::atoms = original_atoms;
+    Faunus::molecules = original_molecules;
+}
+
 /**
  * @brief Factory function to generate energy instances based on their name and json input
  * @param spc Space to use
@@ -1174,6 +1633,52 @@ std::unique_ptr<Energybase> Hamiltonian::createEnergy(Space& spc, const std::str
 
 const std::vector<double>& Hamiltonian::latestEnergies() const { return latest_energies; }
 
+/**
+ * The running energies are used to report the system energy without a full
+ * recalculation of all terms. Incomplete or non-finite input, e.g. from a calculation
+ * that stopped at an infinite term, leaves the running energies unknown.
+ * Running energies are also unknown with a penalty function, as its energy of a given
+ * configuration changes whenever the penalty is updated, i.e. also between accepted moves.
+ *
+ * @param energies Energy of each term (kT), typically from a full calculation
+ */
+void Hamiltonian::resetTrackedEnergies(const std::vector<double>& energies) {
+    auto is_finite = [](auto energy) { return std::isfinite(energy); };
+    if (findFirstOf<Penalty>()) {
+        tracked_energies.clear();
+    } else if (energies.size() == energy_terms.size() &&
+               std::all_of(energies.begin(), energies.end(), is_finite)) {
+        tracked_energies = energies;
+    } else {
+        tracked_energies.clear();
+    }
+}
+
+/**
+ * Must be called on the Hamiltonian of the accepted state *before* it is synchronized
+ * with the trial state, as the old energies are taken from `latestEnergies()`.
+ *
+ * @param trial_energies Energy of each term in the trial state, i.e. `latestEnergies()` of the trial Hamiltonian
+ */
+void Hamiltonian::trackAcceptedChange(const std::vector<double>& trial_energies) {
+    if (tracked_energies.empty()) {
+        return;
+    }
+    if (trial_energies.size() != tracked_energies.size() || latest_energies.size() != tracked_energies.size()) {
+        tracked_energies.clear(); // energy calculation was incomplete
+        return;
+    }
+    for (size_t i = 0; i < tracked_energies.size(); ++i) {
+        tracked_energies[i] += trial_energies[i] - latest_energies[i];
+        if (!std::isfinite(tracked_energies[i])) {
+            tracked_energies.clear();
+            return;
+        }
+    }
+}
+
+const std::vector<double>& Hamiltonian::trackedEnergies() const { return tracked_energies; }
+
 #ifdef ENABLE_FREESASA
 
 FreeSASAEnergy::FreeSASAEnergy(const Space& spc, const double cosolute_molarity, const double probe_radius)
@@ -1708,6 +2213,263 @@ TEST_CASE("[Faunus] GroupCutoff") {
     }
 }
 
+PowerLawVolumeScaling::PowerLawVolumeScaling(const json& j) {
+    exponents = j.at("exponents").get<decltype(exponents)>();
+    check_interval = j.value("check_interval", check_interval);
+    tolerance = j.value("tolerance", tolerance);
+    if (exponents.empty() || std::any_of(exponents.begin(), exponents.end(), [](auto n) { return n <= 0.0; })) {
+        throw ConfigurationError("volume_scaling: exponents must be positive");
+    }
+    const auto size = static_cast<Eigen::Index>(exponents.size());
+    scales = Eigen::VectorXd::LinSpaced(size, 1.0, 1.0 + 0.25 * static_cast<double>(size - 1));
+    Eigen::MatrixXd scaling_matrix(size, size); // tₖ⁻ⁿ
+    for (Eigen::Index k = 0; k < size; ++k) {
+        for (Eigen::Index n = 0; n < size; ++n) {
+            scaling_matrix(k, n) = std::pow(scales[k], -exponents[n]);
+        }
+    }
+    const Eigen::FullPivLU<Eigen::MatrixXd> decomposition(scaling_matrix);
+    if (!decomposition.isInvertible()) {
+        throw ConfigurationError("volume_scaling: exponents must be unique");
+    }
+    inverse_scaling_matrix = decomposition.inverse();
+    reference_sums = latest_sums = Eigen::VectorXd::Zero(size);
+}
+
+const Eigen::VectorXd& PowerLawVolumeScaling::getScales() const { return scales; }
+
+/**
+ * Only isotropic scalings of systems where all particles follow the box scaling,
+ * i.e. atomic groups and single particle molecules, are allowed.
+ */
+std::optional<double> PowerLawVolumeScaling::isotropicScaling(const Space& spc) const {
+    if (!reference_is_valid) {
+        return std::nullopt;
+    }
+    const auto follows_box = [](const Group& group) { return group.isAtomic() || group.capacity() <= 1; };
+    if (!std::all_of(spc.groups.begin(), spc.groups.end(), follows_box)) {
+        return std::nullopt;
+    }
+    const Point ratio = spc.geometry.getLength().cwiseQuotient(reference_box_length);
+    const auto scaling = ratio.x();
+    const auto max_deviation = (ratio.array() - scaling).abs().maxCoeff();
+    if (!(max_deviation <= 1e-9 * scaling) || !std::isfinite(scaling)) { // also catches NaN
+        return std::nullopt;
+    }
+    return scaling;
+}
+
+/**
+ * @param sums E(tₖ) of a configuration
+ * @param scaling Isotropic length scaling relative to the configuration of `sums`
+ */
+Eigen::VectorXd PowerLawVolumeScaling::scaledSums(const Eigen::VectorXd& sums, const double scaling) const {
+    const Eigen::VectorXd coefficients = inverse_scaling_matrix * sums; // Aₙ
+    Eigen::VectorXd sums(scales.size());
+    for (Eigen::Index k = 0; k < scales.size(); ++k) {
+        sums[k] = 0.0;
+        for (Eigen::Index n = 0; n < coefficients.size(); ++n) {
+            sums[k] += coefficients[n] * std::pow(scaling * scales[k], -exponents[n]);
+        }
+    }
+    return sums;
+}
+
+std::optional<double> PowerLawVolumeScaling::volumeChangeEnergy(const Space& spc) {
+    const auto scaling = isotropicScaling(spc);
+    if (!scaling) {
+        return std::nullopt;
+    }
+    auto sums = scaledSums(reference_sums, scaling.value());
+    if (check_interval > 0 && ++number_of_volume_changes % check_interval == 0) {
+        predicted_energy = sums[0]; // compare with upcoming full recalculation
+        return std::nullopt;
+    }
+    number_of_scaled_evaluations++;
+    setLatestSums(sums, true, spc.geometry.getLength());
+    return latest_sums[0];
+}
+
+/**
+ * @param sums E(tₖ) for the changed pairs
+ * @param complete True if all pairs are included in `sums`
+ * @param box_length Box dimensions used for the evaluation
+ */
+void PowerLawVolumeScaling::setLatestSums(const Eigen::VectorXd& sums, const bool complete, const Point& box_length) {
+    latest_sums = sums;
+    latest_is_complete = complete;
+    latest_box_length = box_length;
+    evaluated_since_sync = true;
+    if (predicted_energy) {
+        if (complete) {
+            const auto deviation = std::fabs(predicted_energy.value() - sums[0]) / std::max(1.0, std::fabs(sums[0]));
+            relative_deviation += deviation;
+            recalculated_since_sync = true;
+            if (deviation > tolerance) {
+                faunus_logger->warn("volume_scaling: relative deviation of {:.3e} from recalculated energy; are all "
+                                    "pair potentials pure power laws?",
+                                    deviation);
+            }
+        }
+        predicted_energy = std::nullopt;
+    }
+}
+
+/**
+ * Called on the accepted instance after an accepted move, where `other` holds the new
+ * configuration, and on the trial instance after a rejected move, where `other` holds the
+ * unchanged configuration. In the former case, both instances are updated. Incremental
+ * updates require that both instances were evaluated with the same change since the last sync.
+ * After a rejected move with a full recalculation, the reference sums are rescaled from the
+ * recalculated sums to discard any error accumulated by incremental updates.
+ *
+ * @param other Instance to synchronize with
+ * @param accepted True if `other` holds the new, accepted configuration
+ * @param box_length Box dimensions of the configuration in `other`
+ */
+void PowerLawVolumeScaling::sync(PowerLawVolumeScaling& other, const bool accepted, const Point& box_length) {
+    const auto other_has_complete_sums =
+        other.evaluated_since_sync && other.latest_is_complete && other.latest_box_length == box_length;
+    if (accepted) {
+        if (other_has_complete_sums) {
+            reference_sums = other.latest_sums;
+            reference_is_valid = true;
+        } else if (reference_is_valid && evaluated_since_sync && other.evaluated_since_sync) {
+            reference_sums += other.latest_sums - latest_sums;
+        } else {
+            reference_is_valid = false;
+        }
+        reference_box_length = box_length;
+        other.reference_sums = reference_sums;
+        other.reference_is_valid = reference_is_valid;
+        other.reference_box_length = reference_box_length;
+    } else {
+        if (!other.reference_is_valid && other_has_complete_sums) {
+            other.reference_sums = other.latest_sums;
+            other.reference_is_valid = true;
+            other.reference_box_length = box_length;
+        } else if (other.reference_is_valid && recalculated_since_sync) { // discard any accumulated error
+            const auto scaling = other.reference_box_length.x() / latest_box_length.x();
+            other.reference_sums = scaledSums(latest_sums, scaling);
+        }
+        reference_sums = other.reference_sums;
+        reference_is_valid = other.reference_is_valid;
+        reference_box_length = other.reference_box_length;
+    }
+    evaluated_since_sync = other.evaluated_since_sync = false;
+    recalculated_since_sync = other.recalculated_since_sync = false;
+    predicted_energy = other.predicted_energy = std::nullopt;
+}
+
+void PowerLawVolumeScaling::reset() {
+    reference_is_valid = false;
+    evaluated_since_sync = false;
+    recalculated_since_sync = false;
+    predicted_energy = std::nullopt;
+}
+
+void PowerLawVolumeScaling::to_json(json& j) const {
+    j = {{"exponents", exponents},
+         {"check_interval", check_interval},
+         {"tolerance", tolerance},
+         {"scaled evaluations", number_of_scaled_evaluations}};
+    if (!relative_deviation.empty()) {
+        j["relative deviation"] = relative_deviation.avg();
+    }
+}
+
+TEST_CASE("[Faunus] PowerLawVolumeScaling") {
+    auto lennard_jones = [](double r) { return 4.0 * (std::pow(r, -12) - std::pow(r, -6)); };
+    const std::vector<double> separations = {1.1, 1.3, 2.0, 3.5};
+    const json input = {{"exponents", {12, 6}}, {"check_interval", 0}};
+    PowerLawVolumeScaling accepted(input), trial(input);
+
+    auto energy_sums = [&](const PowerLawVolumeScaling& scaling, double box_scaling) {
+        Eigen::VectorXd sums = Eigen::VectorXd::Zero(scaling.getScales().size());
+        for (auto k = 0; k < sums.size(); ++k) {
+            for (auto r : separations) {
+                sums[k] += lennard_jones(box_scaling * scaling.getScales()[k] * r);
+            }
+        }
+        return sums;
+    };
+
+    Space spc;
+    spc.geometry = R"( {"type": "cuboid", "length": 10} )"_json;
+    const Point box_length = spc.geometry.getLength();
+    CHECK_FALSE(trial.volumeChangeEnergy(spc).has_value()); // no sums yet
+
+    accepted.setLatestSums(energy_sums(accepted, 1.0), true, box_length);
+    trial.sync(accepted, false, box_length); // e.g. initialization
+    spc.geometry.setLength(box_length * 1.2);
+    const auto energy = trial.volumeChangeEnergy(spc);
+    REQUIRE(energy.has_value());
+    CHECK(energy.value() == doctest::Approx(energy_sums(trial, 1.2)[0]));
+
+    SUBCASE("anisotropic scaling is not supported") {
+        spc.geometry.setLength({12.0, 10.0, 10.0});
+        CHECK_FALSE(trial.volumeChangeEnergy(spc).has_value());
+    }
+
+    SUBCASE("accepted volume change is propagated") {
+        accepted.setLatestSums(energy_sums(accepted, 1.0), true, box_length);
+        accepted.sync(trial, true, spc.geometry.getLength());
+        spc.geometry.setLength(box_length * 0.9);
+        CHECK(trial.volumeChangeEnergy(spc).value() == doctest::Approx(energy_sums(trial, 0.9)[0]));
+    }
+
+    SUBCASE("recalculation replaces inexact reference sums") {
+        const json checked_input = {{"exponents", {12, 6}}, {"check_interval", 2}};
+        PowerLawVolumeScaling checked_accepted(checked_input), checked_trial(checked_input);
+        checked_accepted.setLatestSums(1.01 * energy_sums(checked_accepted, 1.0), true, box_length);
+        checked_trial.sync(checked_accepted, false, box_length);
+        CHECK(checked_trial.volumeChangeEnergy(spc).value() ==
+              doctest::Approx(1.01 * energy_sums(checked_trial, 1.2)[0]));
+        checked_trial.sync(checked_accepted, false, box_length); // reject
+
+        CHECK_FALSE(checked_trial.volumeChangeEnergy(spc).has_value()); // full recalculation
+        checked_trial.setLatestSums(energy_sums(checked_trial, 1.2), true, spc.geometry.getLength());
+        checked_trial.sync(checked_accepted, false, box_length); // reject
+        json j;
+        checked_trial.to_json(j);
+        CHECK(j["relative deviation"].get<double>() > j["tolerance"].get<double>()); // also warns
+
+        spc.geometry.setLength(box_length * 0.9);
+        CHECK(checked_trial.volumeChangeEnergy(spc).value() == doctest::Approx(energy_sums(checked_trial, 0.9)[0]));
+    }
+}
+
+TEST_CASE("[Faunus] Nonbonded - volume scaling with summation policy") {
+    const auto original_atoms = Faunus::atoms;
+    const auto original_molecules = Faunus::molecules;
+    const auto input = R"({
+        "atomlist": [{"A": {"sigma": 2.0, "eps": 0.5}}],
+        "moleculelist": [{"particles": {"atoms": ["A"], "atomic": true}}],
+        "insertmolecules": [{"particles": {"N": 50}}],
+        "geometry": {"type": "cuboid", "length": 20}
+    })"_json;
+    Faunus::atoms = input["atomlist"].get<decltype(Faunus::atoms)>();
+    Faunus::molecules = input["moleculelist"].get<decltype(Faunus::molecules)>();
+    Space spc;
+    Faunus::from_json(input, spc);
+    Change change;
+    change.everything = true;
+
+    auto energy = [&](const json& nonbonded) {
+        Hamiltonian hamiltonian(spc, json::array({json{{"nonbonded", nonbonded}}}));
+        return hamiltonian.energy(change);
+    };
+    auto nonbonded = R"({"default": [{"lennardjones": {"mixing": "LB"}}]})"_json;
+    const auto reference_energy = energy(nonbonded);
+    nonbonded["volume_scaling"] = {{"exponents", {12, 6}}};
+    CHECK(energy(nonbonded) == doctest::Approx(reference_energy));
+    nonbonded["summation_policy"] = "openmp"; // falls back to serial if unavailable
+    CHECK(energy(nonbonded) == doctest::Approx(reference_energy));
+
+    Faunus::atoms = original_atoms;
+    Faunus::molecules = original_molecules;
+}
+
 EnergyAccumulatorBase::EnergyAccumulatorBase(double value) : value(value) {}
 
 void EnergyAccumulatorBase::reserve([[maybe_unused]] size_t number_of_particles) {}
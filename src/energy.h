@@ -77,6 +77,7 @@ class ContainerOverlap : public Energybase {
   public:
     explicit ContainerOverlap(const Space& spc);
     double energy(const Change& change) override;
+    double minimumEnergy() const override; //!< Zero or infinity
 };
 
 /**
@@ -282,16 +283,87 @@ class Constrain : public Energybase {
   public:
     Constrain(const json& j, Space& space);
     double energy(const Change& change) override;
+    double minimumEnergy() const override; //!< Zero or infinity
     void to_json(json& j) const override;
 };
 
 /**
- * The keys of the `intra` map are group index and the values
- * is a vector of `BondData`. For bonds between groups, fill
- * in `inter` which is evaluated for every update of call to
- * `energy`.
+ * @brief Compressed sparse row (CSR) lookup of the bonds involving each particle
  *
- * @todo Optimize.
+ * The bonds of the particle with index `first_particle_index + i` are found in
+ * `bond_indices[offsets[i]]` to `bond_indices[offsets[i + 1]]` where a bond index
+ * refers to the bond vector the lookup was built from.
+ */
+struct BondAdjacency {
+    std::size_t first_particle_index = 0;  //!< Absolute index of first particle covered by the lookup
+    std::vector<std::size_t> offsets;      //!< Start of each particle's bonds in `bond_indices`
+    std::vector<std::size_t> bond_indices; //!< Bond indices ordered by particle
+    void build(const BasePointerVector<Potential::BondData>& bonds, std::size_t first_particle_index,
+               std::size_t number_of_particles); //!< (Re)build lookup from bond vector
+    void appendBondsOf(std::size_t particle_index,
+                       std::vector<std::size_t>& target) const; //!< Append bonds of particle (absolute index)
+};
+
+/**
+ * @brief Bonds packed by type into structure-of-arrays (SoA)
+ *
+ * Bonds of the most common types are copied into plain index and parameter arrays
+ * so that energies and forces can be summed in tight, type specific loops instead
+ * of calling the `std::function` members of each `BondData`. Remaining bond types
+ * are evaluated through their usual functors. Like `BondData::setEnergyFunction()`,
+ * packing must be redone if the bonds or their particle indices change.
+ */
+class PackedBonds {
+    using BondPointer = std::shared_ptr<Potential::BondData>;
+    struct HarmonicBonds {
+        std::vector<std::array<int, 2>> indices;
+        std::vector<double> half_force_constant;
+        std::vector<double> equilibrium_distance;
+    };
+    struct FENEBonds {
+        std::vector<std::array<int, 2>> indices;
+        std::vector<double> half_force_constant;
+        std::vector<double> max_squared_distance;
+    };
+    struct FENEWCABonds {
+        std::vector<std::array<int, 2>> indices;
+        std::vector<double> half_force_constant;
+        std::vector<double> max_squared_distance;
+        std::vector<double> epsilon;
+        std::vector<double> sigma_squared;
+    };
+    struct HarmonicTorsions {
+        std::vector<std::array<int, 3>> indices;
+        std::vector<double> half_force_constant;
+        std::vector<double> equilibrium_angle;
+    };
+    struct PeriodicDihedrals {
+        std::vector<std::array<int, 4>> indices;
+        std::vector<double> force_constant;
+        std::vector<double> phase_angle;
+        std::vector<double> periodicity;
+    };
+    HarmonicBonds harmonic;
+    FENEBonds fene;
+    FENEWCABonds fene_wca;
+    HarmonicTorsions harmonic_torsions;
+    PeriodicDihedrals periodic_dihedrals;
+    std::vector<BondPointer> unpacked_bonds;        //!< Bonds evaluated through `BondData::energyFunc`
+    std::vector<BondPointer> unpacked_force_bonds;  //!< Bonds evaluated through `BondData::forceFunc`
+
+  public:
+    void pack(const BasePointerVector<Potential::BondData>& bonds); //!< Replace content with given bonds
+    double energy(const Space::GeometryType& geometry, const ParticleVector& particles) const; //!< Sum (kT)
+    void force(const Space::GeometryType& geometry, const ParticleVector& particles,
+               std::vector<Point>& forces) const; //!< Add bond forces (kT/Å) to `forces`
+};
+
+/**
+ * The keys of the `internal_bonds` map are group index and the values
+ * is a vector of `BondData`. Bonds between groups are stored in `external_bonds`.
+ * For partial updates, only bonds involving the changed particles are evaluated;
+ * these are found using particle-to-bond lookup tables (`BondAdjacency`).
+ * Complete sums of energies and forces use bonds packed by type (`PackedBonds`).
  */
 class Bonded : public Energybase {
   private:
@@ -299,40 +371,61 @@ class Bonded : public Energybase {
     const Space& spc;
     BondVector external_bonds;                                      //!< inter-molecular bonds
     std::map<int, BondVector> internal_bonds;                       //!< intra-molecular bonds; key is group index
+    BondAdjacency external_adjacency;                               //!< particle to bond lookup for `external_bonds`
+    std::map<int, BondAdjacency> internal_adjacency;                //!< particle to bond lookup for `internal_bonds`
+    PackedBonds external_packed;                                    //!< `external_bonds` packed by type
+    std::map<int, PackedBonds> internal_packed;                     //!< `internal_bonds` packed by type
+    std::vector<std::size_t> affected_bonds;                        //!< Reused buffer for bonds to evaluate
+    std::vector<std::size_t> changed_particle_indices;              //!< Reused buffer for particles to evaluate
     void updateGroupBonds(const Space::GroupType& group);           //!< Update/set bonds internally in group
-    double sumBondEnergy(const BondVector& bonds) const;            //!< sum energy in vector of BondData
     double internalGroupEnergy(const Change::GroupChange& changed); //!< Energy from internal bonds
-    double sumEnergy(const BondVector& bonds, const ranges::cpp20::range auto& particle_indices) const;
+    double externalEnergy(const Change& change);                    //!< Energy from inter-molecular bonds
+    double sumEnergy(const BondVector& bonds, const BondAdjacency& adjacency,
+                     const ranges::cpp20::range auto& particle_indices, bool skip_bonds_within = false);
     void updateInternalBonds(); //!< finds and adds all intra-molecular bonds of active molecules
 
   public:
     Bonded(const Space& spc, const BondVector& external_bonds);
     Bonded(const json& j, const Space& spc);
     void to_json(json& j) const override;
-    double energy(const Change& change) override;    //!< brute force -- refine this!
+    double energy(const Change& change) override;
     void force(std::vector<Point>& forces) override; //!< Calculates the forces on all particles
 };
 
 /**
  * @brief Sum energy in vector of BondData for matching particle indices
  * @param bonds List of bonds
+ * @param adjacency Particle to bond lookup table built from `bonds`
  * @param particle_indices Particle indices to calculate the energy for
+ * @param skip_bonds_within Skip bonds where all particles are in `particle_indices` (must then be sorted)
  *
- * To speed up the bond search, the given indices must be ordered which allows
- * for binary search which on large systems provides superior performance compared
- * to simplistic search which scales as number_of_bonds x number_of_moved_particles
+ * Only bonds involving the given particles are visited, so that the cost scales
+ * with the number of particles rather than with the number of bonds. Bonds
+ * shared by several of the particles are counted once.
  */
-double Bonded::sumEnergy(const Bonded::BondVector& bonds, const ranges::cpp20::range auto& particle_indices) const {
-    assert(std::is_sorted(particle_indices.begin(), particle_indices.end()));
-
-    auto index_is_included = [&](auto index) {
-        return std::binary_search(particle_indices.begin(), particle_indices.end(), index);
+double Bonded::sumEnergy(const Bonded::BondVector& bonds, const BondAdjacency& adjacency,
+                         const ranges::cpp20::range auto& particle_indices, const bool skip_bonds_within) {
+    affected_bonds.clear();
+    for (const auto particle_index : particle_indices) {
+        adjacency.appendBondsOf(particle_index, affected_bonds);
+    }
+    std::sort(affected_bonds.begin(), affected_bonds.end());
+    affected_bonds.erase(std::unique(affected_bonds.begin(), affected_bonds.end()), affected_bonds.end());
+    if (skip_bonds_within) {
+        auto is_within = [&](const auto bond_index) {
+            return std::all_of(bonds.vec[bond_index]->indices.begin(), bonds.vec[bond_index]->indices.end(),
+                               [&](const auto i) {
+                                   return std::binary_search(particle_indices.begin(), particle_indices.end(),
+                                                             static_cast<std::size_t>(i));
+                               });
+        };
+        affected_bonds.erase(std::remove_if(affected_bonds.begin(), affected_bonds.end(), is_within),
+                             affected_bonds.end());
+    }
+    auto bond_energy = [dist = spc.geometry.getDistanceFunc(), &bonds](auto sum, auto bond_index) {
+        return sum + bonds.vec[bond_index]->energyFunc(dist);
     };
-    auto affected_bonds = bonds | ranges::cpp20::views::filter([&](const auto& bond) {
-                              return ranges::cpp20::any_of(bond->indices, index_is_included);
-                          });
-    auto bond_energy = [dist = spc.geometry.getDistanceFunc()](const auto& bond) { return bond->energyFunc(dist); };
-    return std::transform_reduce(affected_bonds.begin(), affected_bonds.end(), 0.0, std::plus<>(), bond_energy);
+    return std::accumulate(affected_bonds.begin(), affected_bonds.end(), 0.0, bond_energy);
 }
 
 /**
@@ -388,6 +481,30 @@ class PairEnergy {
         }
     }
 
+    /**
+     * @brief Adds pair potential energies at separations scaled by each of the given factors
+     *
+     * @param a  particle
+     * @param b  particle
+     * @param scales  separation scaling factors
+     * @param energies  target vector; element k is incremented by the energy at separation `scales[k]` times r
+     */
+    template <typename T>
+    inline void addScaledPotentials(const T& a, const T& b, const Eigen::VectorXd& scales,
+                                    Eigen::VectorXd& energies) const {
+        assert(&a != &b); // a and b cannot be the same particle
+        const Point r = geometry.vdist(a.pos, b.pos);
+        const auto r_squared = r.squaredNorm();
+        for (Eigen::Index k = 0; k < scales.size(); ++k) {
+            const auto scale = scales[k];
+            if constexpr (allow_anisotropic_pair_potential) {
+                energies[k] += pair_potential(a, b, scale * scale * r_squared, Point(scale * r));
+            } else {
+                energies[k] += pair_potential(a, b, scale * scale * r_squared, {0, 0, 0});
+            }
+        }
+    }
+
     // just a temporary placement until PairForce class template will be implemented
     template <typename ParticleType> inline Point force(const ParticleType& a, const ParticleType& b) const {
         assert(&a != &b);                                       // a and b cannot be the same particle
@@ -619,6 +736,93 @@ template <RequirePairEnergy PairEnergy> class DelayedEnergyAccumulator : public
     }
 };
 
+/**
+ * Besides the energy, pair energies at separations scaled by a set of fixed factors
+ * are summed, see `PowerLawVolumeScaling`. The first factor must be unity.
+ * Plain values added to the accumulator are considered volume independent and are
+ * not included in `scaledSums()`.
+ *
+ * As for `DelayedEnergyAccumulator`, a non-serial `summation_policy` stores the pairs and
+ * postpones evaluation until `operator double()` is called. Both "openmp" and "parallel"
+ * then sum using OpenMP as the scaled sums are vectors.
+ */
+template <RequirePairEnergy PairEnergy> class ScaledEnergyAccumulator : public EnergyAccumulatorBase {
+  private:
+    const PairEnergy& pair_energy; //!< recipe to compute non-bonded energy between two particles, see PairEnergy
+    const Eigen::VectorXd& scales; //!< separation scaling factors
+    Eigen::VectorXd scaled_sums;   //!< summed pair energies for each scaling factor
+    std::vector<ParticlePair> particle_pairs;     //!< pairs awaiting evaluation (non-serial schemes only)
+    const size_t max_particles_in_buffer = 10000; //!< this can be modified to suit memory requirements
+
+    void accumulateOpenMP() {
+#pragma omp parallel
+        {
+            Eigen::VectorXd thread_sums = Eigen::VectorXd::Zero(scales.size());
+#pragma omp for
+            for (const auto& pair : particle_pairs) {
+                pair_energy.addScaledPotentials(pair.first.get(), pair.second.get(), scales, thread_sums);
+            }
+#pragma omp critical
+            scaled_sums += thread_sums;
+        }
+        particle_pairs.clear();
+    }
+
+  public:
+    ScaledEnergyAccumulator(const PairEnergy& pair_energy, const Eigen::VectorXd& scales)
+        : EnergyAccumulatorBase(0.0), pair_energy(pair_energy), scales(scales),
+          scaled_sums(Eigen::VectorXd::Zero(scales.size())) {}
+
+    void reserve(size_t number_of_particles) override {
+        if (scheme != Scheme::SERIAL) {
+            number_of_particles = std::min(number_of_particles, max_particles_in_buffer);
+            particle_pairs.reserve((number_of_particles - 1U) * number_of_particles / 2U);
+        }
+    }
+
+    void clear() override {
+        value = 0.0;
+        scaled_sums.setZero();
+        particle_pairs.clear();
+    }
+
+    ScaledEnergyAccumulator& operator=(const double new_value) override {
+        clear();
+        value = new_value;
+        return *this;
+    }
+
+    inline ScaledEnergyAccumulator& operator+=(const double new_value) override {
+        value += new_value;
+        return *this;
+    }
+
+    inline ScaledEnergyAccumulator& operator+=(ParticlePair&& pair) override {
+        if (scheme == Scheme::SERIAL) {
+            pair_energy.addScaledPotentials(pair.first.get(), pair.second.get(), scales, scaled_sums);
+        } else {
+            if (particle_pairs.size() == particle_pairs.capacity() && !particle_pairs.empty()) {
+                accumulateOpenMP(); // sum stored pairs and reset buffer
+            }
+            particle_pairs.emplace_back(pair);
+        }
+        return *this;
+    }
+
+    explicit operator double() override {
+        if (!particle_pairs.empty()) {
+            accumulateOpenMP();
+        }
+        return value + scaled_sums[0];
+    }
+
+    //! Scaled sums; must be preceded by a conversion to double which evaluates stored pairs
+    const Eigen::VectorXd& scaledSums() const {
+        assert(particle_pairs.empty());
+        return scaled_sums;
+    }
+};
+
 template <RequirePairEnergy TPairEnergy>
 std::unique_ptr<EnergyAccumulatorBase> createEnergyAccumulator(const json& j, const TPairEnergy& pair_energy,
                                                                double initial_value) {
@@ -806,7 +1010,8 @@ class GroupPairingPolicy {
      * @brief Pairing in the group involving only the particles present in the index.
      *
      * Only such non-bonded pair interactions within the group are considered if at least one particle is present
-     * in the index. The pair exclusions defined in the molecule topology are honoured.
+     * in the index. The pair exclusions defined in the molecule topology are honoured. If the indexed particles
+     * were moved as a rigid body, pairs with both particles in the index are skipped since their energy is unchanged.
      *
      * @tparam TAccumulator  an accumulator with '+=' operator overloaded to add a pair of particles as references
      *                       {T&, T&}
@@ -815,9 +1020,11 @@ class GroupPairingPolicy {
      * @param pair_accumulator  accumulator of interacting pairs of particles
      * @param group
      * @param index  internal indices of particles within the group
+     * @param rigid_index  skip pairs within the index (see `Change::GroupChange::rigid_segment`)
      */
     template <RequireEnergyAccumulator TAccumulator, typename TGroup, typename TIndex>
-    void groupInternal(TAccumulator& pair_accumulator, const TGroup& group, const TIndex& index) {
+    void groupInternal(TAccumulator& pair_accumulator, const TGroup& group, const TIndex& index,
+                       const bool rigid_index = false) {
         auto &moldata = group.traits();
         if (!moldata.rigid) {
             if (index.size() == 1) {
@@ -834,6 +1041,9 @@ class GroupPairingPolicy {
                         }
                     }
                 }
+                if (rigid_index) {
+                    return;
+                }
                 // moved <-> moved
                 for (auto i_it = index.begin(); i_it < index.end(); ++i_it) {
                     for (auto j_it = std::next(i_it); j_it < index.end(); ++j_it) {
@@ -1186,6 +1396,7 @@ template <typename TPolicy>
 class GroupPairing {
     const Space &spc;
     TPolicy pairing;
+    std::vector<std::size_t> fixed_group_indices; //!< Reused buffer for indices of static groups
 
   protected:
     /**
@@ -1215,7 +1426,8 @@ class GroupPairing {
             } else {
                 pairing.group2all(pair_accumulator, group, change_data.relative_atom_indices);
                 if (change_data.internal) {
-                    pairing.groupInternal(pair_accumulator, group, change_data.relative_atom_indices);
+                    pairing.groupInternal(pair_accumulator, group, change_data.relative_atom_indices,
+                                          change_data.rigid_segment);
                 }
             }
         }
@@ -1235,8 +1447,10 @@ class GroupPairing {
     void accumulateSpeciation(TAccumulator& pair_accumulator, const Change& change) {
         assert(change.matter_change);
         const auto &moved = change.touchedGroupIndex(); // index of moved groups
-        const auto fixed =
-            indexComplement(spc.groups.size(), moved) | ranges::to<std::vector>; // index of static groups
+        fixed_group_indices.clear(); // static groups; capacity is kept between calls
+        for (auto j : indexComplement(spc.groups.size(), moved)) {
+            fixed_group_indices.push_back(j);
+        }
         auto filter_active = [](int size) { return ranges::views::filter([size](const auto i) { return i < size; }); };
 
         // loop over all changed groups
@@ -1247,7 +1461,7 @@ class GroupPairing {
                 change_group1_it->relative_atom_indices | filter_active(group1.size()) | ranges::to<std::vector>;
             if (!index1.empty()) {
                 // particles added into the group: compute (changed group) <-> (static group)
-                pairing.group2groups(pair_accumulator, group1, fixed, index1);
+                pairing.group2groups(pair_accumulator, group1, fixed_group_indices, index1);
             }
             // loop over successor changed groups (hence avoid double counting group1×group2 and group2×group1)
             for (auto change_group2_it = std::next(change_group1_it); change_group2_it < change.groups.end(); ++change_group2_it) {
@@ -1320,6 +1534,55 @@ class GroupPairing {
     }
 };
 
+/**
+ * @brief Constant time energies after isotropic volume scaling of inverse power law pair potentials
+ *
+ * If all pair potentials are sums of inverse power laws, u(r) = Σₙ aₙ r⁻ⁿ, the total energy after
+ * scaling all separations by a factor s is U(s) = Σₙ Aₙ s⁻ⁿ. The coefficients Aₙ are obtained from
+ * pair energies summed at K fixed separation scalings, E(tₖ) = Σₙ Aₙ tₖ⁻ⁿ, where K is the number of
+ * exponents. This requires only the inverse of the constant K×K matrix tₖ⁻ⁿ.
+ *
+ * The sums for the accepted configuration are kept up to date by adding the differences from
+ * accepted moves, see `sync()`. For isotropic volume changes of atomic systems, the energy is then
+ * obtained without visiting any pairs. Every `check_interval` volume changes, a full recalculation is
+ * made and the relative deviation from the scaled energy is reported. Molecular groups, anisotropic
+ * box scaling, and missing sums all fall back to a full recalculation.
+ *
+ * @warning Pair potentials with cutoffs, shifts, or splines are not inverse power laws.
+ */
+class PowerLawVolumeScaling {
+  private:
+    std::vector<double> exponents;          //!< Inverse power law exponents, n
+    Eigen::VectorXd scales;                 //!< Separation scalings, tₖ; the first is unity
+    Eigen::MatrixXd inverse_scaling_matrix; //!< Maps E(tₖ) to power law coefficients, Aₙ
+    Eigen::VectorXd reference_sums;         //!< E(tₖ) for the latest synchronized configuration
+    Point reference_box_length = {0.0, 0.0, 0.0}; //!< Box dimensions for `reference_sums`
+    bool reference_is_valid = false;        //!< False until sums of a full configuration are known
+    Eigen::VectorXd latest_sums;            //!< E(tₖ) from the latest energy evaluation
+    Point latest_box_length = {0.0, 0.0, 0.0}; //!< Box dimensions for `latest_sums`
+    bool latest_is_complete = false;        //!< `latest_sums` include all pairs
+    bool evaluated_since_sync = false;      //!< `latest_sums` are from the current move
+    std::optional<double> predicted_energy; //!< Scaled energy to compare with a full recalculation
+    bool recalculated_since_sync = false;   //!< `latest_sums` are from a full recalculation replacing scaling
+    unsigned int check_interval = 100;      //!< Full recalculation every n'th volume change (0 = never)
+    double tolerance = 1e-6;                //!< Warn if the relative deviation from a recalculation is larger
+    unsigned int number_of_volume_changes = 0;
+    unsigned int number_of_scaled_evaluations = 0;
+    Average<double> relative_deviation; //!< Deviation between scaled and recalculated energies
+
+    std::optional<double> isotropicScaling(const Space& spc) const; //!< Scaling from reference, if applicable
+    Eigen::VectorXd scaledSums(const Eigen::VectorXd& sums, double scaling) const; //!< E(tₖ) after scaling `sums`
+
+  public:
+    explicit PowerLawVolumeScaling(const json& j);
+    const Eigen::VectorXd& getScales() const;
+    std::optional<double> volumeChangeEnergy(const Space& spc); //!< Empty if a full recalculation is required
+    void setLatestSums(const Eigen::VectorXd& sums, bool complete, const Point& box_length);
+    void sync(PowerLawVolumeScaling& other, bool accepted, const Point& box_length);
+    void reset(); //!< Discard all sums
+    void to_json(json& j) const;
+};
+
 class NonbondedBase : public Energybase {
   public:
     virtual double particleParticleEnergy(const Particle &particle1, const Particle &particle2) = 0;
@@ -1339,6 +1602,23 @@ template <RequirePairEnergy TPairEnergy, typename TPairingPolicy> class Nonbonde
     TPairingPolicy pairing;  //!< pairing policy to effectively sum up the pairwise additive non-bonded energy
     std::shared_ptr<EnergyAccumulatorBase>
         energy_accumulator; //!< energy accumulator used for storing and summing pair-wise energies
+    std::unique_ptr<PowerLawVolumeScaling> volume_scaling; //!< Optional constant time volume scaling
+    std::unique_ptr<ScaledEnergyAccumulator<TPairEnergy>> scaled_accumulator; //!< Used with `volume_scaling`
+
+  private:
+    double powerLawEnergy(const Change& change) {
+        if (change.volume_change) {
+            if (const auto energy = volume_scaling->volumeChangeEnergy(spc)) {
+                return energy.value();
+            }
+        }
+        scaled_accumulator->clear();
+        pairing.accumulate(*scaled_accumulator, change);
+        const auto energy = static_cast<double>(*scaled_accumulator); // evaluates any delayed pairs
+        volume_scaling->setLatestSums(scaled_accumulator->scaledSums(), change.everything || change.volume_change,
+                                      spc.geometry.getLength());
+        return energy;
+    }
 
   public:
     Nonbonded(const json& j, Space& spc, BasePointerVector<Energybase>& pot)
@@ -1347,6 +1627,13 @@ template <RequirePairEnergy TPairEnergy, typename TPairingPolicy> class Nonbonde
         from_json(j);
         energy_accumulator = createEnergyAccumulator(j, pair_energy, 0.0);
         energy_accumulator->reserve(spc.numParticles()); // attempt to reduce memory fragmentation
+        if (j.contains("volume_scaling")) {
+            volume_scaling = std::make_unique<PowerLawVolumeScaling>(j.at("volume_scaling"));
+            scaled_accumulator =
+                std::make_unique<ScaledEnergyAccumulator<TPairEnergy>>(pair_energy, volume_scaling->getScales());
+            scaled_accumulator->from_json(j); // same summation policy as `energy_accumulator`
+            scaled_accumulator->reserve(spc.numParticles());
+        }
     }
 
     double particleParticleEnergy(const Particle& particle1, const Particle& particle2) override {
@@ -1368,9 +1655,30 @@ template <RequirePairEnergy TPairEnergy, typename TPairingPolicy> class Nonbonde
         pair_energy.to_json(j);
         pairing.to_json(j);
         energy_accumulator->to_json(j);
+        if (volume_scaling) {
+            volume_scaling->to_json(j["volume_scaling"]);
+        }
+    }
+
+    void init() override {
+        if (volume_scaling) {
+            volume_scaling->reset();
+        }
+    }
+
+    void sync(Energybase* other_energy, [[maybe_unused]] const Change& change) override {
+        if (volume_scaling) {
+            if (auto* other = dynamic_cast<Nonbonded*>(other_energy); other && other->volume_scaling) {
+                volume_scaling->sync(*other->volume_scaling, state == MonteCarloState::ACCEPTED,
+                                     other->spc.geometry.getLength());
+            }
+        }
     }
 
     double energy(const Change& change) override {
+        if (volume_scaling) {
+            return powerLawEnergy(change);
+        }
         energy_accumulator->clear();
         // down-cast to avoid slow, virtual function calls:
         if (auto ptr = std::dynamic_pointer_cast<InstantEnergyAccumulator<TPairEnergy>>(energy_accumulator)) {
@@ -1417,6 +1725,7 @@ class NonbondedCached : public Nonbonded<TPairEnergy, TPairingPolicy> {
     using Base = Nonbonded<TPairEnergy, TPairingPolicy>;
     using TAccumulator = InstantEnergyAccumulator<TPairEnergy>;
     Eigen::MatrixXf energy_cache;
+    std::vector<std::size_t> fixed_group_indices; //!< Reused buffer for indices of static groups
     using Base::spc;
 
     template <typename TGroup>
@@ -1442,6 +1751,9 @@ class NonbondedCached : public Nonbonded<TPairEnergy, TPairingPolicy> {
 
   public:
     NonbondedCached(const json &j, Space &spc, BasePointerVector<Energybase> &pot) : Base(j, spc, pot) {
+        if (Base::volume_scaling) {
+            throw ConfigurationError("volume_scaling is unsupported for cached nonbonded energies");
+        }
         Base::name += "EM";
         init();
     }
@@ -1493,23 +1805,24 @@ class NonbondedCached : public Nonbonded<TPairEnergy, TPairingPolicy> {
                         }
                     }
                     // moved<->static
+                    fixed_group_indices.clear(); // static groups; capacity is kept between calls
+                    for (auto j : indexComplement(spc.groups.size(), moved)) {
+                        fixed_group_indices.push_back(j);
+                    }
 #if true
                     // classic version
-                    const auto fixed = indexComplement(spc.groups.size(), moved) | ranges::to_vector; // static groups
                     for (auto i : moved) {
-                        for (auto j : fixed) {
+                        for (auto j : fixed_group_indices) {
                             energy_sum += g2g(spc.groups[i], spc.groups[j]);
                         }
                     }
 #else
                     // OMP-ready version
-                    auto fixed =
-                        indexComplement(spc.groups.size(), moved) | ranges::to<std::vector>; // index of static groups
                     const size_t moved_size = moved.size();
-                    const size_t fixed_size = fixed.size();
+                    const size_t fixed_size = fixed_group_indices.size();
                     for (auto i = 0; i < moved_size; ++i) {
                         for (auto j = 0; j < fixed_size; ++j) {
-                            energy_sum += g2g(spc.groups[moved[i]], spc.groups[fixed[j]]);
+                            energy_sum += g2g(spc.groups[moved[i]], spc.groups[fixed_group_indices[j]]);
                         }
                     }
 #endif
@@ -1692,9 +2005,23 @@ class Example2D : public Energybase {
  */
 class Hamiltonian : public Energybase, public BasePointerVector<Energybase> {
   private:
+    //! Per term statistics used to order terms when summing with an energy budget
+    struct TermStatistics {
+        unsigned long number_of_evaluations = 0;
+        unsigned long number_of_rejections = 0; //!< Times the term triggered an early rejection
+    };
     double maximum_allowed_energy = pc::infty; //!< Maximum allowed energy change
     std::vector<double> latest_energies;       //!< Placeholder for the lastest energies for each energy term
+    std::vector<double> tracked_energies;      //!< Running energy of each term from accepted changes; empty if unknown
     decltype(vec)& energy_terms;               //!< Alias for `vec`
+    bool early_rejection = false;              //!< Allow pre-drawn Metropolis thresholds (opt-in)
+    std::vector<TermStatistics> term_statistics;     //!< Statistics for each term in `energy_terms`
+    std::vector<size_t> evaluation_order;            //!< Indices of `energy_terms` in order of evaluation
+    std::vector<double> remaining_minimum_energy;    //!< Lower energy bound of terms *after* position in order
+    unsigned long number_of_budget_evaluations = 0;  //!< Number of calls to `energy()` with a budget
+    unsigned long number_of_early_rejections = 0;    //!< Number of calls that exceeded the budget
+    static constexpr unsigned long reorder_interval = 1000; //!< Budget evaluations between reordering of terms
+    void updateEvaluationOrder();              //!< Order terms by cost over rejection frequency
     void addEwald(const json& j, Space& spc);  //!< Adds an instance of reciprocal space Ewald energies (if appropriate)
     void checkBondedMolecules() const;         //!< Warn if bonded molecules and no bonded energy term
     void to_json(json& j) const override;
@@ -1707,7 +2034,13 @@ class Hamiltonian : public Energybase, public BasePointerVector<Energybase> {
     void updateState(const Change& change) override;
     void sync(Energybase* other_hamiltonian, const Change& change) override;
     double energy(const Change& change) override;      //!< Energy due to changes
+    double energy(const Change& change, double maximum_energy); //!< Infinity as soon as `maximum_energy` is exceeded
     const std::vector<double>& latestEnergies() const; //!< Energies for each term from the latest call to `energy()`
+    void resetTrackedEnergies(const std::vector<double>& energies); //!< Set running energy of each term (empty = unknown)
+    void trackAcceptedChange(const std::vector<double>& trial_energies); //!< Add accepted change to running energies
+    const std::vector<double>& trackedEnergies() const; //!< Running energy of each term; empty if unknown
+    bool earlyRejection() const;                       //!< True if early rejection has been enabled by the user
+    json earlyRejectionInfo() const;                   //!< Statistics on early rejection and evaluation order
 };
 } // namespace Energy
 } // namespace Faunus
@@ -28,6 +28,12 @@ void Energybase::force([[maybe_unused]] PointVector& forces) {}
  */
 void Energybase::updateState([[maybe_unused]] const Change& change) {}
 
+/**
+ * Energy terms that can never return a value below a finite bound should override this,
+ * as it allows `Hamiltonian` to stop summation once a trial move cannot be accepted.
+ */
+double Energybase::minimumEnergy() const { return pc::neg_infty; }
+
 void to_json(json &j, const Energybase &base) {
     assert(not base.name.empty());
     if (base.timer)
@@ -187,6 +193,9 @@ Confine::Confine(const json& j, Space& spc) : ExternalPotential(j, spc) {
         };
     }
 }
+//! Harmonic confinement is non-negative for positive spring constants
+double Confine::minimumEnergy() const { return (spring_constant >= 0.0) ? 0.0 : pc::neg_infty; }
+
 void Confine::to_json(json &j) const {
     if (type == cuboid) {
         j = {{"low", low}, {"high", high}};
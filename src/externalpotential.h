@@ -30,6 +30,7 @@ class Energybase {
     virtual void init();                                  //!< reset and initialize
     virtual void updateState(const Change& change);       //!< Update internal state to reflect change in e.g. Space
     virtual void force(PointVector& forces);              //!< update forces on all particles
+    virtual double minimumEnergy() const;                 //!< Lower bound of `energy()`; used for early rejection
     inline virtual ~Energybase() = default;
 };
 
@@ -154,6 +155,7 @@ class Confine : public ExternalPotential {
   public:
     Confine(const json& j, Space& spc);
     void to_json(json& j) const override;
+    double minimumEnergy() const override;
 }; //!< Confine particles to a sub-region of the simulation container
 
 /**
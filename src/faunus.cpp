@@ -8,9 +8,15 @@
 #include "progress_tracker.h"
 #include "spdlog/spdlog.h"
 #include "move.h"
+#include "io.h"
 #include <spdlog/sinks/null_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
 
 #ifdef ENABLE_SID
 #include "cppsid.h"
@@ -47,6 +53,8 @@ void saveOutput(TimePoint& starting_time, docopt::Options& args, MetropolisMonte
 
 void mainLoop(bool show_progress, const json& json_in, MetropolisMonteCarlo& simulation,
               Analysis::CombinedAnalysis& analysis);
+template <typename TimePoint>
+void analyseTrajectory(TimePoint& starting_time, docopt::Options& args, const json& input);
 
 
 static const char USAGE[] =
@@ -56,6 +64,7 @@ static const char USAGE[] =
 
     Usage:
       faunus [-q] [--verbosity <N>] [--nobar] [--nopfx] [--notips] [--nofun] [--state=<file>] [--input=<file>] [--output=<file>] [--positions=<file>]
+      faunus analyse --trajectory=<file> [--threads=<N>] [-q] [--verbosity <N>] [--nopfx] [--notips] [--nofun] [--input=<file>] [--output=<file>]
       faunus (-h | --help)
       faunus --version
       faunus test <doctest-options>...
@@ -63,8 +72,10 @@ static const char USAGE[] =
     Options:
       -i <file> --input <file>         Input file [default: /dev/stdin].
       -o <file> --output <file>        Output file [default: out.json].
-      -s <file> --state <file>         State file to start from (.json/.ubj).
+      -s <file> --state <file>         State file to start from (.json/.ubj/.ckpt).
       -p <file> --positions <file>     Overwrite initial positions (xyz, gro, etc.).
+      -t <file> --trajectory <file>    Trajectory to analyse (xtc, traj, ztraj).
+      -j <N> --threads <N>             Threads for trajectory analysis (0 = all cores) [default: 0]
       -v <N> --verbosity <N>           Log verbosity level (0 = off, 1 = critical, ..., 6 = trace) [default: 4]
       -q --quiet                       Less verbose output. It implicates -v0 --nobar --notips --nofun.
       -h --help                        Show this screen.
@@ -79,6 +90,11 @@ static const char USAGE[] =
     1. input and output files are prefixed with "mpi{rank}."
     2. standard output is redirected to "mpi{rank}.stdout"
     3. Input prefixing can be suppressed with --nopfx
+
+    Trajectory analysis:
+
+    `faunus analyse` applies the analysis section of the input to each frame
+    of a trajectory without running a simulation.
 )";
 
 int main(int argc, const char** argv) {
@@ -100,10 +116,16 @@ int main(int argc, const char** argv) {
         pc::temperature = input.at("temperature").get<double>() * 1.0_K;
         setRandomNumberGenerator(input);
 
+        if (args["analyse"].asBool()) {
+            analyseTrajectory(starting_time, args, input);
+            return EXIT_SUCCESS;
+        }
+
         MetropolisMonteCarlo simulation(input);
         loadState(args, simulation);
         checkElectroNeutrality(simulation);
-        Analysis::CombinedAnalysis analysis(input.at("analysis"), simulation.getSpace(), simulation.getHamiltonian());
+        Analysis::CombinedAnalysis analysis(input.at("analysis"), simulation.getSpace(), simulation.getHamiltonian(),
+                                            input);
 
         bool show_progress = !quiet && !args["--nobar"].asBool();
 #ifdef ENABLE_MPI
@@ -225,6 +247,240 @@ void mainLoop(bool show_progress, const json& json_in, MetropolisMonteCarlo& sim
     faunus_logger->log(level, "relative energy drift = {:.3E}", simulation.relativeEnergyDrift());
 }
 
+/**
+ * @brief Bounded queue of XTC frames handed from a single reader to several analysis threads
+ *
+ * Each frame is tagged with its zero-based index in the trajectory. Coordinate buffers of
+ * consumed frames are recycled by the reader.
+ */
+class TrajectoryFrameQueue {
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::deque<std::pair<size_t, TrajectoryFrame>> frames;
+    std::vector<TrajectoryFrame> spare_frames; //!< Consumed frames whose buffers can be reused
+    const size_t capacity;
+    bool closed = false; //!< No more frames will be pushed or, on error, popped
+
+  public:
+    explicit TrajectoryFrameQueue(size_t capacity) : capacity(std::max(capacity, size_t(1))) {}
+
+    //! Frame to read the next trajectory frame into, possibly with recycled buffers
+    TrajectoryFrame spareFrame() {
+        std::lock_guard lock(mutex);
+        if (spare_frames.empty()) {
+            return {};
+        }
+        auto frame = std::move(spare_frames.back());
+        spare_frames.pop_back();
+        return frame;
+    }
+
+    //! Waits for free capacity; false if the queue was closed
+    bool push(size_t frame_index, TrajectoryFrame&& frame) {
+        std::unique_lock lock(mutex);
+        not_full.wait(lock, [&] { return closed || frames.size() < capacity; });
+        if (closed) {
+            return false;
+        }
+        frames.emplace_back(frame_index, std::move(frame));
+        lock.unlock();
+        not_empty.notify_one();
+        return true;
+    }
+
+    //! Waits for the next frame; false if the queue was closed and is empty. `frame` is recycled.
+    bool pop(size_t& frame_index, TrajectoryFrame& frame) {
+        std::unique_lock lock(mutex);
+        not_empty.wait(lock, [&] { return closed || !frames.empty(); });
+        if (frames.empty()) {
+            return false;
+        }
+        frame_index = frames.front().first;
+        std::swap(frame, frames.front().second);
+        spare_frames.push_back(std::move(frames.front().second));
+        frames.pop_front();
+        lock.unlock();
+        not_full.notify_one();
+        return true;
+    }
+
+    //! No more frames are pushed; if `discard`, also drop queued frames, e.g. on error
+    void close(bool discard = false) {
+        {
+            std::lock_guard lock(mutex);
+            closed = true;
+            if (discard) {
+                frames.clear();
+            }
+        }
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+};
+
+/**
+ * @brief Apply the analysis section of the input to all frames of a trajectory
+ *
+ * Each thread samples with a private state and set of analyses, which are finally merged.
+ * The analyses of a thread are advanced over frames sampled by other threads, so that
+ * `nstep` and `nskip` refer to frame numbers. If any analysis cannot be merged
+ * (see `CombinedAnalysis::isMergeable()`), a single thread is used.
+ *
+ * Native space trajectories (.traj, .ztraj) have a frame index and are split into contiguous
+ * blocks, each loaded by its thread. They restore all particle and group properties.
+ * XTC frames must be decompressed in order; they are therefore decoded once by the calling
+ * thread and handed to whichever thread is free. XTC frames set positions and box dimensions only.
+ */
+template <typename TimePoint>
+void analyseTrajectory(TimePoint& starting_time, docopt::Options& args, const json& input) {
+    struct Worker {
+        std::unique_ptr<MetropolisMonteCarlo::State> state;
+        std::unique_ptr<Analysis::CombinedAnalysis> analysis;
+        size_t first_frame = 0; //!< first frame of block (space trajectories only)
+        size_t last_frame = 0;  //!< last frame of block, exclusive (space trajectories only)
+        size_t next_frame = 0;  //!< frames before this are included in the step count of `analysis`
+    };
+    const auto filename = args["--trajectory"].asString();
+    const auto suffix = filename.substr(filename.find_last_of('.') + 1);
+    const bool space_trajectory = (suffix == "traj" || suffix == "ztraj");
+
+    auto worker_input = input;
+    worker_input.erase("analysis_threads"); // workers sample in their own thread
+    const auto& analysis_input = input.at("analysis");
+
+    auto number_of_threads = args["--threads"].asLong();
+    if (number_of_threads < 0) {
+        throw ConfigurationError("number of threads must be non-negative");
+    }
+    if (number_of_threads == 0) {
+        number_of_threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    const auto is_mergeable = [](const auto& j) {
+        return Analysis::CombinedAnalysis::isMergeable(std::get<0>(jsonSingleItem(j)));
+    };
+    if (number_of_threads > 1 && !std::all_of(analysis_input.begin(), analysis_input.end(), is_mergeable)) {
+        faunus_logger->warn("not all analyses can be merged; using a single thread");
+        number_of_threads = 1;
+    }
+
+    std::vector<Worker> workers;
+    workers.emplace_back().state = std::make_unique<MetropolisMonteCarlo::State>(worker_input);
+    size_t number_of_frames = 0;
+    if (space_trajectory) {
+        std::ifstream stream(filename, std::ios::binary);
+        if (!stream) {
+            throw ConfigurationError("cannot open {}", filename);
+        }
+        number_of_frames = FormatSpaceTrajectory(stream, *workers.front().state->spc).numberOfFrames();
+        faunus_logger->info("analysing {} frames from {}", number_of_frames, filename);
+        number_of_threads =
+            std::clamp(number_of_threads, 1L, static_cast<long>(std::max(number_of_frames, size_t(1))));
+    } else {
+        faunus_logger->info("analysing frames from {}", filename);
+    }
+
+    const auto original_log_level = faunus_logger->level();
+    faunus_logger->set_level(spdlog::level::off); // do not duplicate log info
+    while (workers.size() < static_cast<size_t>(number_of_threads)) {
+        workers.emplace_back().state = std::make_unique<MetropolisMonteCarlo::State>(worker_input);
+    }
+    faunus_logger->set_level(original_log_level);
+    for (size_t i = 0; i < workers.size(); i++) {
+        auto& worker = workers[i];
+        worker.first_frame = i * number_of_frames / workers.size();
+        worker.last_frame = (i + 1) * number_of_frames / workers.size();
+        worker.analysis = std::make_unique<Analysis::CombinedAnalysis>(analysis_input, *worker.state->spc,
+                                                                       *worker.state->pot, worker_input);
+    }
+
+    // advance analyses over frames sampled by other threads, then sample the given frame
+    auto sample_frame = [](Worker& worker, size_t frame_index) {
+        worker.analysis->advanceSteps(static_cast<int>(frame_index - worker.next_frame));
+        worker.analysis->sample();
+        worker.next_frame = frame_index + 1;
+    };
+
+    auto sample_block = [&](Worker& worker) {
+        auto& spc = *worker.state->spc;
+        std::ifstream stream(filename, std::ios::binary);
+        FormatSpaceTrajectory trajectory(stream, spc);
+        for (auto frame = worker.first_frame; frame < worker.last_frame; frame++) {
+            if (frame == worker.first_frame) {
+                trajectory.load(spc, frame);
+            } else {
+                trajectory.load(spc);
+            }
+            sample_frame(worker, frame);
+        }
+    };
+
+    TrajectoryFrameQueue queue(2 * workers.size());
+    auto sample_queued_frames = [&](Worker& worker) {
+        try {
+            auto& spc = *worker.state->spc;
+            TrajectoryFrame frame;
+            size_t frame_index = 0;
+            while (queue.pop(frame_index, frame)) {
+                if (frame.coordinates.size() != spc.particles.size()) {
+                    throw std::runtime_error("wrong number of particles in the loaded XTC frame");
+                }
+                spc.geometry.setLength(frame.box);
+                spc.updateParticles(frame.coordinates.begin(), frame.coordinates.end(), spc.particles.begin(),
+                                    [](const Point& position, Particle& particle) { particle.pos = position; });
+                sample_frame(worker, frame_index);
+            }
+        } catch (...) {
+            queue.close(true); // stop the reader and all other threads
+            throw;
+        }
+    };
+
+    std::vector<std::future<void>> threads;
+    if (space_trajectory) {
+        std::for_each(std::next(workers.begin()), workers.end(), [&](auto& worker) {
+            threads.push_back(std::async(std::launch::async, sample_block, std::ref(worker)));
+        });
+        sample_block(workers.front());
+    } else {
+        for (auto& worker : workers) {
+            threads.push_back(std::async(std::launch::async, sample_queued_frames, std::ref(worker)));
+        }
+        try {
+            XTCReader reader(filename);
+            while (true) {
+                auto frame = queue.spareFrame();
+                frame.coordinates.resize(reader.getNumberOfCoordinates()); // no-op if recycled
+                if (!reader.read(frame) || !queue.push(number_of_frames, std::move(frame))) {
+                    break;
+                }
+                number_of_frames++;
+            }
+        } catch (...) {
+            queue.close(true);
+            std::for_each(threads.begin(), threads.end(), [](auto& thread) { thread.wait(); });
+            throw;
+        }
+        queue.close();
+    }
+    std::for_each(threads.begin(), threads.end(), [](auto& thread) { thread.get(); });
+
+    auto& analysis = *workers.front().analysis;
+    std::for_each(std::next(workers.begin()), workers.end(), [&](auto& worker) { analysis.merge(*worker.analysis); });
+    analysis.to_disk();
+    faunus_logger->info("analysed {} frames using {} threads", number_of_frames, workers.size());
+
+    if (std::ofstream stream(Faunus::MPI::prefix + args["--output"].asString()); stream) {
+        json j;
+        j["trajectory"] = {{"file", filename}, {"frames", number_of_frames}, {"threads", workers.size()}};
+        j["analysis"] = analysis;
+        const auto elapsed_seconds =
+            std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - starting_time).count();
+        j["analysis time"] = {{"in minutes", elapsed_seconds / 60.0}, {"in seconds", elapsed_seconds}};
+        stream << std::setw(2) << j << std::endl;
+    }
+}
+
 void showProgress(std::shared_ptr<ProgressIndicator::ProgressTracker>& progress_tracker) {
     if (progress_tracker && (++(*progress_tracker) % 10 == 0)) {
         progress_tracker->display();
@@ -392,27 +648,34 @@ void loadCoordinates(std::string_view filename, MetropolisMonteCarlo& simulation
 void loadState(docopt::Options& args, MetropolisMonteCarlo& simulation) {
     if (args["--state"]) {
         const auto statefile = Faunus::MPI::prefix + args["--state"].asString();
-        const auto suffix = statefile.substr(statefile.find_last_of('.') + 1);
-        const bool binary = (suffix == "ubj");
-        auto mode = std::ios_base::in;
-        if (binary) {
-            mode = std::ios_base::ate | std::ios_base::binary; // ate = open at end
-        }
-        if (auto stream = std::ifstream(statefile, mode)) {
-            json j;
-            faunus_logger->info("loading state file {}", statefile);
+        if (SpaceCheckpoint::isCheckpointFile(statefile)) {
+            faunus_logger->info("loading checkpoint file {}", statefile);
+            SpaceCheckpoint checkpoint;
+            checkpoint.load(statefile);
+            simulation.restore(checkpoint);
+        } else {
+            const auto suffix = statefile.substr(statefile.find_last_of('.') + 1);
+            const bool binary = (suffix == "ubj");
+            auto mode = std::ios_base::in;
             if (binary) {
-                const auto size = stream.tellg(); // get file size
-                std::vector<std::uint8_t> buffer(size / sizeof(std::uint8_t));
-                stream.seekg(0, stream.beg);             // go back to start...
-                stream.read((char*)buffer.data(), size); // ...and read into buffer
-                j = json::from_ubjson(buffer);
+                mode = std::ios_base::ate | std::ios_base::binary; // ate = open at end
+            }
+            if (auto stream = std::ifstream(statefile, mode)) {
+                json j;
+                faunus_logger->info("loading state file {}", statefile);
+                if (binary) {
+                    const auto size = stream.tellg(); // get file size
+                    std::vector<std::uint8_t> buffer(size / sizeof(std::uint8_t));
+                    stream.seekg(0, stream.beg);             // go back to start...
+                    stream.read((char*)buffer.data(), size); // ...and read into buffer
+                    j = json::from_ubjson(buffer);
+                } else {
+                    stream >> j;
+                }
+                simulation.restore(j);
             } else {
-                stream >> j;
+                throw std::runtime_error("state file error -> "s + statefile);
             }
-            simulation.restore(j);
-        } else {
-            throw std::runtime_error("state file error -> "s + statefile);
         }
     }
     if (args["--positions"]) {
@@ -217,6 +217,7 @@ TEST_CASE("[Faunus] LangevinDynamics") {
     SUBCASE("Velocity and force initialization") {
         spc.particles.resize(10);                                                // 10 particles in total
         spc.groups.emplace_back(0, spc.particles.begin(), spc.particles.end() - 1); // 9 active particles
+        spc.updateMoleculeLookup();
         LangevinDynamics ld(spc, energy);
         CHECK(ld.getForces().capacity() >= 10);
         CHECK(ld.getVelocities().capacity() >= 10);
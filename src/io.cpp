@@ -7,6 +7,16 @@
 #include <spdlog/spdlog.h>
 #include <zstr.hpp>
 #include <cereal/archives/binary.hpp>
+#include <cereal/types/memory.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/map.hpp>
+#include <zlib.h>
+#include <sstream>
+#include <functional>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <filesystem>
 
 namespace Faunus {
 
@@ -268,6 +278,138 @@ bool XTCReader::read(TrajectoryFrame& frame) {
     return false;
 }
 
+bool XTCReader::skip() { return readFrame(); }
+
+// ========== XTCPrefetchReader ==========
+
+XTCPrefetchReader::XTCPrefetchReader(const std::string& filename, std::size_t capacity, int start, int stop,
+                                     int stride)
+    : reader(filename), ring(std::max(capacity, std::size_t(1))), start(start), stop(stop), stride(stride) {
+    if (start < 0 || stride < 1) {
+        throw std::runtime_error("invalid frame range");
+    }
+    thread = std::thread(&XTCPrefetchReader::run, this);
+}
+
+XTCPrefetchReader::~XTCPrefetchReader() {
+    {
+        std::lock_guard lock(mutex);
+        stop_requested = true;
+    }
+    ring_not_full.notify_all();
+    thread.join();
+}
+
+bool XTCPrefetchReader::isSelected(int frame_index) const {
+    return frame_index >= start && (frame_index - start) % stride == 0;
+}
+
+void XTCPrefetchReader::run() {
+    try {
+        TrajectoryFrame frame;
+        for (int frame_index = 0; (stop < 0 || frame_index < stop) && !stop_requested; ++frame_index) {
+            if (!isSelected(frame_index)) {
+                if (!reader.skip()) {
+                    break;
+                }
+                continue;
+            }
+            frame.coordinates.resize(reader.getNumberOfCoordinates()); // no-op if recycled
+            if (!reader.read(frame)) {
+                break;
+            }
+            std::unique_lock lock(mutex);
+            ring_not_full.wait(lock, [&] { return stop_requested || ring_count < ring.size(); });
+            if (stop_requested) {
+                return;
+            }
+            std::swap(ring[(ring_head + ring_count) % ring.size()], frame);
+            ring_count++;
+            lock.unlock();
+            ring_not_empty.notify_one();
+        }
+    } catch (...) {
+        std::lock_guard lock(mutex);
+        exception = std::current_exception();
+    }
+    {
+        std::lock_guard lock(mutex);
+        end_of_trajectory = true;
+    }
+    ring_not_empty.notify_all();
+}
+
+bool XTCPrefetchReader::read(TrajectoryFrame& frame) {
+    std::unique_lock lock(mutex);
+    ring_not_empty.wait(lock, [&] { return ring_count > 0 || end_of_trajectory; });
+    if (ring_count == 0) {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        return false;
+    }
+    std::swap(frame, ring[ring_head]);
+    ring_head = (ring_head + 1) % ring.size();
+    ring_count--;
+    lock.unlock();
+    ring_not_full.notify_one();
+    return true;
+}
+
+const std::string& XTCPrefetchReader::filename() const { return reader.filename; }
+
+TEST_CASE("[Faunus] XTCPrefetchReader") {
+    const std::string filename = "prefetch_test.xtc";
+    {
+        XTCWriter writer(filename);
+        for (int i = 0; i < 10; ++i) {
+            writer.write(TrajectoryFrame({10.0, 10.0, 10.0}, {{0.1 * i, 0.0, 0.0}}, i, 0.0));
+        }
+    }
+    auto read_steps = [&](std::size_t capacity, int start, int stop, int stride) {
+        XTCPrefetchReader reader(filename, capacity, start, stop, stride);
+        TrajectoryFrame frame;
+        std::vector<int> steps;
+        while (reader.read(frame)) {
+            steps.push_back(frame.step);
+        }
+        CHECK_FALSE(reader.read(frame));
+        return steps;
+    };
+    CHECK_EQ(read_steps(1, 0, -1, 1), std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+    CHECK_EQ(read_steps(4, 2, -1, 3), std::vector<int>{2, 5, 8});
+    CHECK_EQ(read_steps(2, 1, 6, 2), std::vector<int>{1, 3, 5});
+    { // destruction with pending frames must not block
+        XTCPrefetchReader reader(filename, 2);
+    }
+    CHECK_THROWS(XTCPrefetchReader(filename, 2, 0, -1, 0));
+    std::remove(filename.c_str());
+}
+
+TEST_CASE("[Faunus] BackgroundWriter") {
+    std::vector<std::string> written;
+    {
+        BackgroundWriter<std::string> writer([&](const std::string& item) { written.push_back(item); }, 2);
+        for (int i = 0; i < 20; ++i) {
+            writer.push([&](std::string& buffer) { buffer = std::to_string(i); });
+            if (i == 9) {
+                writer.flush();
+                CHECK_EQ(written.size(), 10);
+            }
+        }
+    } // remaining items are written on destruction
+    REQUIRE_EQ(written.size(), 20);
+    CHECK_EQ(written.front(), "0");
+    CHECK_EQ(written.back(), "19");
+    CHECK(std::is_sorted(written.begin(), written.end(),
+                         [](const auto& a, const auto& b) { return std::stoi(a) < std::stoi(b); }));
+
+    BackgroundWriter<int> failing_writer([](int) { throw std::runtime_error("write error"); }, 1);
+    failing_writer.push([](int& buffer) { buffer = 1; });
+    CHECK_THROWS(failing_writer.flush());
+    CHECK_THROWS(failing_writer.push([](int& buffer) { buffer = 2; }));
+}
+
 // ========== XTCWriter ==========
 
 XTCWriter::XTCWriter(const std::string& filename)
@@ -428,18 +570,712 @@ std::vector<AtomData::index_type> fastaToAtomIds(std::string_view fasta_sequence
     return Faunus::names2ids(Faunus::atoms, names);
 }
 
-FormatSpaceTrajectory::FormatSpaceTrajectory(std::ostream& ostream) {
-    if (ostream) {
-        output_archive = std::make_unique<cereal::BinaryOutputArchive>(ostream);
+namespace {
+constexpr std::array<char, 8> space_trajectory_magic = {'F', 'A', 'U', 'N', 'T', 'R', 'A', 'J'};
+constexpr std::array<char, 8> space_trajectory_end_magic = {'F', 'A', 'U', 'N', 'T', 'E', 'N', 'D'};
+constexpr std::uint32_t space_trajectory_version = 1;
+constexpr std::uint32_t keyframe_type = 0;
+constexpr std::uint32_t delta_frame_type = 1;
+constexpr std::uint64_t chunk_header_size = sizeof(std::uint32_t) + 2 * sizeof(std::uint64_t);
+
+template <typename T> void writeBinary(std::ostream& stream, const T& value) {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T> T readBinary(std::istream& stream) {
+    T value;
+    if (!stream.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+        throw std::runtime_error("unexpected end of file");
+    }
+    return value;
+}
+
+/** Replace `buffer` with its zlib compressed content */
+void compressBuffer(std::vector<char>& buffer) {
+    auto compressed_size = compressBound(buffer.size());
+    std::vector<char> compressed(compressed_size);
+    if (compress2(reinterpret_cast<Bytef*>(compressed.data()), &compressed_size,
+                  reinterpret_cast<const Bytef*>(buffer.data()), buffer.size(), Z_DEFAULT_COMPRESSION) != Z_OK) {
+        throw std::runtime_error("zlib compression failed");
+    }
+    compressed.resize(compressed_size);
+    std::swap(buffer, compressed);
+}
+
+/** Decompress `stored` into `buffer` which must end up with `raw_size` bytes */
+void uncompressBuffer(const std::vector<char>& stored, std::vector<char>& buffer, const std::uint64_t raw_size) {
+    buffer.resize(raw_size);
+    auto size = static_cast<uLongf>(raw_size);
+    if (uncompress(reinterpret_cast<Bytef*>(buffer.data()), &size, reinterpret_cast<const Bytef*>(stored.data()),
+                   stored.size()) != Z_OK ||
+        size != raw_size) {
+        throw std::runtime_error("zlib decompression failed");
+    }
+}
+
+struct ChunkHeader {
+    std::uint32_t type = keyframe_type;
+    std::uint64_t raw_size = 0;    //!< Size of uncompressed payload
+    std::uint64_t stored_size = 0; //!< Size of payload as stored in the file
+};
+
+ChunkHeader readChunkHeader(std::istream& stream, const std::uint64_t offset) {
+    stream.clear();
+    stream.seekg(static_cast<std::streamoff>(offset));
+    ChunkHeader header;
+    header.type = readBinary<std::uint32_t>(stream);
+    header.raw_size = readBinary<std::uint64_t>(stream);
+    header.stored_size = readBinary<std::uint64_t>(stream);
+    if (header.type != keyframe_type && header.type != delta_frame_type) {
+        throw std::runtime_error("corrupt space trajectory frame");
+    }
+    return header;
+}
+} // namespace
+
+FormatSpaceTrajectory::FormatSpaceTrajectory(std::ostream& ostream, const Space& spc, Compression compression,
+                                             unsigned int keyframe_interval)
+    : output_stream(&ostream), compression(compression), keyframe_interval(std::max(1U, keyframe_interval)) {
+    writeHeader(spc);
+}
+
+FormatSpaceTrajectory::FormatSpaceTrajectory(std::istream& istream, const Space& spc) : input_stream(&istream) {
+    readHeader(spc);
+    readIndex();
+}
+
+FormatSpaceTrajectory::~FormatSpaceTrajectory() {
+    try {
+        close();
+    } catch (std::exception& e) {
+        faunus_logger->error("error closing space trajectory: {}", e.what());
+    }
+}
+
+/**
+ * The hash covers atom and molecule names as well as the molecule type and capacity of
+ * all groups, i.e. everything that must match for a frame to be loaded into a Space.
+ * FNV-1a is used as it is stable across platforms and runs.
+ */
+std::uint64_t FormatSpaceTrajectory::topologyHash(const Space& spc) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    auto add_bytes = [&hash](const void* data, std::size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+    };
+    auto add_integer = [&](const std::uint64_t value) { add_bytes(&value, sizeof(value)); };
+    for (const auto& atom : Faunus::atoms) {
+        add_bytes(atom.name.data(), atom.name.size());
+    }
+    for (const auto& molecule : Faunus::molecules) {
+        add_bytes(molecule.name.data(), molecule.name.size());
+    }
+    add_integer(spc.particles.size());
+    for (const auto& group : spc.groups) {
+        add_integer(group.id);
+        add_integer(group.capacity());
+    }
+    return hash;
+}
+
+void FormatSpaceTrajectory::writeHeader(const Space& spc) {
+    output_stream->write(space_trajectory_magic.data(), space_trajectory_magic.size());
+    writeBinary(*output_stream, space_trajectory_version);
+    writeBinary(*output_stream, static_cast<std::uint32_t>(compression));
+    writeBinary(*output_stream, keyframe_interval);
+    writeBinary(*output_stream, topologyHash(spc));
+    if (!*output_stream) {
+        throw std::runtime_error("error writing space trajectory header");
+    }
+}
+
+void FormatSpaceTrajectory::readHeader(const Space& spc) {
+    std::array<char, 8> magic{};
+    if (!input_stream->read(magic.data(), magic.size()) || magic != space_trajectory_magic) {
+        throw std::runtime_error("not a space trajectory");
+    }
+    if (readBinary<std::uint32_t>(*input_stream) != space_trajectory_version) {
+        throw std::runtime_error("unsupported space trajectory version");
+    }
+    compression = static_cast<Compression>(readBinary<std::uint32_t>(*input_stream));
+    if (compression != Compression::NONE && compression != Compression::ZLIB) {
+        throw std::runtime_error("unknown space trajectory compression");
+    }
+    keyframe_interval = readBinary<std::uint32_t>(*input_stream);
+    if (readBinary<std::uint64_t>(*input_stream) != topologyHash(spc)) {
+        throw std::runtime_error("space trajectory topology differs from the current system");
+    }
+}
+
+void FormatSpaceTrajectory::readIndex() {
+    const auto first_chunk = static_cast<std::uint64_t>(input_stream->tellg());
+    input_stream->seekg(0, std::ios::end);
+    const auto file_size = static_cast<std::uint64_t>(input_stream->tellg());
+    frame_offsets.clear();
+
+    const auto trailer_size = sizeof(std::uint64_t) + space_trajectory_end_magic.size();
+    if (file_size >= first_chunk + trailer_size) {
+        input_stream->seekg(static_cast<std::streamoff>(file_size - trailer_size));
+        const auto index_offset = readBinary<std::uint64_t>(*input_stream);
+        std::array<char, 8> magic{};
+        input_stream->read(magic.data(), magic.size());
+        if (magic == space_trajectory_end_magic && index_offset < file_size) {
+            input_stream->seekg(static_cast<std::streamoff>(index_offset));
+            frame_offsets.resize(readBinary<std::uint64_t>(*input_stream));
+            for (auto& offset : frame_offsets) {
+                offset = readBinary<std::uint64_t>(*input_stream);
+            }
+            return;
+        }
+    }
+    faunus_logger->warn("space trajectory index missing; scanning frames");
+    for (auto offset = first_chunk; offset + chunk_header_size <= file_size;) {
+        const auto header = readChunkHeader(*input_stream, offset);
+        const auto next_offset = offset + chunk_header_size + header.stored_size;
+        if (next_offset > file_size) {
+            break; // truncated frame
+        }
+        frame_offsets.push_back(offset);
+        offset = next_offset;
     }
 }
-FormatSpaceTrajectory::FormatSpaceTrajectory(std::istream& istream) {
-    if (istream) {
-        input_archive = std::make_unique<cereal::BinaryInputArchive>(istream);
+
+void FormatSpaceTrajectory::save(const Space& spc) {
+    if (output_stream == nullptr || closed) {
+        throw std::runtime_error("space trajectory not open for writing");
+    }
+    std::ostringstream stream(std::ios::binary);
+    {
+        cereal::BinaryOutputArchive archive(stream);
+        archive(spc.geometry.getLength(), spc.getImplicitReservoir());
+        for (const auto& group : spc.groups) {
+            archive(group);
+        }
+    }
+    const auto raw = stream.str();
+    const auto keyframe = frame_offsets.size() % keyframe_interval == 0 || raw.size() != payload.size();
+
+    buffer.assign(raw.begin(), raw.end());
+    if (!keyframe) {
+        std::transform(buffer.begin(), buffer.end(), payload.begin(), buffer.begin(), std::bit_xor<char>());
+    }
+    payload.assign(raw.begin(), raw.end());
+
+    if (compression == Compression::ZLIB) {
+        compressBuffer(buffer);
+    }
+    frame_offsets.push_back(static_cast<std::uint64_t>(output_stream->tellp()));
+    writeBinary(*output_stream, keyframe ? keyframe_type : delta_frame_type);
+    writeBinary(*output_stream, static_cast<std::uint64_t>(payload.size()));
+    writeBinary(*output_stream, static_cast<std::uint64_t>(buffer.size()));
+    output_stream->write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!*output_stream) {
+        throw std::runtime_error("error writing space trajectory frame");
+    }
+}
+
+void FormatSpaceTrajectory::close() {
+    if (output_stream == nullptr || closed) {
+        return;
+    }
+    closed = true;
+    const auto index_offset = static_cast<std::uint64_t>(output_stream->tellp());
+    writeBinary(*output_stream, static_cast<std::uint64_t>(frame_offsets.size()));
+    for (const auto offset : frame_offsets) {
+        writeBinary(*output_stream, offset);
+    }
+    writeBinary(*output_stream, index_offset);
+    output_stream->write(space_trajectory_end_magic.data(), space_trajectory_end_magic.size());
+    output_stream->flush();
+}
+
+std::size_t FormatSpaceTrajectory::numberOfFrames() const { return frame_offsets.size(); }
+
+void FormatSpaceTrajectory::readChunk(const std::uint64_t offset, bool& keyframe) {
+    const auto header = readChunkHeader(*input_stream, offset);
+    keyframe = header.type == keyframe_type;
+    std::vector<char> stored(header.stored_size);
+    if (!input_stream->read(stored.data(), static_cast<std::streamsize>(stored.size()))) {
+        throw std::runtime_error("unexpected end of space trajectory");
+    }
+    if (compression == Compression::ZLIB) {
+        uncompressBuffer(stored, buffer, header.raw_size);
+    } else {
+        std::swap(buffer, stored);
+    }
+}
+
+/**
+ * Decoding starts at the nearest preceding keyframe, or continues from the currently
+ * decoded frame if no keyframe lies in between.
+ */
+void FormatSpaceTrajectory::decodeFrame(const std::size_t frame) {
+    if (decoded_frame == frame) {
+        return;
+    }
+    auto first = frame;
+    while (first > 0 && readChunkHeader(*input_stream, frame_offsets.at(first)).type != keyframe_type) {
+        if (decoded_frame == first - 1) {
+            break; // continue from already decoded frame
+        }
+        first--;
+    }
+    for (auto i = first; i <= frame; ++i) {
+        bool keyframe = false;
+        readChunk(frame_offsets.at(i), keyframe);
+        if (keyframe) {
+            std::swap(payload, buffer);
+        } else {
+            if (buffer.size() != payload.size() || decoded_frame != i - 1) {
+                throw std::runtime_error("corrupt space trajectory delta frame");
+            }
+            std::transform(payload.begin(), payload.end(), buffer.begin(), payload.begin(), std::bit_xor<char>());
+        }
+        decoded_frame = i;
+    }
+}
+
+void FormatSpaceTrajectory::load(Space& spc, const std::size_t frame) {
+    if (input_stream == nullptr) {
+        throw std::runtime_error("space trajectory not open for reading");
+    }
+    if (frame >= numberOfFrames()) {
+        throw std::out_of_range("space trajectory frame out of range");
     }
+    decodeFrame(frame);
+    std::istringstream stream(std::string(payload.begin(), payload.end()), std::ios::binary);
+    cereal::BinaryInputArchive archive(stream);
+    Point box;
+    archive(box, spc.getImplicitReservoir());
+    for (auto& group : spc.groups) {
+        archive(group);
+    }
+    if ((box - spc.geometry.getLength()).norm() > pc::epsilon_dbl) {
+        spc.geometry.setLength(box);
+    }
+    next_frame = frame + 1;
+}
+
+bool FormatSpaceTrajectory::load(Space& spc) {
+    if (next_frame >= numberOfFrames()) {
+        return false;
+    }
+    load(spc, next_frame);
+    return true;
+}
+
+TEST_CASE("[Faunus] FormatSpaceTrajectory") {
+    using doctest::Approx;
+    auto make_space = [](Space& spc, size_t number_of_particles) {
+        spc.geometry = R"( {"type": "cuboid", "length": 10} )"_json;
+        spc.particles.resize(number_of_particles);
+        spc.groups.emplace_back(0, spc.particles.begin(), spc.particles.end());
+        spc.updateMoleculeLookup();
+    };
+    Space spc;
+    make_space(spc, 4);
+    const auto number_of_frames = 7;
+    const auto footer_size = 3 * sizeof(std::uint64_t) + number_of_frames * sizeof(std::uint64_t);
+
+    for (const auto compression : {FormatSpaceTrajectory::Compression::NONE, FormatSpaceTrajectory::Compression::ZLIB}) {
+        std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+        {
+            FormatSpaceTrajectory writer(stream, spc, compression, 3);
+            for (int frame = 0; frame < number_of_frames; ++frame) {
+                for (auto& particle : spc.particles) {
+                    particle.pos.x() = frame;
+                    particle.charge = -frame;
+                }
+                spc.groups.front().resize(frame % 2 == 0 ? 4 : 3);
+                spc.getImplicitReservoir()[1] = 10 + frame;
+                writer.save(spc);
+            }
+        } // footer is written on destruction
+
+        // random access
+        Space other;
+        make_space(other, 4);
+        FormatSpaceTrajectory reader(stream, other);
+        CHECK_EQ(reader.numberOfFrames(), number_of_frames);
+        reader.load(other, 5);
+        CHECK_EQ(other.groups.front().size(), 3);
+        CHECK_EQ(other.getImplicitReservoir().at(1), 15);
+        CHECK(other.particles.at(3).pos.x() == Approx(5.0));
+        reader.load(other, 2);
+        CHECK_EQ(other.groups.front().size(), 4);
+        CHECK_EQ(other.getImplicitReservoir().at(1), 12);
+        CHECK(other.particles.at(0).charge == Approx(-2.0));
+        CHECK(reader.load(other)); // continues with frame 3
+        CHECK(other.particles.at(1).pos.x() == Approx(3.0));
+        CHECK_THROWS(reader.load(other, number_of_frames));
+
+        // missing footer; frames are found by scanning
+        const auto content = stream.str();
+        std::stringstream truncated(content.substr(0, content.size() - footer_size), std::ios::in | std::ios::binary);
+        FormatSpaceTrajectory scanning_reader(truncated, other);
+        CHECK_EQ(scanning_reader.numberOfFrames(), number_of_frames);
+        int frames_read = 0;
+        while (scanning_reader.load(other)) {
+            frames_read++;
+        }
+        CHECK_EQ(frames_read, number_of_frames);
+        CHECK(other.particles.at(0).pos.x() == Approx(6.0));
+
+        // topology mismatch
+        Space different;
+        make_space(different, 5);
+        std::stringstream same_content(content, std::ios::in | std::ios::binary);
+        CHECK_THROWS(FormatSpaceTrajectory(same_content, different));
+    }
+}
+
+// ========== ColumnWriter ==========
+
+namespace {
+constexpr std::array<char, 8> column_file_magic = {'F', 'A', 'U', 'N', 'C', 'O', 'L', 'S'};
+constexpr std::uint32_t column_file_version = 1;
+constexpr auto native_byte_order = std::endian::native == std::endian::little ? "little" : "big";
+
+template <typename T> void appendBinary(std::vector<char>& buffer, const T value) {
+    const auto* bytes = reinterpret_cast<const char*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T> double extractBinary(const char* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return static_cast<double>(value);
+}
+} // namespace
+
+NLOHMANN_JSON_SERIALIZE_ENUM(ColumnWriter::Type,
+                             {{ColumnWriter::Type::FLOAT64, "float64"}, {ColumnWriter::Type::FLOAT32, "float32"}})
+
+bool ColumnWriter::isColumnFile(const std::string& filename) {
+    const auto suffix = filename.substr(filename.find_last_of('.') + 1);
+    return suffix == "fcol" || suffix == "zfcol";
+}
+
+ColumnWriter::ColumnWriter(const std::string& filename, std::vector<Column> columns, std::size_t chunk_rows)
+    : stream(filename, std::ios::binary)
+    , columns(std::move(columns))
+    , column_values(this->columns.size())
+    , chunk_rows(std::max(chunk_rows, std::size_t(1)))
+    , compress(filename.substr(filename.find_last_of('.') + 1) == "zfcol") {
+    if (!stream) {
+        throw std::runtime_error("could not open file "s + filename);
+    }
+    json header = {{"columns", json::array()},
+                   {"compression", compress ? "zlib" : "none"},
+                   {"byte_order", native_byte_order},
+                   {"chunk_rows", this->chunk_rows}};
+    for (const auto& column : this->columns) {
+        header["columns"].push_back({{"name", column.name}, {"type", column.type}});
+    }
+    const auto header_string = header.dump();
+    stream.write(column_file_magic.data(), column_file_magic.size());
+    writeBinary(stream, column_file_version);
+    writeBinary(stream, static_cast<std::uint32_t>(header_string.size()));
+    stream.write(header_string.data(), static_cast<std::streamsize>(header_string.size()));
+    for (auto& values : column_values) {
+        values.reserve(this->chunk_rows);
+    }
+}
+
+ColumnWriter::~ColumnWriter() {
+    try {
+        writeChunk();
+    } catch (std::exception& e) {
+        faunus_logger->error("error writing columns: {}", e.what());
+    }
+}
+
+void ColumnWriter::addRow(std::span<const double> values) {
+    if (values.size() != columns.size()) {
+        throw std::runtime_error("number of values and columns differ");
+    }
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        column_values[i].push_back(values[i]);
+    }
+    if (column_values.front().size() >= chunk_rows) {
+        writeChunk();
+    }
+}
+
+void ColumnWriter::addRow(std::initializer_list<double> values) { addRow({values.begin(), values.size()}); }
+
+/**
+ * The payload holds the values of the first column, followed by those of the second column etc.
+ */
+void ColumnWriter::writeChunk() {
+    if (column_values.empty() || column_values.front().empty()) {
+        return;
+    }
+    const auto number_of_rows = column_values.front().size();
+    buffer.clear();
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        for (const auto value : column_values[i]) {
+            if (columns[i].type == Type::FLOAT32) {
+                appendBinary(buffer, static_cast<float>(value));
+            } else {
+                appendBinary(buffer, value);
+            }
+        }
+        column_values[i].clear();
+    }
+    const auto raw_size = buffer.size();
+    if (compress) {
+        compressBuffer(buffer);
+    }
+    writeBinary(stream, static_cast<std::uint64_t>(number_of_rows));
+    writeBinary(stream, static_cast<std::uint64_t>(raw_size));
+    writeBinary(stream, static_cast<std::uint64_t>(buffer.size()));
+    stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!stream) {
+        throw std::runtime_error("error writing columns");
+    }
+}
+
+void ColumnWriter::flush() {
+    writeChunk();
+    stream.flush();
+}
+
+ColumnReader::ColumnReader(const std::string& filename) : stream(filename, std::ios::binary) {
+    std::array<char, 8> magic{};
+    if (!stream.read(magic.data(), magic.size()) || magic != column_file_magic) {
+        throw std::runtime_error("not a column file: "s + filename);
+    }
+    if (readBinary<std::uint32_t>(stream) != column_file_version) {
+        throw std::runtime_error("unsupported column file version");
+    }
+    std::string header_string(readBinary<std::uint32_t>(stream), '\0');
+    if (!stream.read(header_string.data(), static_cast<std::streamsize>(header_string.size()))) {
+        throw std::runtime_error("corrupt column file header");
+    }
+    header = json::parse(header_string);
+    if (header.at("byte_order").get<std::string>() != native_byte_order) {
+        throw std::runtime_error("column file byte order differs from this machine");
+    }
+}
+
+const json& ColumnReader::getHeader() const { return header; }
+
+std::vector<std::pair<std::string, std::vector<double>>> ColumnReader::read() {
+    std::vector<std::pair<std::string, std::vector<double>>> columns;
+    std::vector<ColumnWriter::Type> types;
+    for (const auto& column : header.at("columns")) {
+        columns.emplace_back(column.at("name").get<std::string>(), std::vector<double>());
+        types.push_back(column.at("type").get<ColumnWriter::Type>());
+    }
+    const auto compressed = header.at("compression").get<std::string>() == "zlib";
+    std::vector<char> stored;
+    std::vector<char> buffer;
+    while (stream.peek() != std::char_traits<char>::eof()) {
+        std::array<std::uint64_t, 3> chunk_header{}; // rows, raw size, stored size
+        if (!stream.read(reinterpret_cast<char*>(chunk_header.data()), sizeof(chunk_header))) {
+            break; // truncated chunk
+        }
+        const auto [number_of_rows, raw_size, stored_size] = chunk_header;
+        stored.resize(stored_size);
+        if (!stream.read(stored.data(), static_cast<std::streamsize>(stored.size()))) {
+            break; // truncated chunk
+        }
+        if (compressed) {
+            uncompressBuffer(stored, buffer, raw_size);
+        } else {
+            std::swap(buffer, stored);
+        }
+        const auto* data = buffer.data();
+        for (std::size_t i = 0; i < columns.size(); ++i) {
+            const auto value_size = types[i] == ColumnWriter::Type::FLOAT32 ? sizeof(float) : sizeof(double);
+            if (data + number_of_rows * value_size > buffer.data() + buffer.size()) {
+                throw std::runtime_error("corrupt column file chunk");
+            }
+            auto& values = columns[i].second;
+            for (std::uint64_t row = 0; row < number_of_rows; ++row, data += value_size) {
+                values.push_back(types[i] == ColumnWriter::Type::FLOAT32 ? extractBinary<float>(data)
+                                                                         : extractBinary<double>(data));
+            }
+        }
+    }
+    return columns;
+}
+
+TEST_CASE("[Faunus] ColumnWriter") {
+    using doctest::Approx;
+    for (const std::string filename : {"column_test.fcol", "column_test.zfcol"}) {
+        {
+            ColumnWriter writer(filename, {{"step"}, {"energy", ColumnWriter::Type::FLOAT32}}, 3);
+            for (int i = 0; i < 8; ++i) {
+                writer.addRow({static_cast<double>(i), 0.1 * i});
+            }
+            CHECK_THROWS(writer.addRow({1.0}));
+        }
+        ColumnReader reader(filename);
+        CHECK_EQ(reader.getHeader().at("compression"), filename == "column_test.zfcol" ? "zlib" : "none");
+        const auto columns = reader.read();
+        REQUIRE_EQ(columns.size(), 2);
+        CHECK_EQ(columns[0].first, "step");
+        CHECK_EQ(columns[1].first, "energy");
+        REQUIRE_EQ(columns[0].second.size(), 8);
+        REQUIRE_EQ(columns[1].second.size(), 8);
+        CHECK_EQ(columns[0].second.back(), Approx(7.0));
+        CHECK_EQ(columns[1].second[5], Approx(0.5));
+        std::remove(filename.c_str());
+    }
+    CHECK(ColumnWriter::isColumnFile("energy.zfcol"));
+    CHECK_FALSE(ColumnWriter::isColumnFile("energy.dat"));
+}
+
+// ========== SpaceCheckpoint ==========
+
+namespace {
+constexpr std::array<char, 8> checkpoint_magic = {'F', 'A', 'U', 'N', 'C', 'K', 'P', 'T'};
+constexpr std::uint32_t checkpoint_version = 1;
+
+void writeString(std::ostream& stream, const std::string& string) {
+    writeBinary(stream, static_cast<std::uint64_t>(string.size()));
+    stream.write(string.data(), static_cast<std::streamsize>(string.size()));
+}
+
+std::string readString(std::istream& stream) {
+    std::string string(readBinary<std::uint64_t>(stream), '\0');
+    if (!stream.read(string.data(), static_cast<std::streamsize>(string.size()))) {
+        throw std::runtime_error("unexpected end of file");
+    }
+    return string;
+}
+} // namespace
+
+void SpaceCheckpoint::copy(const Space& spc, const Random* move_random, const Random* global_random) {
+    topology_hash = FormatSpaceTrajectory::topologyHash(spc);
+    std::ostringstream stream(std::ios::binary);
+    {
+        cereal::BinaryOutputArchive archive(stream);
+        archive(json(spc.geometry).dump(), spc.getImplicitReservoir());
+        for (const auto& group : spc.groups) {
+            archive(group);
+        }
+    }
+    payload = stream.str();
+    random_move = move_random ? json(*move_random).dump() : std::string();
+    random_global = global_random ? json(*global_random).dump() : std::string();
+}
+
+void SpaceCheckpoint::apply(Space& spc) const {
+    if (topology_hash != FormatSpaceTrajectory::topologyHash(spc)) {
+        throw std::runtime_error("checkpoint topology mismatch");
+    }
+    std::istringstream stream(payload, std::ios::binary);
+    cereal::BinaryInputArchive archive(stream);
+    std::string geometry;
+    archive(geometry, spc.getImplicitReservoir());
+    spc.geometry = json::parse(geometry);
+    for (auto& group : spc.groups) {
+        archive(group);
+    }
+}
+
+void SpaceCheckpoint::applyRandom(Random& move_random, Random& global_random) const {
+    if (!random_move.empty()) {
+        from_json(json::parse(random_move), move_random);
+    }
+    if (!random_global.empty()) {
+        from_json(json::parse(random_global), global_random);
+    }
+}
+
+void SpaceCheckpoint::save(const std::string& filename) const {
+    const auto temporary_filename = filename + ".tmp";
+    {
+        std::ofstream stream(temporary_filename, std::ios::binary);
+        if (!stream) {
+            throw std::runtime_error("could not open " + temporary_filename);
+        }
+        stream.write(checkpoint_magic.data(), checkpoint_magic.size());
+        writeBinary(stream, checkpoint_version);
+        writeBinary(stream, topology_hash);
+        writeString(stream, payload);
+        writeString(stream, random_move);
+        writeString(stream, random_global);
+        stream.flush();
+        if (!stream) {
+            throw std::runtime_error("error writing " + temporary_filename);
+        }
+    }
+    std::filesystem::rename(temporary_filename, filename);
+}
+
+void SpaceCheckpoint::load(const std::string& filename) {
+    std::ifstream stream(filename, std::ios::binary);
+    if (!stream) {
+        throw std::runtime_error("could not open " + filename);
+    }
+    std::array<char, 8> magic{};
+    if (!stream.read(magic.data(), magic.size()) || magic != checkpoint_magic) {
+        throw std::runtime_error(filename + " is not a checkpoint file");
+    }
+    if (readBinary<std::uint32_t>(stream) != checkpoint_version) {
+        throw std::runtime_error("unsupported checkpoint version in " + filename);
+    }
+    topology_hash = readBinary<std::uint64_t>(stream);
+    payload = readString(stream);
+    random_move = readString(stream);
+    random_global = readString(stream);
+}
+
+bool SpaceCheckpoint::isCheckpointFile(const std::string& filename) {
+    return filename.substr(filename.find_last_of('.') + 1) == "ckpt";
+}
+
+TEST_CASE("[Faunus] SpaceCheckpoint") {
+    using doctest::Approx;
+    auto make_space = [](Space& spc, size_t number_of_particles) {
+        spc.geometry = R"( {"type": "cuboid", "length": 10} )"_json;
+        spc.particles.resize(number_of_particles);
+        spc.groups.emplace_back(0, spc.particles.begin(), spc.particles.end());
+        spc.updateMoleculeLookup();
+    };
+    const std::string filename = "checkpoint_test.ckpt";
+    Space spc;
+    make_space(spc, 4);
+    spc.particles.at(2).pos = {1.0, 2.0, 3.0};
+    spc.groups.front().resize(3);
+    spc.geometry.setLength({8.0, 9.0, 10.0});
+    Random random;
+    random();
+
+    SpaceCheckpoint checkpoint;
+    checkpoint.copy(spc, &random, nullptr);
+    spc.particles.at(2).pos.setZero(); // snapshot is unaffected by later changes
+    checkpoint.save(filename);
+    checkpoint.save(filename); // replaces existing file
+    CHECK_FALSE(std::filesystem::exists(filename + ".tmp"));
+
+    Space other;
+    make_space(other, 4);
+    Random other_random;
+    Random untouched_random;
+    SpaceCheckpoint loaded;
+    loaded.load(filename);
+    loaded.apply(other);
+    loaded.applyRandom(other_random, untouched_random);
+    CHECK_EQ(other.groups.front().size(), 3);
+    CHECK_EQ(other.particles.at(2).pos.z(), Approx(3.0));
+    CHECK_EQ(other.geometry.getLength().y(), Approx(9.0));
+    CHECK_EQ(other_random(), random());
+    CHECK_EQ(untouched_random(), Random()());
+
+    Space different;
+    make_space(different, 5);
+    CHECK_THROWS(loaded.apply(different));
+    std::remove(filename.c_str());
+    CHECK(SpaceCheckpoint::isCheckpointFile("state.ckpt"));
+    CHECK_FALSE(SpaceCheckpoint::isCheckpointFile("state.json"));
 }
-void FormatSpaceTrajectory::load([[maybe_unused]] Space& spc) { assert(input_archive != nullptr); }
-void FormatSpaceTrajectory::save([[maybe_unused]] const Space& spc) { assert(output_archive != nullptr); }
 
 // ------------------------
 
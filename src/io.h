@@ -11,11 +11,14 @@
 #include <range/v3/iterator/operations.hpp>
 #include <range/v3/algorithm/for_each.hpp>
 #include <numeric>
-
-namespace cereal {
-class BinaryOutputArchive;
-class BinaryInputArchive;
-} // namespace cereal
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <algorithm>
+#include <span>
 
 namespace Faunus {
 
@@ -562,6 +565,12 @@ class XTCReader {
      * @throw std::runtime_error  when other I/O error occures
      */
     bool read(TrajectoryFrame& frame);
+    /**
+     * @brief Skips the next frame in the trajectory without converting it
+     * @return true on success, false at the end of file
+     * @throw std::runtime_error  when other I/O error occures
+     */
+    bool skip();
     /**
      * @brief Reads the next frame in the trajectory.
      * @tparam begin_iterator
@@ -592,6 +601,55 @@ class XTCReader {
     bool readFrame();
 };
 
+/**
+ * @brief Reads XTC frames in a background thread into a bounded ring buffer
+ *
+ * Decoding of frames thereby overlaps with the work done by the caller. Only frames in the range
+ * [`start`, `stop`) with a given `stride` are passed on; skipped frames are never converted, but
+ * must still be decompressed as the XTC format has no frame index. Frames are handed over by
+ * swapping so that coordinate buffers are recycled.
+ */
+class XTCPrefetchReader {
+    XTCReader reader;                        //!< Used by background thread only
+    std::vector<TrajectoryFrame> ring;       //!< Ring buffer of decoded frames
+    std::size_t ring_head = 0;               //!< Index of oldest frame in `ring`
+    std::size_t ring_count = 0;              //!< Number of frames in `ring`
+    int start;                               //!< First frame to read (zero-based)
+    int stop;                                //!< Read frames until this (exclusive); negative = end of file
+    int stride;                              //!< Read every stride'th frame
+    bool end_of_trajectory = false;          //!< Raised by background thread when done
+    std::atomic<bool> stop_requested = false; //!< Signals background thread to stop
+    std::exception_ptr exception = nullptr;  //!< Exception from background thread
+    std::mutex mutex;                        //!< Protects `ring` and flags
+    std::condition_variable ring_not_full;   //!< Notified when a frame is consumed
+    std::condition_variable ring_not_empty;  //!< Notified when a frame is decoded or at end of trajectory
+    std::thread thread;                      //!< Background reader thread
+    void run();                              //!< Background thread function
+    bool isSelected(int frame_index) const;  //!< Is frame within range and stride?
+
+  public:
+    /**
+     * @param filename  a name of the XTC file to open
+     * @param capacity  maximum number of buffered frames
+     * @param start  first frame to read (zero-based)
+     * @param stop  stop reading at this frame (exclusive); negative value reads to end of file
+     * @param stride  read every stride'th frame
+     */
+    explicit XTCPrefetchReader(const std::string& filename, std::size_t capacity = 4, int start = 0, int stop = -1,
+                               int stride = 1);
+    ~XTCPrefetchReader();
+    XTCPrefetchReader(const XTCPrefetchReader&) = delete;
+    XTCPrefetchReader& operator=(const XTCPrefetchReader&) = delete;
+    /**
+     * @brief Waits for and returns the next frame
+     * @param[out] frame  target frame; its previous content is recycled
+     * @return true on success, false at the end of the trajectory or range
+     * @throw std::runtime_error  when an I/O error occured in the background thread
+     */
+    bool read(TrajectoryFrame& frame);
+    const std::string& filename() const; //!< Name of trajectory file
+};
+
 /**
  * @brief Writes frames into an XTC file (GROMACS compressed trajectory file format). It is a wrapper around
  * C function calls.
@@ -661,6 +719,115 @@ class XTCWriter {
     void writeFrameAt(int step, float time);
 };
 
+/**
+ * @brief Writes items in a background thread using a bounded ring of recycled buffers
+ *
+ * The caller fills a buffer with `push()`, which is then passed to `write_function` in a
+ * background thread in submission order. Buffers are handed over by swapping so that their
+ * capacity is retained, and if all are pending, the caller waits. An exception in the background
+ * thread stops further writing and is rethrown by the next `push()` or `flush()`. Pending items
+ * are written before destruction.
+ *
+ * @tparam T Buffer type, e.g. `TrajectoryFrame` or a formatted frame in a `std::string`
+ */
+template <typename T> class BackgroundWriter {
+    std::function<void(const T&)> write_function; //!< Used by background thread only
+    std::vector<T> ring;                          //!< Ring buffer of pending items
+    std::size_t ring_head = 0;                    //!< Index of oldest item in `ring`
+    std::size_t ring_count = 0;                   //!< Number of items in `ring`
+    T buffer;                                     //!< Filled by the caller before being handed over
+    bool writing = false;                         //!< True while an item is being written
+    bool stop_requested = false;                  //!< Signals background thread to stop when idle
+    std::exception_ptr exception = nullptr;       //!< Exception from background thread
+    std::mutex mutex;                             //!< Protects `ring` and flags
+    std::condition_variable ring_not_full;        //!< Notified when an item is taken or written
+    std::condition_variable ring_not_empty;       //!< Notified when an item is pushed or on stop
+    std::thread thread;                           //!< Background writer thread
+
+    void run() {
+        T item;
+        while (true) {
+            {
+                std::unique_lock lock(mutex);
+                ring_not_empty.wait(lock, [&] { return stop_requested || ring_count > 0; });
+                if (ring_count == 0) {
+                    return; // stopping and nothing left to write
+                }
+                std::swap(item, ring[ring_head]);
+                ring_head = (ring_head + 1) % ring.size();
+                ring_count--;
+                writing = exception == nullptr;
+            }
+            ring_not_full.notify_all();
+            if (writing) {
+                try {
+                    write_function(item);
+                } catch (...) {
+                    std::lock_guard lock(mutex);
+                    exception = std::current_exception();
+                }
+                {
+                    std::lock_guard lock(mutex);
+                    writing = false;
+                }
+                ring_not_full.notify_all();
+            }
+        }
+    }
+
+  public:
+    /**
+     * @param write_function  called in the background thread for each item
+     * @param capacity  maximum number of pending items
+     */
+    explicit BackgroundWriter(std::function<void(const T&)> write_function, std::size_t capacity = 4)
+        : write_function(std::move(write_function)), ring(std::max(capacity, std::size_t(1))) {
+        thread = std::thread(&BackgroundWriter::run, this);
+    }
+
+    ~BackgroundWriter() {
+        {
+            std::lock_guard lock(mutex);
+            stop_requested = true;
+        }
+        ring_not_empty.notify_all();
+        thread.join();
+    }
+
+    BackgroundWriter(const BackgroundWriter&) = delete;
+    BackgroundWriter& operator=(const BackgroundWriter&) = delete;
+
+    /**
+     * @brief Fill a recycled buffer in the calling thread and queue it for writing
+     * @param fill  function called with the buffer to fill; the buffer contains a previously written item
+     * @throw std::runtime_error  when an I/O error occured in the background thread
+     */
+    template <std::invocable<T&> FillFunction> void push(FillFunction fill) {
+        fill(buffer);
+        std::unique_lock lock(mutex);
+        ring_not_full.wait(lock, [&] { return exception || ring_count < ring.size(); });
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        std::swap(ring[(ring_head + ring_count) % ring.size()], buffer);
+        ring_count++;
+        lock.unlock();
+        ring_not_empty.notify_one();
+    }
+
+    /**
+     * @brief Wait until all pushed items have been written
+     * @throw std::runtime_error  when an I/O error occured in the background thread
+     */
+    void flush() {
+        std::unique_lock lock(mutex);
+        ring_not_full.wait(lock, [&] { return exception || (ring_count == 0 && !writing); });
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+};
+
 std::vector<AtomData::index_type>
 fastaToAtomIds(std::string_view fasta_sequence); //!< Convert FASTA sequence to atom id sequence
 
@@ -690,21 +857,171 @@ ParticleVector loadStructure(std::string_view filename, bool prefer_charges_from
 std::unique_ptr<StructureFileWriter> createStructureFileWriter(const std::string& suffix);
 
 /**
- * @brief Placeholder for Space Trajectory
+ * @brief Native binary trajectory with all particle and group properties
+ *
+ * Unlike XTC, frames are stored losslessly and include charges, ids, group sizes,
+ * mass centers and particle extensions such as dipoles. The file layout is:
  *
- * The idea is that the format handles both input and
- * output streams that may of may not be compressed.
+ * 1. Header with magic bytes, format version, a hash of the topology and the compression scheme
+ * 2. Frames, each prefixed by a chunk header with the frame type and the raw and stored byte sizes.
+ *    The raw payload is the cereal serialization of the box, the implicit reservoir and all groups.
+ *    Delta frames store the bytewise XOR with the previous payload which is mostly zero and
+ *    compresses well; keyframes are stored every `keyframe_interval` frames and whenever the
+ *    payload size changes. Payloads are optionally zlib compressed.
+ * 3. Footer with the file offset of each frame, enabling random access
+ *
+ * Random access to a frame decodes at most `keyframe_interval` frames. Should the footer be
+ * missing, e.g. if the simulation was terminated, the frames are indexed by scanning the chunk headers.
  */
 class FormatSpaceTrajectory {
+  public:
+    enum class Compression : std::uint32_t { NONE = 0, ZLIB = 1 };
+
+  private:
+    std::ostream* output_stream = nullptr;
+    std::istream* input_stream = nullptr;
+    Compression compression = Compression::NONE;
+    std::uint32_t keyframe_interval = 10;        //!< Frames between keyframes
+    std::vector<std::uint64_t> frame_offsets;    //!< Stream position of each frame
+    std::vector<char> payload;                   //!< Raw payload of latest written or decoded frame
+    std::vector<char> buffer;                    //!< Temporary storage for (de)compression and deltas
+    std::size_t next_frame = 0;                  //!< Next frame for sequential reading
+    std::optional<std::size_t> decoded_frame;    //!< Frame currently held in `payload`
+    bool closed = false;                         //!< True when the footer has been written
+    void writeHeader(const Space& spc);
+    void readHeader(const Space& spc);
+    void readIndex();                         //!< Read footer or, if missing, scan chunks
+    void decodeFrame(std::size_t frame);      //!< Decode frame into `payload`
+    void readChunk(std::uint64_t offset, bool& keyframe); //!< Read and decompress chunk into `buffer`
+
+  public:
+    /**
+     * @brief Open trajectory for writing and write header
+     * @param ostream Binary output stream; must outlive this object
+     * @param spc Space to derive the topology hash from
+     * @param compression Compression of frame payloads
+     * @param keyframe_interval Number of frames between full frames
+     */
+    FormatSpaceTrajectory(std::ostream& ostream, const Space& spc, Compression compression = Compression::NONE,
+                          unsigned int keyframe_interval = 10);
+    /**
+     * @brief Open trajectory for reading
+     * @param istream Binary, seekable input stream; must outlive this object
+     * @param spc Space with the same topology as used when writing
+     * @throw std::runtime_error if not a trajectory or on topology mismatch
+     */
+    FormatSpaceTrajectory(std::istream& istream, const Space& spc);
+    ~FormatSpaceTrajectory();
+    FormatSpaceTrajectory(const FormatSpaceTrajectory&) = delete;
+    FormatSpaceTrajectory& operator=(const FormatSpaceTrajectory&) = delete;
+    bool load(Space& spc);                    //!< Load next frame; false at end of trajectory
+    void load(Space& spc, std::size_t frame); //!< Load given frame (zero-based) and continue from there
+    void save(const Space& spc);              //!< Append single frame
+    void close();                             //!< Write footer; further saving is not possible
+    std::size_t numberOfFrames() const;       //!< Number of frames
+    static std::uint64_t topologyHash(const Space& spc); //!< Hash of atom and molecule types and group layout
+};
+
+/**
+ * @brief Buffered, binary output of time series in columns
+ *
+ * Rows are buffered and written in chunks where the values of each column are stored
+ * contiguously as fixed-width, native floating point numbers. This avoids text formatting
+ * and gives much smaller files than text output. The file layout is:
+ *
+ * 1. Magic bytes, format version and the size of a JSON header describing the columns,
+ *    byte order, compression and chunk size
+ * 2. Chunks, each prefixed by the number of rows and the raw and stored byte sizes.
+ *    Payloads are zlib compressed if the filename ends with `.zfcol`.
+ *
+ * Files are read by `ColumnReader`, available in python as `pyfaunus.readColumns()`.
+ */
+class ColumnWriter {
+  public:
+    enum class Type { FLOAT64, FLOAT32 };
+    struct Column {
+        std::string name;
+        Type type = Type::FLOAT64;
+    };
+
   private:
-    std::unique_ptr<cereal::BinaryOutputArchive> output_archive;
-    std::unique_ptr<cereal::BinaryInputArchive> input_archive;
+    std::ofstream stream;
+    std::vector<Column> columns;
+    std::vector<std::vector<double>> column_values; //!< Buffered rows for each column
+    std::size_t chunk_rows;                         //!< Rows per chunk
+    bool compress;                                  //!< Compress chunks with zlib?
+    std::vector<char> buffer;                       //!< Payload of current chunk
+    void writeChunk();                              //!< Write buffered rows, if any
 
   public:
-    FormatSpaceTrajectory(std::ostream& ostream);
-    FormatSpaceTrajectory(std::istream& istream);
-    void load(Space&);       //!< Load single frame from stream
-    void save(const Space&); //!< Save single frame from stream
+    /**
+     * @param filename  output file; compression is enabled for the `.zfcol` suffix
+     * @param columns  name and type of each column
+     * @param chunk_rows  number of rows buffered before writing a chunk
+     * @throw std::runtime_error  if the file cannot be opened
+     */
+    ColumnWriter(const std::string& filename, std::vector<Column> columns, std::size_t chunk_rows = 1024);
+    ~ColumnWriter();
+    ColumnWriter(const ColumnWriter&) = delete;
+    ColumnWriter& operator=(const ColumnWriter&) = delete;
+    void addRow(std::span<const double> values);        //!< Add one value for each column
+    void addRow(std::initializer_list<double> values);  //!< Add one value for each column
+    void flush();                                       //!< Write buffered rows and flush the file
+    static bool isColumnFile(const std::string& filename); //!< True for `.fcol` and `.zfcol` suffixes
+};
+
+/**
+ * @brief Reads all columns written by `ColumnWriter`
+ */
+class ColumnReader {
+    std::ifstream stream;
+    json header;
+
+  public:
+    explicit ColumnReader(const std::string& filename);
+    const json& getHeader() const; //!< Column names and types, compression etc.
+    /**
+     * @brief Read all rows; a truncated chunk at the end of the file is ignored
+     * @return Pairs of column name and values, in column order
+     */
+    std::vector<std::pair<std::string, std::vector<double>>> read();
+};
+
+class Random;
+
+/**
+ * @brief Binary checkpoint of a Space and, optionally, random number generator states
+ *
+ * The checkpoint holds a binary snapshot of the geometry, implicit reservoir and all groups
+ * and their particles, so that `copy()` can be called on the simulation thread while `save()`
+ * runs elsewhere, e.g. in a `BackgroundWriter`. Files are first written to a temporary file
+ * which then replaces the target, so that an existing checkpoint is never partially overwritten.
+ * The topology (atom and molecule types and group layout) is not stored and must match the Space
+ * that the checkpoint is applied to.
+ */
+class SpaceCheckpoint {
+    std::uint64_t topology_hash = 0; //!< See `FormatSpaceTrajectory::topologyHash()`
+    std::string payload;             //!< Cereal archive of geometry, implicit reservoir and groups
+    std::string random_move;         //!< JSON state of move random number generator; empty if not stored
+    std::string random_global;       //!< JSON state of global random number generator; empty if not stored
+
+  public:
+    /**
+     * @brief Take snapshot of space and, if given, random number generators
+     * @param spc Space to copy
+     * @param move_random Optional move random number generator
+     * @param global_random Optional global random number generator
+     */
+    void copy(const Space& spc, const Random* move_random = nullptr, const Random* global_random = nullptr);
+    /**
+     * @brief Restore space from snapshot
+     * @throw std::runtime_error if the topology of `spc` differs from the snapshot
+     */
+    void apply(Space& spc) const;
+    void applyRandom(Random& move_random, Random& global_random) const; //!< Restore stored random generators
+    void save(const std::string& filename) const;                        //!< Atomically replace file with checkpoint
+    void load(const std::string& filename);                              //!< Load checkpoint written by `save()`
+    static bool isCheckpointFile(const std::string& filename);           //!< True for `.ckpt` suffix
 };
 
 } // namespace Faunus
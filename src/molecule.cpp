@@ -13,8 +13,21 @@
 #include <range/v3/algorithm/any_of.hpp>
 #include <range/v3/algorithm/none_of.hpp>
 #include <utility>
+#include <numeric>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <cstdio>
 #include <doctest/doctest.h>
 
+#if __has_include(<sys/mman.h>)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define FAUNUS_HAS_MMAP
+#endif
+
 namespace Faunus {
 
 TEST_SUITE_BEGIN("Molecule");
@@ -79,9 +92,28 @@ void to_json(json &j, const MoleculeData &a) {
     }
 }
 
+/**
+ * A pre-built `trajpacked` library is used in place of `traj` unless `traj` has been
+ * modified after the library was created, in which case the library is rebuilt.
+ */
 void MoleculeData::createMolecularConformations(const json &j) {
     assert(j.is_object());
-    if (auto trajfile = j.value("traj", ""s); not trajfile.empty()) {
+    const auto library_file = j.value("trajpacked", ""s);
+    auto library_is_up_to_date = [&] {
+        if (library_file.empty() || !std::filesystem::exists(library_file)) {
+            return false;
+        }
+        const auto trajectory_file = j.value("traj", ""s);
+        if (!trajectory_file.empty() && std::filesystem::exists(trajectory_file) &&
+            std::filesystem::last_write_time(trajectory_file) > std::filesystem::last_write_time(library_file)) {
+            faunus_logger->warn("{} is older than {} and will be rebuilt", library_file, trajectory_file);
+            return false;
+        }
+        return true;
+    };
+    if (library_is_up_to_date()) { // pre-built library found; ignore `traj`
+        loadConformationLibrary(j, library_file);
+    } else if (auto trajfile = j.value("traj", ""s); not trajfile.empty()) {
         conformations.clear();                                  // remove all previous conformations
         if (j.contains("structure")) {
             throw ConfigurationError("`structure` and `traj` are mutually exclusive");
@@ -123,11 +155,51 @@ void MoleculeData::createMolecularConformations(const json &j) {
             }
         }
 
+        if (!library_file.empty()) {
+            const auto precision = j.value("trajfloat", false) ? PackedConformations::Precision::SINGLE
+                                                               : PackedConformations::Precision::DOUBLE;
+            packConformations(library_file, precision);
+        }
         setConformationWeights(j);
+    } else if (!library_file.empty()) {
+        throw ConfigurationError("{} not found and no `traj` to create it from", library_file);
     }
 }
+
+void MoleculeData::loadConformationLibrary(const json& j, const std::string& filename) {
+    if (j.contains("structure")) {
+        throw ConfigurationError("`structure` and `trajpacked` are mutually exclusive");
+    }
+    try {
+        conformation_library = std::make_shared<PackedConformations>(filename);
+    } catch (std::exception& e) {
+        throw ConfigurationError("error loading {}: {}", filename, e.what());
+    }
+    faunus_logger->debug("{} packed conformations loaded from {}", conformation_library->size(), filename);
+    conformations.clear();
+    conformations.push_back(conformation_library->get(0));
+    atoms.clear();
+    for (const Particle& particle : conformations.data.front()) {
+        atoms.push_back(particle.id);
+    }
+    setConformationWeights(j);
+}
+
+/**
+ * All loaded conformations are packed into `conformation_library` and saved to disk.
+ * Only the first conformation is kept in `conformations` to save memory.
+ */
+void MoleculeData::packConformations(const std::string& filename, PackedConformations::Precision precision) {
+    conformation_library = std::make_shared<PackedConformations>(conformations.data, precision);
+    conformation_library->save(filename);
+    faunus_logger->info("{} conformations packed into {}", conformation_library->size(), filename);
+    const auto first_conformation = conformations.data.front();
+    conformations.clear();
+    conformations.push_back(first_conformation);
+}
+
 void MoleculeData::setConformationWeights(const json& j) {
-    std::vector<float> weights(conformations.size(), 1.0); // default uniform weight
+    std::vector<float> weights(numConformations(), 1.0); // default uniform weight
 
     if (auto filename = j.value("trajweight", ""s); !filename.empty()) {
         std::ifstream stream(filename);
@@ -135,19 +207,23 @@ void MoleculeData::setConformationWeights(const json& j) {
             throw ConfigurationError("{} not found", filename);
         }
         weights.clear();
-        weights.reserve(conformations.size());
+        weights.reserve(numConformations());
         float weight = 1.0;
         while (stream >> weight) {
             weights.push_back(weight);
         }
         stream.close();
-        if (weights.size() != conformations.size()) {
+        if (weights.size() != numConformations()) {
             throw ConfigurationError("{} conformation weights found while expecting {}", weights.size(),
-                                     conformations.size());
+                                     numConformations());
         }
         faunus_logger->info("{} weights loaded from {}", weights.size(), filename);
     }
-    conformations.setWeight(weights.begin(), weights.end());
+    if (conformation_library) {
+        conformation_library->setWeight(weights);
+    } else {
+        conformations.setWeight(weights.begin(), weights.end());
+    }
 }
 
 TEST_CASE("[Faunus] MoleculeData") {
@@ -563,7 +639,9 @@ void from_json(const json &j, MoleculeData &a) {
     builder.from_json(j, a);
 }
 
-size_t MoleculeData::numConformations() const { return conformations.data.size(); }
+size_t MoleculeData::numConformations() const {
+    return conformation_library ? conformation_library->size() : conformations.data.size();
+}
 
 void from_json(const json &j, std::vector<MoleculeData> &v) {
     v.reserve(v.size() + j.size());
@@ -721,7 +799,9 @@ void to_json(json &j, const MoleculeInserter &inserter) { inserter.to_json(j); }
  */
 ParticleVector RandomInserter::operator()(const Geometry::GeometryBase &geo, MoleculeData &molecule,
                                           [[maybe_unused]] const ParticleVector &ignored_other_particles) {
-    auto particles = molecule.conformations.sample(random.engine); // random, weighted conformation
+    auto particles = molecule.conformation_library
+                         ? molecule.conformation_library->get(molecule.conformation_library->sample(random.engine))
+                         : molecule.conformations.sample(random.engine); // random, weighted conformation
     if (particles.empty()) {
         throw std::runtime_error("nothing to insert for molecule '"s + molecule.name + "'");
     }
@@ -757,12 +837,24 @@ void RandomInserter::translateRotateMolecularGroup(const Geometry::GeometryBase&
         Geometry::rotate(particles.begin(), particles.end(), rotator.getQuaternion());
         assert(Geometry::massCenter(particles.begin(), particles.end()).norm() < 1e-6); // cm shouldn't move
     }
-    Point new_mass_center;
-    geo.randompos(new_mass_center, random);                       // random point in container
+    Point new_mass_center = randomPosition(geo);                  // random point in container
     new_mass_center = new_mass_center.cwiseProduct(dir) + offset; // add defined dirs (default: 1,1,1)
     Geometry::translate(particles.begin(), particles.end(), new_mass_center, geo.getBoundaryFunc());
 }
 
+/**
+ * Container overlap is not checked and positions are untouched if `keep_positions` is set.
+ *
+ * @param geo Geometry to use for PBC
+ * @param particles Molecular conformation to place
+ */
+void RandomInserter::placeMolecularGroup(const Geometry::GeometryBase& geo, ParticleVector& particles) const {
+    if (!keep_positions) {
+        QuaternionRotate rotator;
+        translateRotateMolecularGroup(geo, rotator, particles);
+    }
+}
+
 void RandomInserter::translateRotateAtomicGroup(const Geometry::GeometryBase& geo, QuaternionRotate& rotator,
                                                 ParticleVector& particles) const {
     for (auto& particle : particles) { // for each atom type id
@@ -770,12 +862,17 @@ void RandomInserter::translateRotateAtomicGroup(const Geometry::GeometryBase& ge
             rotator.set(2.0 * pc::pi * random(), randomUnitVector(random));
             particle.rotate(rotator.getQuaternion(), rotator.getRotationMatrix());
         }
-        geo.randompos(particle.pos, random);
-        particle.pos = particle.pos.cwiseProduct(dir) + offset;
+        particle.pos = randomPosition(geo).cwiseProduct(dir) + offset;
         geo.boundary(particle.pos);
     }
 }
 
+Point RandomInserter::randomPosition(const Geometry::GeometryBase& geo) const {
+    Point position;
+    geo.randompos(position, random);
+    return position;
+}
+
 void RandomInserter::from_json(const json &j) {
     dir = j.value("insdir", dir);
     offset = j.value("insoffset", offset);
@@ -791,6 +888,416 @@ void RandomInserter::to_json(json &j) const {
     j["allow overlap"] = allow_overlap;
 }
 
+CavityInserter::CavityInserter(const double maximum_cell_length) : maximum_cell_length(maximum_cell_length) {
+    if (maximum_cell_length <= 0.0) {
+        throw ConfigurationError("cavity cell length must be positive");
+    }
+}
+
+void CavityInserter::resetGrid(const Point& new_box_length) {
+    box_length = new_box_length;
+    number_of_cells = (box_length / maximum_cell_length).array().ceil().cast<int>().max(1);
+    cell_length = box_length.cwiseQuotient(number_of_cells.cast<double>());
+    const auto total_number_of_cells = number_of_cells.prod();
+    occupancy.assign(total_number_of_cells, 0);
+    particle_cells.clear();
+    empty_cells.resize(total_number_of_cells);
+    std::iota(empty_cells.begin(), empty_cells.end(), 0);
+    empty_cell_positions = empty_cells;
+}
+
+/**
+ * @param position Position in a box centered at the origin
+ */
+int CavityInserter::cellIndex(const Point& position) const {
+    const Eigen::Vector3i cell = ((position + 0.5 * box_length).cwiseQuotient(cell_length))
+                                     .array()
+                                     .floor()
+                                     .cast<int>()
+                                     .max(0)
+                                     .min(number_of_cells.array() - 1);
+    return cell.x() + number_of_cells.x() * (cell.y() + number_of_cells.y() * cell.z());
+}
+
+void CavityInserter::addToCell(const int cell) {
+    if (occupancy[cell]++ == 0) { // swap with last empty cell and remove
+        const auto position = empty_cell_positions[cell];
+        empty_cells[position] = empty_cells.back();
+        empty_cell_positions[empty_cells[position]] = position;
+        empty_cells.pop_back();
+        empty_cell_positions[cell] = -1;
+    }
+}
+
+void CavityInserter::removeFromCell(const int cell) {
+    if (--occupancy[cell] == 0) {
+        empty_cell_positions[cell] = static_cast<int>(empty_cells.size());
+        empty_cells.push_back(cell);
+    }
+}
+
+double CavityInserter::emptyVolumeFraction() const {
+    return occupancy.empty() ? 0.0 : static_cast<double>(empty_cells.size()) / occupancy.size();
+}
+
+/**
+ * @param position Position in a box centered at the origin
+ * @returns True if no particles were in the cell at the latest update
+ */
+bool CavityInserter::isEmpty(const Point& position) const {
+    return occupancy.at(cellIndex(position)) == 0;
+}
+
+Point CavityInserter::randomPosition([[maybe_unused]] const Geometry::GeometryBase& geo) const {
+    return randomEmptyPosition(random);
+}
+
+/**
+ * @param random Random number generator to draw the cell and the position within it
+ * @throws std::runtime_error if there are no empty cells
+ */
+Point CavityInserter::randomEmptyPosition(Random& random) const {
+    if (empty_cells.empty()) {
+        throw std::runtime_error("no empty cells available for cavity insertion");
+    }
+    const auto index = *random.sample(empty_cells.begin(), empty_cells.end());
+    const Eigen::Vector3i cell(index % number_of_cells.x(), (index / number_of_cells.x()) % number_of_cells.y(),
+                               index / (number_of_cells.x() * number_of_cells.y()));
+    const Point random_fraction(random(), random(), random());
+    return (cell.cast<double>() + random_fraction).cwiseProduct(cell_length) - 0.5 * box_length;
+}
+
+/**
+ * Insertions into occupied cells are assumed to overlap. For a point inserted anywhere
+ * in a cell holding a particle, this is guaranteed if, for some atom of the molecule, the
+ * cell diagonal plus the atom's distance from the inserted point is shorter than the contact
+ * distance, (σᵢ + σⱼ) / 2, to any atom type j. For molecular groups the inserted point is the
+ * mass center of the first conformation; for atomic groups it is each atom.
+ */
+void CavityInserter::checkCellSize(const MoleculeData& molecule) const {
+    if (Faunus::atoms.empty()) {
+        return;
+    }
+    const auto cell_diagonal = std::sqrt(3.0) * maximum_cell_length;
+    auto contact = [](const double sigma) { // shortest contact distance to any atom type
+        auto smallest_sigma = std::numeric_limits<double>::max();
+        for (const auto& other : Faunus::atoms) {
+            smallest_sigma = std::min(smallest_sigma, other.sigma);
+        }
+        return 0.5 * (sigma + smallest_sigma);
+    };
+    double contact_distance = pc::infty;
+    if (molecule.atomic || molecule.conformations.empty()) {
+        for (const auto atomid : molecule.atoms) {
+            contact_distance = std::min(contact_distance, contact(Faunus::atoms.at(atomid).sigma));
+        }
+    } else {
+        const auto& particles = molecule.conformations.data.front();
+        const auto mass_center = Geometry::massCenter(particles.begin(), particles.end());
+        contact_distance = -pc::infty;
+        for (const auto& particle : particles) {
+            const auto distance_from_mass_center = (particle.pos - mass_center).norm();
+            contact_distance = std::max(contact_distance, contact(particle.traits().sigma) - distance_from_mass_center);
+        }
+    }
+    if (cell_diagonal >= contact_distance) {
+        faunus_logger->warn("cavity cell diagonal ({:.2f} Å) exceeds the {} contact distance ({:.2f} Å); cavity bias "
+                            "may underestimate insertion probabilities",
+                            cell_diagonal, molecule.name, contact_distance);
+    }
+}
+
+void CavityInserter::to_json(json& j) const {
+    RandomInserter::to_json(j);
+    j["cavity cell length"] = maximum_cell_length;
+    j["empty volume fraction"] = emptyVolumeFraction();
+}
+
+TEST_CASE("[Faunus] CavityInserter") {
+    CavityInserter inserter(5.0);
+    ParticleVector particles(2);
+    particles[0].pos = {-2.0, -2.0, -2.0};
+    particles[1].pos = {-3.0, -1.0, -4.0}; // same cell as first particle
+    inserter.update(Point(10.0, 10.0, 10.0), particles);
+    CHECK(inserter.emptyVolumeFraction() == doctest::Approx(7.0 / 8.0));
+    particles[1].pos = {2.0, 2.0, 2.0};
+    inserter.update(Point(10.0, 10.0, 10.0), particles);
+    CHECK(inserter.emptyVolumeFraction() == doctest::Approx(6.0 / 8.0));
+    CHECK(inserter.isEmpty({2.0, -2.0, 2.0}));
+    CHECK_FALSE(inserter.isEmpty({4.0, 4.0, 4.0}));
+    inserter.update(Point(4.0, 4.0, 4.0), particles); // single cell
+    CHECK(inserter.emptyVolumeFraction() == doctest::Approx(0.0));
+    inserter.update(Point(12.0, 12.0, 12.0), particles); // 2.4 cells per side are rounded up to three
+    CHECK(inserter.emptyVolumeFraction() == doctest::Approx(25.0 / 27.0));
+
+    SUBCASE("incremental update") {
+        inserter.update(Point(10.0, 10.0, 10.0), particles);
+        CHECK(inserter.emptyVolumeFraction() == doctest::Approx(6.0 / 8.0));
+        particles[1].pos = {-1.0, -1.0, -1.0}; // join the first particle
+        inserter.update(Point(10.0, 10.0, 10.0), particles);
+        CHECK(inserter.emptyVolumeFraction() == doctest::Approx(7.0 / 8.0));
+        particles.pop_back();
+        particles[0].pos = {2.0, -2.0, 2.0}; // move to another cell
+        inserter.update(Point(10.0, 10.0, 10.0), particles);
+        CHECK(inserter.emptyVolumeFraction() == doctest::Approx(7.0 / 8.0));
+        inserter.update(Point(10.0, 10.0, 10.0), ParticleVector());
+        CHECK(inserter.emptyVolumeFraction() == doctest::Approx(1.0));
+    }
+}
+
+PackedConformations::PackedConformations(const std::vector<ParticleVector>& conformations, Precision precision) {
+    if (conformations.empty()) {
+        throw std::runtime_error("no conformations to pack");
+    }
+    header = {file_magic, file_version, static_cast<std::uint32_t>(precision), conformations.size(),
+              conformations.front().size()};
+    const auto buffer = std::shared_ptr<std::byte>(new std::byte[totalSize()], std::default_delete<std::byte[]>());
+    std::memset(buffer.get(), 0, totalSize());
+    std::memcpy(buffer.get(), &header, sizeof(Header));
+    storage = buffer;
+    setPointers();
+
+    auto ids = reinterpret_cast<std::int32_t*>(buffer.get() + sizeof(Header));
+    std::transform(conformations.front().begin(), conformations.front().end(), ids,
+                   [](const Particle& particle) { return static_cast<std::int32_t>(particle.id); });
+
+    auto pack = [&](auto value_type) {
+        using T = decltype(value_type);
+        auto values = reinterpret_cast<T*>(buffer.get() + (blocks - storage.get()));
+        for (const auto& conformation : conformations) {
+            if (conformation.size() != numParticles()) {
+                throw std::runtime_error("all conformations must have the same number of particles");
+            }
+            for (const auto& particle : conformation) { // positions...
+                *values++ = static_cast<T>(particle.pos.x());
+                *values++ = static_cast<T>(particle.pos.y());
+                *values++ = static_cast<T>(particle.pos.z());
+            }
+            for (const auto& particle : conformation) { // ...followed by charges
+                *values++ = static_cast<T>(particle.charge);
+            }
+        }
+    };
+    if (precision == Precision::SINGLE) {
+        pack(float());
+    } else {
+        pack(double());
+    }
+    setWeight(std::vector<float>(size(), 1.0f));
+}
+
+/**
+ * If supported by the platform, the file is memory mapped; otherwise it is read into memory.
+ */
+PackedConformations::PackedConformations(const std::string& filename) {
+    std::size_t file_size = 0;
+#ifdef FAUNUS_HAS_MMAP
+    const auto file_descriptor = ::open(filename.c_str(), O_RDONLY);
+    if (file_descriptor < 0) {
+        throw std::runtime_error("cannot open " + filename);
+    }
+    struct stat file_status {};
+    if (::fstat(file_descriptor, &file_status) != 0 || file_status.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(file_descriptor);
+        throw std::runtime_error(filename + " is not a conformation library");
+    }
+    file_size = static_cast<std::size_t>(file_status.st_size);
+    void* address = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    ::close(file_descriptor); // mapping remains valid after closing
+    if (address == MAP_FAILED) {
+        throw std::runtime_error("cannot memory map " + filename);
+    }
+    storage = std::shared_ptr<const std::byte>(static_cast<const std::byte*>(address), [file_size](const std::byte* data) {
+        ::munmap(const_cast<std::byte*>(data), file_size);
+    });
+    memory_mapped = true;
+#else
+    std::ifstream stream(filename, std::ios::binary | std::ios::ate);
+    if (!stream) {
+        throw std::runtime_error("cannot open " + filename);
+    }
+    file_size = static_cast<std::size_t>(stream.tellg());
+    if (file_size < sizeof(Header)) {
+        throw std::runtime_error(filename + " is not a conformation library");
+    }
+    const auto buffer = std::shared_ptr<std::byte>(new std::byte[file_size], std::default_delete<std::byte[]>());
+    stream.seekg(0);
+    stream.read(reinterpret_cast<char*>(buffer.get()), static_cast<std::streamsize>(file_size));
+    storage = buffer;
+#endif
+    std::memcpy(&header, storage.get(), sizeof(Header));
+    if (header.magic != file_magic || header.version != file_version) {
+        throw std::runtime_error(filename + " is not a conformation library");
+    }
+    if (header.precision != static_cast<std::uint32_t>(Precision::SINGLE) &&
+        header.precision != static_cast<std::uint32_t>(Precision::DOUBLE)) {
+        throw std::runtime_error(filename + ": unknown precision");
+    }
+    if (size() == 0 || file_size != totalSize()) {
+        throw std::runtime_error(filename + ": unexpected file size");
+    }
+    setPointers();
+    setWeight(std::vector<float>(size(), 1.0f));
+}
+
+void PackedConformations::save(const std::string& filename) const {
+    std::ofstream stream(filename, std::ios::binary);
+    if (!stream) {
+        throw std::runtime_error("cannot write to " + filename);
+    }
+    stream.write(reinterpret_cast<const char*>(storage.get()), static_cast<std::streamsize>(totalSize()));
+}
+
+std::size_t PackedConformations::blockSize() const { return 4 * numParticles() * header.precision; }
+
+/**
+ * Atom ids are padded to a multiple of eight bytes, so that all blocks are aligned
+ */
+std::size_t PackedConformations::totalSize() const {
+    const auto ids_size = (numParticles() * sizeof(std::int32_t) + 7) / 8 * 8;
+    return sizeof(Header) + ids_size + size() * blockSize();
+}
+
+void PackedConformations::setPointers() {
+    atom_ids = reinterpret_cast<const std::int32_t*>(storage.get() + sizeof(Header));
+    blocks = storage.get() + (totalSize() - size() * blockSize());
+}
+
+std::size_t PackedConformations::size() const { return header.number_of_conformations; }
+
+std::size_t PackedConformations::numParticles() const { return header.number_of_particles; }
+
+PackedConformations::Precision PackedConformations::precision() const {
+    return static_cast<Precision>(header.precision);
+}
+
+bool PackedConformations::isMemoryMapped() const { return memory_mapped; }
+
+ParticleVector PackedConformations::get(std::size_t index) const {
+    ParticleVector particles(numParticles());
+    for (std::size_t i = 0; i < particles.size(); ++i) {
+        particles[i].id = atom_ids[i];
+    }
+    copyTo(index, particles.begin());
+    return particles;
+}
+
+template <typename T>
+void PackedConformations::copy(std::size_t index, ParticleVector::iterator destination, bool copy_positions,
+                               bool copy_charges) const {
+    const auto positions = reinterpret_cast<const T*>(blocks + index * blockSize());
+    const auto charges = positions + 3 * numParticles();
+    for (std::size_t i = 0; i < numParticles(); ++i, ++destination) {
+        if (copy_positions) {
+            destination->pos = {positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]};
+        }
+        if (copy_charges) {
+            destination->charge = charges[i];
+        }
+    }
+}
+
+void PackedConformations::copyTo(std::size_t index, ParticleVector::iterator destination, bool copy_positions,
+                                 bool copy_charges) const {
+    if (index >= size()) {
+        throw std::out_of_range("conformation index out of range");
+    }
+    if (precision() == Precision::SINGLE) {
+        copy<float>(index, destination, copy_positions, copy_charges);
+    } else {
+        copy<double>(index, destination, copy_positions, copy_charges);
+    }
+}
+
+void PackedConformations::setWeight(const std::vector<float>& weights) {
+    if (weights.size() != size()) {
+        throw std::runtime_error("number of weights must match number of conformations");
+    }
+    distribution = std::discrete_distribution<std::size_t>(weights.begin(), weights.end());
+}
+
+TEST_CASE("[Faunus] PackedConformations") {
+    std::vector<ParticleVector> conformations(2, ParticleVector(3));
+    for (std::size_t i = 0; i < conformations.size(); ++i) {
+        for (std::size_t j = 0; j < conformations[i].size(); ++j) {
+            conformations[i][j].id = static_cast<int>(j);
+            conformations[i][j].pos = {0.1 * i, 1.0 + j, -2.0 * j};
+            conformations[i][j].charge = 0.5 * (i + j);
+        }
+    }
+    auto check_equal = [&](const PackedConformations& library) {
+        CHECK_EQ(library.size(), 2);
+        CHECK_EQ(library.numParticles(), 3);
+        for (std::size_t i = 0; i < conformations.size(); ++i) {
+            const auto particles = library.get(i);
+            for (std::size_t j = 0; j < particles.size(); ++j) {
+                CHECK_EQ(particles[j].id, conformations[i][j].id);
+                CHECK(particles[j].charge == doctest::Approx(conformations[i][j].charge));
+                CHECK(particles[j].pos.isApprox(conformations[i][j].pos, 1e-6));
+            }
+        }
+    };
+    SUBCASE("Single and double precision") {
+        check_equal(PackedConformations(conformations, PackedConformations::Precision::SINGLE));
+        check_equal(PackedConformations(conformations, PackedConformations::Precision::DOUBLE));
+    }
+    SUBCASE("Copy selected properties") {
+        PackedConformations library(conformations, PackedConformations::Precision::DOUBLE);
+        ParticleVector particles(3);
+        library.copyTo(1, particles.begin(), false, true);
+        CHECK(particles[2].charge == doctest::Approx(1.5));
+        CHECK(particles[2].pos.isZero());
+        CHECK_THROWS(library.copyTo(2, particles.begin()));
+    }
+    SUBCASE("Save and load") {
+        const std::string filename = "packed_conformations_test.bin";
+        PackedConformations(conformations, PackedConformations::Precision::SINGLE).save(filename);
+        {
+            PackedConformations library(filename);
+            CHECK_EQ(library.precision(), PackedConformations::Precision::SINGLE);
+#ifdef FAUNUS_HAS_MMAP
+            CHECK(library.isMemoryMapped());
+#endif
+            check_equal(library);
+        }
+        std::ofstream(filename, std::ios::binary | std::ios::app) << "junk";
+        CHECK_THROWS(PackedConformations(filename));
+        std::remove(filename.c_str());
+    }
+}
+
+TEST_CASE("[Faunus] MoleculeData - stale packed conformations") {
+    const auto original_atoms = Faunus::atoms;
+    Faunus::atoms = R"([{"A": {"sigma": 2.0}}])"_json.get<decltype(Faunus::atoms)>();
+    const std::string trajectory_file = "stale_packed_test.pqr";
+    const std::string library_file = "stale_packed_test.bin";
+    const json input = {{"traj", trajectory_file}, {"trajpacked", library_file}};
+    auto write_trajectory = [&](const double separation) {
+        std::ofstream(trajectory_file) << fmt::format("ATOM 1 A A 1 0.0 0.0 0.0 0.0 1.0\n"
+                                                      "ATOM 2 A A 1 {} 0.0 0.0 0.0 1.0\nEND\n",
+                                                      separation);
+    };
+    auto loaded_separation = [&] {
+        MoleculeData molecule;
+        molecule.createMolecularConformations(input);
+        REQUIRE(molecule.conformation_library);
+        const auto particles = molecule.conformation_library->get(0);
+        return (particles.at(1).pos - particles.at(0).pos).norm();
+    };
+    write_trajectory(2.0);
+    CHECK(loaded_separation() == doctest::Approx(2.0)); // library created
+    CHECK(loaded_separation() == doctest::Approx(2.0)); // library loaded
+
+    write_trajectory(4.0); // trajectory newer than library
+    std::filesystem::last_write_time(library_file,
+                                     std::filesystem::last_write_time(trajectory_file) - std::chrono::hours(1));
+    CHECK(loaded_separation() == doctest::Approx(4.0)); // library rebuilt
+
+    std::remove(trajectory_file.c_str());
+    std::remove(library_file.c_str());
+    Faunus::atoms = original_atoms;
+}
+
 bool Conformation::empty() const {
     return positions.empty() && charges.empty();
 }
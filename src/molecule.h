@@ -5,6 +5,8 @@
 #include "particle.h"
 #include "random.h"
 #include <set>
+#include <array>
+#include <cstdint>
 
 namespace Faunus {
 
@@ -51,6 +53,9 @@ class RandomInserter : public MoleculeInserter {
     void translateRotateMolecularGroup(const Geometry::GeometryBase& geo, QuaternionRotate& rotator,
                                        ParticleVector& particles) const;
 
+  protected:
+    virtual Point randomPosition(const Geometry::GeometryBase& geo) const; //!< Random point in container
+
   public:
     Point dir = {1, 1, 1};       //!< Scalars for random mass center position. Default (1,1,1)
     Point offset = {0, 0, 0};    //!< Added to random position. Default (0,0,0)
@@ -61,10 +66,79 @@ class RandomInserter : public MoleculeInserter {
 
     ParticleVector operator()(const Geometry::GeometryBase &geo, MoleculeData &molecule,
                               const ParticleVector &ignored_other_particles = ParticleVector()) override;
+    void placeMolecularGroup(const Geometry::GeometryBase& geo,
+                             ParticleVector& particles) const; //!< Rotate and translate as upon insertion
     void from_json(const json &j) override;
     void to_json(json &j) const override;
 };
 
+/**
+ * @brief Inserts molecules into randomly selected empty cells of a grid (cavity bias)
+ *
+ * The cuboidal container is divided into cells no longer than a given length and `update()`
+ * marks all cells holding a particle as occupied. Mass centers, or atom positions for atomic
+ * molecules, are then drawn uniformly within the empty cells only. If insertions into occupied
+ * cells have a vanishing Boltzmann factor, which holds if the cell diagonal is shorter than the
+ * contact distance (see `checkCellSize()`), unbiased averages are obtained by weighting with
+ * `emptyVolumeFraction()` for each inserted point, i.e. once per atom for atomic molecules.
+ *
+ * The grid is updated incrementally: each particle's cell is recomputed, but only cells
+ * whose occupancy changes are touched. An update hence costs O(N) cell look-ups, and the
+ * full grid is reset only when the box dimensions change.
+ */
+class CavityInserter : public RandomInserter {
+  private:
+    double maximum_cell_length;                         //!< Cells are at most this long (Å)
+    Point box_length = {0.0, 0.0, 0.0};                 //!< Container dimensions
+    Point cell_length = {0.0, 0.0, 0.0};                //!< Actual cell dimensions
+    Eigen::Vector3i number_of_cells = {0, 0, 0};        //!< Cells in each direction
+    std::vector<int> occupancy;                         //!< Number of particles in each cell
+    std::vector<int> particle_cells;                    //!< Cell of each particle at the latest update
+    std::vector<int> empty_cells;                       //!< Indices of empty cells
+    std::vector<int> empty_cell_positions;              //!< Position of each cell in `empty_cells`; -1 if occupied
+    void resetGrid(const Point& new_box_length);        //!< Resize grid and mark all cells as empty
+    int cellIndex(const Point& position) const;         //!< Index of cell containing position
+    void addToCell(int cell);                           //!< Increase occupancy; remove from `empty_cells` if needed
+    void removeFromCell(int cell);                      //!< Decrease occupancy; add to `empty_cells` if needed
+    Point randomPosition(const Geometry::GeometryBase& geo) const override; //!< Random point in empty cell
+
+  public:
+    explicit CavityInserter(double maximum_cell_length);
+    double emptyVolumeFraction() const;                   //!< Fraction of cells that are empty
+    bool isEmpty(const Point& position) const;            //!< Is the cell containing position empty?
+    Point randomEmptyPosition(Random& random) const;      //!< Random point in a random empty cell
+    void checkCellSize(const MoleculeData& molecule) const; //!< Warn if cells may hold non-overlapping insertions
+
+    /**
+     * @brief Mark cells occupied by particles, centered in a box of given dimensions
+     * @param new_box_length Container dimensions
+     * @param particles Range of particles
+     */
+    template <typename TParticleRange> void update(const Point& new_box_length, const TParticleRange& particles) {
+        if (new_box_length != box_length) {
+            resetGrid(new_box_length);
+        }
+        std::size_t particle_index = 0;
+        for (const auto& particle : particles) {
+            const auto cell = cellIndex(particle.pos);
+            if (particle_index == particle_cells.size()) {
+                addToCell(cell);
+                particle_cells.push_back(cell);
+            } else if (auto& previous_cell = particle_cells[particle_index]; previous_cell != cell) {
+                removeFromCell(previous_cell);
+                addToCell(cell);
+                previous_cell = cell;
+            }
+            ++particle_index;
+        }
+        while (particle_cells.size() > particle_index) { // fewer particles than before
+            removeFromCell(particle_cells.back());
+            particle_cells.pop_back();
+        }
+    }
+    void to_json(json& j) const override;
+};
+
 /**
  * Possible structure for molecular conformations
  */
@@ -75,6 +149,66 @@ struct Conformation {
     void copyTo(ParticleVector &particles) const; //!< Copy conformation into particle vector
 };
 
+/**
+ * @brief Compact library of molecular conformations with atom ids, positions, and charges only
+ *
+ * All conformations are stored in a single, contiguous block in either single or double precision.
+ * Each conformation occupies a block of positions (x,y,z for each particle) followed by charges.
+ * The library can be saved to a binary file which is later memory mapped, whereby large libraries
+ * load without parsing and data is read from disk only when needed. The file uses native byte
+ * order and is not portable between architectures of different endianness.
+ */
+class PackedConformations {
+  public:
+    enum class Precision : std::uint32_t { SINGLE = sizeof(float), DOUBLE = sizeof(double) };
+
+  private:
+    struct Header {
+        std::array<char, 8> magic;
+        std::uint32_t version;
+        std::uint32_t precision;
+        std::uint64_t number_of_conformations;
+        std::uint64_t number_of_particles;
+    };
+    static constexpr std::array<char, 8> file_magic = {'F', 'A', 'U', 'N', 'C', 'O', 'N', 'F'};
+    static constexpr std::uint32_t file_version = 1;
+    Header header;
+    std::shared_ptr<const std::byte> storage;            //!< Owned buffer or memory mapped file incl. header
+    const std::int32_t* atom_ids = nullptr;              //!< Atom id of each particle
+    const std::byte* blocks = nullptr;                   //!< First conformation block
+    bool memory_mapped = false;                          //!< True if `storage` is a memory mapped file
+    std::discrete_distribution<std::size_t> distribution; //!< Weighted selection of conformations
+    std::size_t blockSize() const;                       //!< Bytes per conformation
+    std::size_t totalSize() const;                       //!< Bytes incl. header and atom ids
+    void setPointers();                                  //!< Set `atom_ids` and `blocks` from `storage`
+    template <typename T>
+    void copy(std::size_t index, ParticleVector::iterator destination, bool copy_positions, bool copy_charges) const;
+
+  public:
+    PackedConformations(const std::vector<ParticleVector>& conformations, Precision precision);
+    explicit PackedConformations(const std::string& filename); //!< Load (memory map if possible) from file
+    void save(const std::string& filename) const;              //!< Save to binary file
+    std::size_t size() const;                                  //!< Number of conformations
+    std::size_t numParticles() const;                          //!< Number of particles in each conformation
+    Precision precision() const;
+    bool isMemoryMapped() const;
+    ParticleVector get(std::size_t index) const; //!< Unpack conformation incl. atom ids
+
+    /**
+     * @brief Copy conformation directly into existing particles
+     * @param index Conformation index
+     * @param destination Iterator to first of `numParticles()` particles
+     * @param copy_positions Copy positions
+     * @param copy_charges Copy charges
+     */
+    void copyTo(std::size_t index, ParticleVector::iterator destination, bool copy_positions = true,
+                bool copy_charges = true) const;
+    void setWeight(const std::vector<float>& weights); //!< Relative weights used by `sample()`
+
+    /** @brief Index of random conformation respecting the weights */
+    template <typename RandomGenerator> std::size_t sample(RandomGenerator& engine) { return distribution(engine); }
+};
+
 /**
  * @brief Determines if two particles within a group are excluded from mutual nonbonded interactions.
  *
@@ -202,6 +336,8 @@ class MoleculeData {
     const index_type& id() const;                     //!< Type id
     void createMolecularConformations(const json& j); //!< Add conformations if appropriate
     void setConformationWeights(const json& j);       //!< Add weights for conformations
+    void loadConformationLibrary(const json& j, const std::string& filename); //!< Load packed conformations
+    void packConformations(const std::string& filename, PackedConformations::Precision precision); //!< Pack and save
 
     std::string name;            //!< Molecule name
     bool atomic = false;         //!< True if atomic group (salt etc.)
@@ -212,6 +348,7 @@ class MoleculeData {
     std::vector<AtomData::index_type> atoms; //!< Sequence of atoms in molecule (atom id's)
     BasePointerVector<Potential::BondData> bonds;
     WeightedDistribution<ParticleVector> conformations; //!< Conformations of molecule
+    std::shared_ptr<PackedConformations> conformation_library; //!< If set, replaces all but first of `conformations`
     size_t numConformations() const;                    //!< Number of conformations
 
     MoleculeData();
@@ -1,9 +1,17 @@
+#include <doctest/doctest.h>
 #include "montecarlo.h"
 #include "speciation.h"
 #include "energy.h"
 #include "move.h"
+#include "io.h"
+#include "analysis.h"
 #include "spdlog/spdlog.h"
 #include <range/v3/algorithm/for_each.hpp>
+#include <numeric>
+#include <exception>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace Faunus {
 
@@ -14,12 +22,31 @@ namespace Faunus {
  *       when using some MPI schemes where the simulations must be in sync.
  */
 bool MetropolisMonteCarlo::metropolisCriterion(const double energy_change) {
+    return metropolisCriterion(energy_change, Move::MoveBase::slump);
+}
+
+/**
+ * @param energy_change Energy change, (new minus old) in units of kT
+ * @param random Random number generator to draw from; always propagated
+ * @return True if accepted, false of rejected
+ */
+bool MetropolisMonteCarlo::metropolisCriterion(const double energy_change, Random& random) {
+    const auto random_number_between_zero_and_one = random(); // engine *must* be propagated!
+    return metropolisCriterion(energy_change, random_number_between_zero_and_one);
+}
+
+/**
+ * @param energy_change Energy change, (new minus old) in units of kT
+ * @param random_number_between_zero_and_one Pre-drawn uniform random number in the interval [0:1)
+ * @return True if accepted, false of rejected
+ */
+bool MetropolisMonteCarlo::metropolisCriterion(const double energy_change,
+                                               const double random_number_between_zero_and_one) {
     static_assert(std::numeric_limits<double>::is_iec559, "IEEE 754 required");
     if (std::isnan(energy_change)) {
         throw std::runtime_error("Metropolis error: energy cannot be NaN");
     }
-    const auto random_number_between_zero_and_one = Move::MoveBase::slump(); // engine *must* be propagated!
-    if (std::isinf(energy_change) && energy_change < 0.0) {                  // if negative infinity -> quietly accept
+    if (std::isinf(energy_change) && energy_change < 0.0) { // if negative infinity -> quietly accept
         return true;
     }
     if (-energy_change > pc::max_exp_argument) { // if large negative value -> accept with warning
@@ -47,6 +74,7 @@ void MetropolisMonteCarlo::init() {
     state->pot->init();
     auto energy = state->pot->energy(change);
     initial_energy = energy;
+    state->pot->resetTrackedEnergies(state->pot->latestEnergies());
     faunus_logger->log(std::isfinite(initial_energy) ? spdlog::level::info : spdlog::level::warn,
                        "initial energy = {:.6E} kT", initial_energy);
 
@@ -61,6 +89,12 @@ void MetropolisMonteCarlo::init() {
             throw std::runtime_error("error aligning energies - this could be a bug...");
         }
     }
+    if (checkerboard) {
+        checkerboard->synchronize(*state);
+    }
+    if (moves) {
+        moves->notifySystemChange(change);
+    }
 }
 
 /**
@@ -96,7 +130,14 @@ MetropolisMonteCarlo::MetropolisMonteCarlo(const json &j)
     faunus_logger->set_level(spdlog::level::off); // do not duplicate log info
     trial_state = std::make_unique<State>(j);     // ...for the trial state
     faunus_logger->set_level(original_log_level); // restore original log level
-    moves = std::make_unique<Move::MoveCollection>(j.at("moves"), *trial_state->spc, *trial_state->pot, *state->spc);
+    moves = std::make_unique<Move::MoveCollection>(j.at("moves"), *trial_state->spc, *trial_state->pot, *state->spc,
+                                                   j);
+    if (const auto it = j.find("moveschedule"); it != j.end()) {
+        moves->setAdaptiveSchedule(*it);
+    }
+    if (const auto it = j.find("checkerboard"); it != j.end()) {
+        checkerboard = std::make_unique<CheckerboardSweep>(*it, j, *state);
+    }
     init();
 }
 
@@ -124,8 +165,24 @@ void MetropolisMonteCarlo::restore(const json &j) {
     }
 }
 
+/**
+ * Unlike the json state, the checkpoint does not hold the topology which is
+ * instead taken from the input and must match the checkpoint.
+ */
+void MetropolisMonteCarlo::restore(const SpaceCheckpoint& checkpoint) {
+    try {
+        checkpoint.apply(*state->spc);
+        checkpoint.apply(*trial_state->spc);
+        checkpoint.applyRandom(Move::MoveBase::slump, Faunus::random);
+        init();
+    } catch (std::exception& e) {
+        throw std::runtime_error("error initialising simulation: "s + e.what());
+    }
+}
+
 void MetropolisMonteCarlo::performMove(Move::MoveBase& move) {
-    Change change;
+    [[maybe_unused]] const auto heap_allocations_before_move = heapAllocationCount();
+    auto& change = latest_change; // cleared by the move, but allocated memory is kept
     move.move(change);
 #ifndef NDEBUG
     try {
@@ -136,22 +193,38 @@ void MetropolisMonteCarlo::performMove(Move::MoveBase& move) {
 #endif
     if (change) {
         latest_move_name = move.getName();
-        trial_state->pot->updateState(change);                    // update energy terms to reflect change
-        const auto new_energy = trial_state->pot->energy(change); // trial potential energy (kT)
-        const auto old_energy = state->pot->energy(change);       // potential energy before move (kT)
+        trial_state->pot->updateState(change); // update energy terms to reflect change
 
+        double new_energy = 0.0;
+        double old_energy = 0.0;
+        double energy_bias = 0.0;
+        double random_number = 0.0;
+        if (trial_state->pot->earlyRejection() && move.energyIndependentBias()) {
+            // draw the threshold first so that the trial energy can be abandoned once acceptance is impossible
+            old_energy = state->pot->energy(change);
+            random_number = Move::MoveBase::slump(); // engine *must* be propagated!
+            energy_bias = move.bias(change, old_energy, old_energy) +
+                          TranslationalEntropy(*trial_state->spc, *state->spc).energy(change);
+            const auto maximum_new_energy = old_energy - std::log(random_number) - energy_bias;
+            new_energy = trial_state->pot->energy(change, maximum_new_energy);
+        } else {
+            new_energy = trial_state->pot->energy(change); // trial potential energy (kT)
+            old_energy = state->pot->energy(change);       // potential energy before move (kT)
+            energy_bias = move.bias(change, old_energy, new_energy) +
+                          TranslationalEntropy(*trial_state->spc, *state->spc).energy(change);
+            random_number = Move::MoveBase::slump(); // engine *must* be propagated!
+        }
         auto energy_change = getEnergyChange(new_energy, old_energy);
 
-        const auto energy_bias = move.bias(change, old_energy, new_energy) +
-                                 TranslationalEntropy(*trial_state->spc, *state->spc).energy(change);
-
         const auto total_trial_energy = energy_change + energy_bias;
         if (std::isnan(total_trial_energy)) {
             faunus_logger->error("NaN energy change in {} move.", move.getName());
         }
-        if (metropolisCriterion(total_trial_energy)) { // accept move
+        if (metropolisCriterion(total_trial_energy, random_number)) { // accept move
+            state->pot->trackAcceptedChange(trial_state->pot->latestEnergies()); // before sync copies the energies
             state->sync(*trial_state, change);
             move.accept(change);
+            moves->notifySystemChange(change);
         } else { // reject move
             trial_state->sync(*state, change);
             move.reject(change);
@@ -166,13 +239,16 @@ void MetropolisMonteCarlo::performMove(Move::MoveBase& move) {
         // Alternatively, we could use `engine.discard()`
         Move::MoveBase::slump();
     }
+#ifdef FAUNUS_COUNT_ALLOCATIONS
+    heap_allocations[move.getName()] += static_cast<double>(heapAllocationCount() - heap_allocations_before_move);
+#endif
 }
 
 /**
  * Policies for infinite/nan energy changes
  * @return modified energy change, new_energy - old_energy
  */
-double MetropolisMonteCarlo::getEnergyChange(const double new_energy, const double old_energy) const {
+double MetropolisMonteCarlo::getEnergyChange(const double new_energy, const double old_energy) {
     if (std::isnan(old_energy) and !std::isnan(new_energy)) { // if NaN --> finite energy change
         return pc::neg_infty;                                 // ...always accept
     }
@@ -195,12 +271,24 @@ double MetropolisMonteCarlo::getEnergyChange(const double new_energy, const doub
  * are randomly picked and, if needed, repeated (randomly).
  * Next, static moves are performed. Currently static moves
  * are defined by setting `weight=0`.
+ * If enabled, a parallel checkerboard sweep is performed before the moves.
  *
  * @todo using `weight` to mark as move as static is ugly
  */
 void MetropolisMonteCarlo::sweep() {
     assert(moves);
     number_of_sweeps++;
+    if (checkerboard) {
+        sum_of_energy_changes += checkerboard->sweep(*state, *trial_state, Move::MoveBase::slump);
+        state->pot->resetTrackedEnergies({}); // per term changes are not collected by the workers
+        Change change;
+        change.everything = true;
+        moves->notifySystemChange(change);
+        if (std::isfinite(initial_energy)) {
+            average_energy += initial_energy + sum_of_energy_changes;
+        }
+    }
+    moves->updateSchedule(number_of_sweeps);
     auto perform_single_move = [&](auto& move) { performMove(*move); };
     ranges::cpp20::for_each(moves->repeatedStochasticMoves(), perform_single_move);
     ranges::cpp20::for_each(moves->constantIntervalMoves(number_of_sweeps), perform_single_move);
@@ -227,13 +315,421 @@ void to_json(json& j, const MetropolisMonteCarlo& monte_carlo) {
     j["temperature"] = pc::temperature / 1.0_K;
     if (monte_carlo.moves) {
         j["moves"] = *monte_carlo.moves;
+        if (auto schedule = monte_carlo.moves->scheduleInfo(); !schedule.is_null()) {
+            j["move schedule"] = schedule;
+        }
     }
     j["number of sweeps"] = monte_carlo.number_of_sweeps;
+    if (monte_carlo.checkerboard) {
+        monte_carlo.checkerboard->to_json(j["checkerboard"]);
+    }
     j["energy"].push_back(*monte_carlo.state->pot);
     if (!monte_carlo.average_energy.empty()) {
         j["montecarlo"] = {{"average potential energy (kT)", monte_carlo.average_energy.avg()},
                            {"last move", monte_carlo.latest_move_name}};
     }
+    for (const auto& [move_name, allocations] : monte_carlo.heap_allocations) {
+        j["montecarlo"]["heap allocations per move"][move_name] = allocations.avg();
+    }
+    if (monte_carlo.trial_state->pot->earlyRejection()) {
+        j["montecarlo"]["early rejection"] = monte_carlo.trial_state->pot->earlyRejectionInfo();
+    }
+}
+
+/**
+ * @param j Input for the `checkerboard` section
+ * @param input Full simulation input used to construct the worker states
+ * @param state Accepted state used to check geometry and Hamiltonian
+ */
+CheckerboardSweep::CheckerboardSweep(const json& j, const json& input, const MetropolisMonteCarlo::State& state) {
+    cutoff = j.at("cutoff").get<double>() * 1.0_angstrom;
+    if (cutoff <= 0.0) {
+        throw ConfigurationError("checkerboard: cutoff must be positive");
+    }
+    if (state.spc->geometry.type != Geometry::Variant::CUBOID) {
+        throw ConfigurationError("checkerboard: cuboidal geometry required");
+    }
+    checkHamiltonian(*state.pot);
+
+    for (const auto& j_molecule : j.at("molecules")) {
+        const auto& molecule = findMoleculeByName(j_molecule.at("molecule").get<std::string>());
+        auto& displacement = molecule_displacements.emplace_back();
+        displacement.molid = molecule.id();
+        displacement.directions = j_molecule.value("dir", Point(1, 1, 1));
+        if (!molecule.isAtomic()) { // atomic groups use `dp` and `dprot` from the atom list
+            displacement.translational_displacement = j_molecule.at("dp").get<double>() * 1.0_angstrom;
+            displacement.rotational_displacement = j_molecule.value("dprot", 0.0);
+        }
+    }
+    if (molecule_displacements.empty()) {
+        throw ConfigurationError("checkerboard: no molecules given");
+    }
+
+#ifdef _OPENMP
+    const int default_number_of_threads = omp_get_max_threads();
+#else
+    const int default_number_of_threads = 1;
+#endif
+    auto number_of_threads = j.value("threads", default_number_of_threads);
+#ifndef _OPENMP
+    if (number_of_threads > 1) {
+        faunus_logger->warn("checkerboard: openmp unavailable; falling back to a single thread");
+        number_of_threads = 1;
+    }
+#endif
+    if (number_of_threads < 1) {
+        throw ConfigurationError("checkerboard: at least one thread required");
+    }
+
+    const auto original_log_level = faunus_logger->level();
+    faunus_logger->set_level(spdlog::level::off); // do not duplicate log info
+    std::generate_n(std::back_inserter(workers), number_of_threads, [&] {
+        auto worker = std::make_unique<Worker>();
+        worker->state = std::make_unique<MetropolisMonteCarlo::State>(input);
+        worker->trial_state = std::make_unique<MetropolisMonteCarlo::State>(input);
+        worker->state->pot->state = Energy::Energybase::MonteCarloState::ACCEPTED;
+        worker->trial_state->pot->state = Energy::Energybase::MonteCarloState::TRIAL;
+        return worker;
+    });
+    faunus_logger->set_level(original_log_level);
+    checkInteractionRange(*workers.front()->state);
+    faunus_logger->info("checkerboard: {} thread(s) with cutoff {} Å", workers.size(), cutoff / 1.0_angstrom);
+}
+
+/**
+ * Energy terms with long-ranged or global interactions (Ewald, penalty functions etc.)
+ * couple distant domains and cannot be used.
+ */
+void CheckerboardSweep::checkHamiltonian(const Energy::Hamiltonian& hamiltonian) const {
+    static const std::set<std::string> local_energy_terms = {
+        "nonbonded", "bonded", "isobaric", "confine", "customexternal", "external", "particle-self-energy"};
+    for (const auto& energy : hamiltonian) {
+        if (!local_energy_terms.contains(energy->name)) {
+            throw ConfigurationError("checkerboard: energy term '{}' is not supported", energy->name);
+        }
+    }
+}
+
+/**
+ * Atoms in different domains of the same color are at least one domain width, i.e. `cutoff`, apart.
+ * For moved molecules only the mass center is confined to the domain, so atoms can come closer by
+ * twice the largest molecular radius. The nonbonded pair energy of all present atom types is
+ * therefore probed at this shorter distance and must vanish.
+ */
+void CheckerboardSweep::checkInteractionRange(MetropolisMonteCarlo::State& state) const {
+    const auto& spc = *state.spc;
+    auto max_radius = 0.0;
+    for (const auto& displacement : molecule_displacements) {
+        for (const auto& group : spc.findMolecules(displacement.molid, Space::Selection::ACTIVE)) {
+            if (group.isMolecular()) {
+                for (const auto& particle : group) {
+                    max_radius = std::max(max_radius, std::sqrt(spc.geometry.sqdist(particle.pos, group.mass_center)));
+                }
+            }
+        }
+    }
+    const auto distance = cutoff - 2.0 * max_radius;
+    if (distance <= 0.0) {
+        throw ConfigurationError("checkerboard: cutoff must exceed twice the molecular radius of {:.2f} Å",
+                                 max_radius / 1.0_angstrom);
+    }
+    const Point box_length = spc.geometry.getLength();
+    Eigen::Index axis = 0;
+    if (distance > 0.5 * box_length.maxCoeff(&axis)) {
+        return; // no more than one domain in any direction; sweeps are serial
+    }
+    std::set<AtomData::index_type> atom_ids;
+    for (const auto& particle : spc.particles) {
+        atom_ids.insert(particle.id);
+    }
+    constexpr auto energy_tolerance = 1e-6; // kT
+    for (const auto& energy : *state.pot) {
+        auto* nonbonded = dynamic_cast<Energy::NonbondedBase*>(energy.get());
+        if (nonbonded == nullptr) {
+            continue;
+        }
+        for (const auto id1 : atom_ids) {
+            for (const auto id2 : atom_ids) {
+                Particle particle1(Faunus::atoms.at(id1), {0.0, 0.0, 0.0});
+                Particle particle2(Faunus::atoms.at(id2), {0.0, 0.0, 0.0});
+                particle2.pos[axis] = distance;
+                if (const auto pair_energy = nonbonded->particleParticleEnergy(particle1, particle2);
+                    !(std::fabs(pair_energy) <= energy_tolerance)) {
+                    throw ConfigurationError("checkerboard: {}-{} energy is {:.2E} kT at {:.2f} Å; increase cutoff",
+                                             Faunus::atoms.at(id1).name, Faunus::atoms.at(id2).name, pair_energy,
+                                             distance / 1.0_angstrom);
+                }
+            }
+        }
+    }
+}
+
+void CheckerboardSweep::synchronize(const MetropolisMonteCarlo::State& state) {
+    Change change;
+    change.everything = true;
+    for (auto& worker : workers) {
+        worker->state->sync(state, change);
+        worker->trial_state->sync(state, change);
+        worker->state->pot->init();
+        worker->trial_state->pot->init();
+        worker->accepted_changes.clear();
+        worker->sum_of_energy_changes = 0.0;
+    }
+}
+
+/**
+ * The number of domains in each direction is the largest even number giving a
+ * domain width above the cutoff. If less than two domains fit, a single domain
+ * is used in that direction.
+ */
+void CheckerboardSweep::updateDomainGrid(const Space& spc, Random& random) {
+    const Point box_length = spc.geometry.getLength();
+    for (int i = 0; i < 3; ++i) {
+        auto n = static_cast<int>(std::floor(box_length[i] / cutoff));
+        n -= n % 2;
+        number_of_domains[i] = std::max(n, 1);
+    }
+    if (number_of_domains.prod() == 1 && number_of_sweeps == 1) {
+        faunus_logger->warn("checkerboard: box too small for cutoff; sweeps will be serial");
+    }
+    grid_offset = box_length.cwiseProduct(Point(random(), random(), random()));
+}
+
+int CheckerboardSweep::domainIndex(const Space& spc, const Point& position) const {
+    const Point box_length = spc.geometry.getLength();
+    Eigen::Vector3i cell;
+    for (int i = 0; i < 3; ++i) {
+        auto fraction = (position[i] + 0.5 * box_length[i] + grid_offset[i]) / box_length[i];
+        fraction -= std::floor(fraction); // [0:1[
+        cell[i] = std::min(static_cast<int>(fraction * number_of_domains[i]), number_of_domains[i] - 1);
+    }
+    return cell.x() + number_of_domains.x() * (cell.y() + number_of_domains.y() * cell.z());
+}
+
+int CheckerboardSweep::domainColor(const int domain_index) const {
+    const auto x = domain_index % number_of_domains.x();
+    const auto y = (domain_index / number_of_domains.x()) % number_of_domains.y();
+    const auto z = domain_index / (number_of_domains.x() * number_of_domains.y());
+    return (x % 2) + 2 * (y % 2) + 4 * (z % 2);
+}
+
+std::vector<std::vector<CheckerboardSweep::Item>> CheckerboardSweep::assignItemsToDomains(const Space& spc) const {
+    std::vector<std::vector<Item>> domain_items(number_of_domains.prod());
+    for (const auto& displacement : molecule_displacements) {
+        for (const auto& group : spc.findMolecules(displacement.molid, Space::Selection::ALL)) {
+            const auto group_index = static_cast<Change::index_type>(spc.getGroupIndex(group));
+            if (group.isAtomic()) {
+                for (Change::index_type i = 0; i < static_cast<Change::index_type>(group.size()); ++i) {
+                    domain_items.at(domainIndex(spc, group[i].pos)).push_back({group_index, i, &displacement});
+                }
+            } else if (!group.empty() && group.isFull()) {
+                domain_items.at(domainIndex(spc, group.mass_center)).push_back({group_index, std::nullopt, &displacement});
+            }
+        }
+    }
+    return domain_items;
+}
+
+/**
+ * @return False if the atom or mass center left the domain, in which case the move must be rejected
+ */
+bool CheckerboardSweep::displace(Worker& worker, Random& random, const Item& item, const int domain_index) const {
+    auto& spc = *worker.trial_state->spc;
+    auto& group = spc.groups.at(item.group_index);
+    if (item.relative_atom_index) {
+        auto& particle = group.at(*item.relative_atom_index);
+        const auto& traits = particle.traits();
+        if (traits.dp > 0.0) {
+            particle.pos += randomUnitVector(random, item.displacement->directions) * traits.dp * random();
+            spc.geometry.boundary(particle.pos);
+        }
+        if (traits.dprot > 0.0) {
+            const auto angle = traits.dprot * (random() - 0.5);
+            const Eigen::Quaterniond quaternion(Eigen::AngleAxisd(angle, randomUnitVector(random)));
+            particle.rotate(quaternion, quaternion.toRotationMatrix());
+        }
+        return domainIndex(spc, particle.pos) == domain_index;
+    }
+    if (item.displacement->translational_displacement > 0.0) {
+        const auto displacement_vector = randomUnitVector(random, item.displacement->directions) *
+                                         item.displacement->translational_displacement * random();
+        group.translate(displacement_vector, spc.geometry.getBoundaryFunc());
+    }
+    if (item.displacement->rotational_displacement > 0.0) {
+        const auto angle = item.displacement->rotational_displacement * (random() - 0.5);
+        const Eigen::Quaterniond quaternion(Eigen::AngleAxisd(angle, randomUnitVector(random)));
+        group.rotate(quaternion, spc.geometry.getBoundaryFunc());
+    }
+    return domainIndex(spc, group.mass_center) == domain_index;
+}
+
+/**
+ * Performs as many single atom/molecule moves as there are items in the domain.
+ * Only the worker's own states are touched.
+ */
+void CheckerboardSweep::sweepDomain(Worker& worker, Random& random, const std::vector<Item>& items,
+                                    const int domain_index) const {
+    for (size_t n = 0; n < items.size(); ++n) {
+        const auto& item = *random.sample(items.begin(), items.end());
+        worker.number_of_attempted_moves++;
+
+        Change change;
+        auto& group_change = change.groups.emplace_back();
+        group_change.group_index = item.group_index;
+        if (item.relative_atom_index) {
+            group_change.internal = true;
+            group_change.relative_atom_indices = {*item.relative_atom_index};
+        } else {
+            group_change.all = true;
+        }
+
+        auto accepted = false;
+        auto energy_change = 0.0;
+        if (displace(worker, random, item, domain_index)) {
+            worker.trial_state->pot->updateState(change);
+            const auto new_energy = worker.trial_state->pot->energy(change);
+            const auto old_energy = worker.state->pot->energy(change);
+            energy_change = MetropolisMonteCarlo::getEnergyChange(new_energy, old_energy);
+            accepted = MetropolisMonteCarlo::metropolisCriterion(energy_change, random);
+        }
+        if (accepted) {
+            worker.state->sync(*worker.trial_state, change);
+            worker.sum_of_energy_changes += energy_change;
+            worker.number_of_accepted_moves++;
+            auto& merged = worker.accepted_changes[item.group_index];
+            merged.group_index = item.group_index;
+            merged.all = merged.all || group_change.all;
+            merged.internal = merged.internal || group_change.internal;
+            merged.relative_atom_indices.insert(merged.relative_atom_indices.end(),
+                                                group_change.relative_atom_indices.begin(),
+                                                group_change.relative_atom_indices.end());
+        } else {
+            worker.trial_state->sync(*worker.state, change);
+        }
+    }
+}
+
+/**
+ * Converts and clears a map of accumulated group changes
+ */
+Change CheckerboardSweep::collectChanges(std::map<Change::index_type, Change::GroupChange>& changes) const {
+    Change change;
+    for (auto& [group_index, group_change] : changes) {
+        auto& indices = group_change.relative_atom_indices;
+        if (group_change.all) {
+            indices.clear();
+        } else {
+            std::sort(indices.begin(), indices.end());
+            indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+        }
+        change.groups.push_back(std::move(group_change));
+    }
+    changes.clear();
+    return change;
+}
+
+/**
+ * @return Sum of accepted energy changes (kT)
+ */
+double CheckerboardSweep::sweep(MetropolisMonteCarlo::State& state, MetropolisMonteCarlo::State& trial_state,
+                                Random& random) {
+    number_of_sweeps++;
+    updateDomainGrid(*state.spc, random);
+    const auto domain_items = assignItemsToDomains(*state.spc);
+
+    std::array<int, 8> colors;
+    std::iota(colors.begin(), colors.end(), 0);
+    std::shuffle(colors.begin(), colors.end(), random.engine);
+
+    auto energy_change = 0.0;
+    for (const auto color : colors) {
+        std::vector<int> domains;
+        for (int i = 0; i < static_cast<int>(domain_items.size()); ++i) {
+            if (!domain_items[i].empty() && domainColor(i) == color) {
+                domains.push_back(i);
+            }
+        }
+        if (domains.empty()) {
+            continue;
+        }
+        // streams follow domains, not threads, so that the outcome is independent of scheduling
+        std::vector<decltype(random.engine())> domain_seeds(domains.size());
+        std::generate(domain_seeds.begin(), domain_seeds.end(), [&] { return random.engine(); });
+
+        std::exception_ptr exception = nullptr; // exceptions must not escape the parallel region
+#pragma omp parallel for schedule(dynamic) num_threads(workers.size())
+        for (int i = 0; i < static_cast<int>(domains.size()); ++i) {
+            try {
+#ifdef _OPENMP
+                auto& worker = *workers.at(omp_get_thread_num());
+#else
+                auto& worker = *workers.front();
+#endif
+                Random domain_random;
+                domain_random.engine = decltype(domain_random.engine)(domain_seeds[i]);
+                sweepDomain(worker, domain_random, domain_items[domains[i]], domains[i]);
+            } catch (...) {
+#pragma omp critical
+                exception = std::current_exception();
+            }
+        }
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+
+        // copy accepted changes to the main state and broadcast them to everybody else
+        std::map<Change::index_type, Change::GroupChange> all_changes;
+        for (auto& worker : workers) {
+            if (worker->accepted_changes.empty()) {
+                continue;
+            }
+            const auto change = collectChanges(worker->accepted_changes);
+            state.sync(*worker->state, change);
+            for (const auto& group_change : change.groups) {
+                auto& merged = all_changes[group_change.group_index];
+                merged.group_index = group_change.group_index;
+                merged.all = merged.all || group_change.all;
+                merged.internal = merged.internal || group_change.internal;
+                merged.relative_atom_indices.insert(merged.relative_atom_indices.end(),
+                                                    group_change.relative_atom_indices.begin(),
+                                                    group_change.relative_atom_indices.end());
+            }
+            energy_change += worker->sum_of_energy_changes;
+            worker->sum_of_energy_changes = 0.0;
+        }
+        if (!all_changes.empty()) {
+            const auto change = collectChanges(all_changes);
+            trial_state.sync(state, change);
+            for (auto& worker : workers) {
+                worker->state->sync(state, change);
+                worker->trial_state->sync(state, change);
+            }
+        }
+    }
+    return energy_change;
+}
+
+void CheckerboardSweep::to_json(json& j) const {
+    const auto [attempts, accepted] = std::accumulate(
+        workers.begin(), workers.end(), std::pair<unsigned long, unsigned long>(0, 0), [](auto sum, const auto& worker) {
+            return std::make_pair(sum.first + worker->number_of_attempted_moves,
+                                  sum.second + worker->number_of_accepted_moves);
+        });
+    j = {{"cutoff", cutoff / 1.0_angstrom},
+         {"threads", workers.size()},
+         {"domains", std::vector<int>{number_of_domains.x(), number_of_domains.y(), number_of_domains.z()}},
+         {"sweeps", number_of_sweeps},
+         {"trials", attempts}};
+    if (attempts > 0) {
+        j["acceptance"] = static_cast<double>(accepted) / static_cast<double>(attempts);
+    }
+    auto& j_molecules = j["molecules"] = json::array();
+    for (const auto& displacement : molecule_displacements) {
+        j_molecules.push_back({{"molecule", Faunus::molecules.at(displacement.molid).name},
+                               {"dp", displacement.translational_displacement / 1.0_angstrom},
+                               {"dprot", displacement.rotational_displacement},
+                               {"dir", displacement.directions}});
+    }
 }
 
 TranslationalEntropy::TranslationalEntropy(const Space& trial_space, const Space& space)
@@ -322,4 +818,231 @@ double TranslationalEntropy::energy(const Change& change) {
     }
     return energy_change;
 }
+TEST_CASE("[Faunus] CheckerboardSweep") {
+    const auto original_atoms = Faunus::atoms;
+    const auto original_molecules = Faunus::molecules;
+    const auto original_random = Faunus::random;
+    const auto original_move_random = Move::MoveBase::slump;
+    auto input = R"({
+        "atomlist": [{"A": {"sigma": 2.0, "eps": 0.5, "dp": 1.0}}],
+        "moleculelist": [{"particles": {"atoms": ["A"], "atomic": true}}],
+        "insertmolecules": [{"particles": {"N": 200}}],
+        "geometry": {"type": "cuboid", "length": 40},
+        "energy": [{"nonbonded": {"default": [{"wca": {"mixing": "LB"}}]}}],
+        "moves": [],
+        "checkerboard": {"cutoff": 5.0, "molecules": [{"molecule": "particles"}]}
+    })"_json;
+
+    auto setup = [&]() {
+        Faunus::atoms = input["atomlist"].get<decltype(Faunus::atoms)>();
+        Faunus::molecules = input["moleculelist"].get<decltype(Faunus::molecules)>();
+        Faunus::random = original_random;
+        Move::MoveBase::slump = original_move_random;
+    };
+
+    // fixed seed gives identical configurations regardless of the number of threads
+    auto run = [&](int number_of_threads) {
+        setup();
+        input["checkerboard"]["threads"] = number_of_threads;
+        MetropolisMonteCarlo simulation(input);
+        for (int i = 0; i < 3; ++i) {
+            simulation.sweep();
+        }
+        CHECK(std::fabs(simulation.relativeEnergyDrift()) < 1e-6);
+        json j = simulation;
+        CHECK(j.at("checkerboard").at("acceptance").get<double>() > 0.0);
+        std::vector<Point> positions;
+        for (const auto& particle : simulation.getSpace().particles) {
+            positions.push_back(particle.pos);
+        }
+        return positions;
+    };
+    const auto serial_positions = run(1);
+    CHECK(serial_positions == run(2));
+    CHECK(serial_positions == run(4));
+
+    // pair energies must vanish at the cutoff
+    setup();
+    input["checkerboard"]["cutoff"] = 2.0;
+    CHECK_THROWS_AS(MetropolisMonteCarlo{input}, ConfigurationError);
+
+    Faunus::atoms = original_atoms;
+    Faunus::molecules = original_molecules;
+    Faunus::random = original_random;
+    Move::MoveBase::slump = original_move_random;
+}
+
+TEST_CASE("[Faunus] MetropolisMonteCarlo - tracked energies") {
+    const auto original_atoms = Faunus::atoms;
+    const auto original_molecules = Faunus::molecules;
+    const auto input = R"({
+        "atomlist": [{"A": {"sigma": 3.0, "eps": 0.5, "q": 1.0}}, {"B": {"sigma": 2.0, "eps": 0.5, "q": -1.0, "dp": 2.0}}],
+        "moleculelist": [{"dimer": {"structure": [{"A": [0.0, 0.0, 0.0]}, {"A": [3.0, 0.0, 0.0]}]}},
+                         {"salt": {"atoms": ["B"], "atomic": true}}],
+        "insertmolecules": [{"dimer": {"N": 10}}, {"salt": {"N": 20}}],
+        "geometry": {"type": "cuboid", "length": 30},
+        "energy": [{"nonbonded_coulomblj": {"lennardjones": {"mixing": "LB"},
+                                            "coulomb": {"type": "plain", "epsr": 80, "cutoff": 12}}}],
+        "moves": [{"moltransrot": {"molecule": "dimer", "dp": 2.0, "dprot": 1.0}},
+                  {"transrot": {"molecule": "salt"}}]
+    })"_json;
+    Faunus::atoms = input["atomlist"].get<decltype(Faunus::atoms)>();
+    Faunus::molecules = input["moleculelist"].get<decltype(Faunus::molecules)>();
+    MetropolisMonteCarlo simulation(input);
+    for (int i = 0; i < 5; ++i) {
+        simulation.sweep();
+    }
+    const auto tracked_energies = simulation.getHamiltonian().trackedEnergies();
+    REQUIRE_FALSE(tracked_energies.empty());
+    Change change;
+    change.everything = true;
+    simulation.getHamiltonian().energy(change);
+    const auto& energies = simulation.getHamiltonian().latestEnergies();
+    REQUIRE(energies.size() == tracked_energies.size());
+    for (size_t i = 0; i < energies.size(); ++i) {
+        CHECK(tracked_energies[i] == doctest::Approx(energies[i]));
+    }
+    Faunus::atoms = original_atoms;
+    Faunus::molecules = original_molecules;
+}
+
+TEST_CASE("[Faunus] MetropolisMonteCarlo - early rejection") {
+    const auto original_atoms = Faunus::atoms;
+    const auto original_molecules = Faunus::molecules;
+    const auto original_random = Faunus::random;
+    const auto original_move_random = Move::MoveBase::slump;
+    auto input = R"({
+        "atomlist": [{"A": {"sigma": 3.0, "eps": 0.5, "q": 1.0}}, {"B": {"sigma": 2.0, "eps": 0.5, "q": -1.0, "dp": 2.0}}],
+        "moleculelist": [{"dimer": {"structure": [{"A": [0.0, 0.0, 0.0]}, {"A": [3.0, 0.0, 0.0]}]}},
+                         {"salt": {"atoms": ["B"], "atomic": true}}],
+        "insertmolecules": [{"dimer": {"N": 5}}, {"salt": {"N": 20}}],
+        "geometry": {"type": "cuboid", "length": 30},
+        "energy": [{"nonbonded_coulomblj": {"lennardjones": {"mixing": "LB"},
+                                            "coulomb": {"type": "plain", "epsr": 80, "cutoff": 12}}},
+                   {"confine": {"type": "cuboid", "low": [-10, -10, -10], "high": [10, 10, 10],
+                                "molecules": ["salt"], "k": 1.0}}],
+        "moves": [{"moltransrot": {"molecule": "dimer", "dp": 2.0, "dprot": 1.0}},
+                  {"transrot": {"molecule": "salt"}}]
+    })"_json;
+    Faunus::atoms = input["atomlist"].get<decltype(Faunus::atoms)>();
+    Faunus::molecules = input["moleculelist"].get<decltype(Faunus::molecules)>();
+
+    // identical random numbers are drawn with and without early rejection
+    auto run = [&](bool early_rejection) {
+        Faunus::random = original_random;
+        Move::MoveBase::slump = original_move_random;
+        input["energy"][2] = {{"early_rejection", early_rejection}};
+        auto simulation = std::make_unique<MetropolisMonteCarlo>(input);
+        for (int i = 0; i < 10; ++i) {
+            simulation->sweep();
+        }
+        return simulation;
+    };
+    const auto reference = run(false);
+    const auto simulation = run(true);
+    CHECK((simulation->getSpace().positions() | ranges::to_vector) ==
+          (reference->getSpace().positions() | ranges::to_vector));
+    CHECK(simulation->getHamiltonian().trackedEnergies() == reference->getHamiltonian().trackedEnergies());
+    CHECK(std::fabs(simulation->relativeEnergyDrift()) < 1e-9);
+    const json j = *simulation;
+    CHECK(j["montecarlo"]["early rejection"]["early rejections"].get<int>() > 0);
+
+    Faunus::atoms = original_atoms;
+    Faunus::molecules = original_molecules;
+    Faunus::random = original_random;
+    Move::MoveBase::slump = original_move_random;
+}
+
+TEST_CASE("[Faunus] MetropolisMonteCarlo - restore from checkpoint") {
+    const auto original_atoms = Faunus::atoms;
+    const auto original_molecules = Faunus::molecules;
+    const auto original_random = Faunus::random;
+    const auto original_move_random = Move::MoveBase::slump;
+    const auto input = R"({
+        "atomlist": [{"A": {"sigma": 3.0, "eps": 0.5, "q": 1.0}}, {"B": {"sigma": 2.0, "eps": 0.5, "q": -1.0, "dp": 2.0}}],
+        "moleculelist": [{"dimer": {"structure": [{"A": [0.0, 0.0, 0.0]}, {"A": [3.0, 0.0, 0.0]}]}},
+                         {"salt": {"atoms": ["B"], "atomic": true}}],
+        "insertmolecules": [{"dimer": {"N": 5}}, {"salt": {"N": 10}}],
+        "geometry": {"type": "cuboid", "length": 30},
+        "energy": [{"nonbonded_coulomblj": {"lennardjones": {"mixing": "LB"},
+                                            "coulomb": {"type": "plain", "epsr": 80, "cutoff": 12}}}],
+        "moves": [{"moltransrot": {"molecule": "dimer", "dp": 2.0, "dprot": 1.0}},
+                  {"transrot": {"molecule": "salt"}}]
+    })"_json;
+    Faunus::atoms = input["atomlist"].get<decltype(Faunus::atoms)>();
+    Faunus::molecules = input["moleculelist"].get<decltype(Faunus::molecules)>();
+    const std::string filename = "restore_test.ckpt";
+
+    auto energy_of = [](MetropolisMonteCarlo& simulation) {
+        Change change;
+        change.everything = true;
+        return simulation.getHamiltonian().energy(change);
+    };
+    auto positions_of = [](MetropolisMonteCarlo& simulation) {
+        return simulation.getSpace().positions() | ranges::to_vector;
+    };
+
+    MetropolisMonteCarlo simulation(input);
+    for (int i = 0; i < 3; ++i) {
+        simulation.sweep();
+    }
+    { // as at the end of a simulation
+        Analysis::SaveState save_state({{"file", filename}, {"saverandom", true}}, simulation.getSpace());
+    }
+    const auto saved_energy = energy_of(simulation);
+    const auto saved_positions = positions_of(simulation);
+
+    SpaceCheckpoint checkpoint;
+    checkpoint.load(MPI::prefix + filename);
+    MetropolisMonteCarlo restored_simulation(input); // fresh simulation with a different configuration
+    CHECK(positions_of(restored_simulation) != saved_positions);
+    restored_simulation.restore(checkpoint);
+    CHECK(positions_of(restored_simulation) == saved_positions);
+    CHECK(energy_of(restored_simulation) == doctest::Approx(saved_energy));
+    CHECK(std::fabs(restored_simulation.relativeEnergyDrift()) < 1e-9);
+
+    // with identical random number generators, both simulations continue identically
+    restored_simulation.sweep();
+    checkpoint.applyRandom(Move::MoveBase::slump, Faunus::random);
+    simulation.sweep();
+    CHECK(positions_of(restored_simulation) == positions_of(simulation));
+    CHECK(energy_of(restored_simulation) == doctest::Approx(energy_of(simulation)));
+
+    std::remove((MPI::prefix + filename).c_str());
+    Faunus::atoms = original_atoms;
+    Faunus::molecules = original_molecules;
+    Faunus::random = original_random;
+    Move::MoveBase::slump = original_move_random;
+}
+
+#ifdef FAUNUS_COUNT_ALLOCATIONS
+TEST_CASE("[Faunus] MetropolisMonteCarlo - no heap allocations in steady state") {
+    const auto original_atoms = Faunus::atoms;
+    const auto original_molecules = Faunus::molecules;
+    const auto input = R"({
+        "atomlist": [{"A": {"sigma": 3.0, "eps": 0.5}}, {"B": {"sigma": 2.0, "eps": 0.5, "dp": 2.0}}],
+        "moleculelist": [{"dimer": {"structure": [{"A": [0.0, 0.0, 0.0]}, {"A": [3.0, 0.0, 0.0]}]}},
+                         {"salt": {"atoms": ["B"], "atomic": true}}],
+        "insertmolecules": [{"dimer": {"N": 10}}, {"salt": {"N": 20}}],
+        "geometry": {"type": "cuboid", "length": 30},
+        "energy": [{"nonbonded": {"default": [{"lennardjones": {"mixing": "LB"}}]}}],
+        "moves": [{"moltransrot": {"molecule": "dimer", "dp": 2.0, "dprot": 1.0}},
+                  {"transrot": {"molecule": "salt"}}]
+    })"_json;
+    Faunus::atoms = input["atomlist"].get<decltype(Faunus::atoms)>();
+    Faunus::molecules = input["moleculelist"].get<decltype(Faunus::molecules)>();
+    MetropolisMonteCarlo simulation(input);
+    for (int i = 0; i < 5; ++i) { // warm up: buffers reach their final capacity
+        simulation.sweep();
+    }
+    const auto allocations_before = heapAllocationCount();
+    for (int i = 0; i < 10; ++i) {
+        simulation.sweep();
+    }
+    CHECK_EQ(heapAllocationCount(), allocations_before);
+
+    Faunus::atoms = original_atoms;
+    Faunus::molecules = original_molecules;
+}
+#endif
 } // namespace Faunus
@@ -4,6 +4,8 @@
 
 #include "space.h"
 #include <memory>
+#include <map>
+#include <optional>
 
 namespace Faunus {
 
@@ -16,6 +18,9 @@ class MoveBase;
 class MoveCollection;
 } // namespace Move
 
+class CheckerboardSweep;
+class SpaceCheckpoint;
+
 /**
  * @brief Class to handle Monte Carlo moves
  *
@@ -60,13 +65,17 @@ class MetropolisMonteCarlo {
     std::unique_ptr<State> state;                 //!< The accepted MC state
     std::unique_ptr<State> trial_state;           //!< Proposed or trial MC state
     std::unique_ptr<Move::MoveCollection> moves;  //!< Storage for all registered MC moves
+    std::unique_ptr<CheckerboardSweep> checkerboard; //!< Optional parallel sweeps over spatial domains
     std::string latest_move_name;                 //!< Name of latest MC move
+    Change latest_change;                         //!< Change from latest move; reused to avoid heap allocations
+    std::map<std::string, Average<double>> heap_allocations; //!< Allocations per move (ENABLE_ALLOCATION_COUNTER)
     double sum_of_energy_changes = 0.0;           //!< Sum of all potential energy changes
     double initial_energy = 0.0;                  //!< Initial potential energy
     Average<double> average_energy;               //!< Average potential energy of the system
     void init();                                  //!< Reset state
     void performMove(Move::MoveBase& move);       //!< Perform move using given move implementation
-    double getEnergyChange(double new_energy, double old_energy) const;
+    static bool metropolisCriterion(double energy_change,
+                                    double random_number); //!< Metropolis criterion w. pre-drawn random number
     friend void to_json(json&, const MetropolisMonteCarlo&); //!< Write information to JSON object
     unsigned int number_of_sweeps = 0;                       //!< Number of MC sweeps, e.g. calls to sweep()
 
@@ -78,13 +87,89 @@ class MetropolisMonteCarlo {
     double relativeEnergyDrift();                          //!< Relative energy drift from initial configuration
     void sweep();                                          //!< Perform all moves (stochastic and static)
     void restore(const json& j);                           //!< Restores system from previously store json object
+    void restore(const SpaceCheckpoint& checkpoint);       //!< Restores system from binary checkpoint
     static bool metropolisCriterion(double energy_change); //!< Metropolis criterion
+    static bool metropolisCriterion(double energy_change, Random& random); //!< Metropolis w. custom random engine
+    static double getEnergyChange(double new_energy, double old_energy);   //!< Policies for infinite/NaN energies
     ~MetropolisMonteCarlo();                               //!< Required due to unique_ptr to incomplete type
 };
 
 void from_json(const json &, MetropolisMonteCarlo::State &); //!< Build state from json object
 void to_json(json &, const MetropolisMonteCarlo &);
 
+/**
+ * @brief Parallel Monte Carlo sweeps over a checkerboard domain decomposition
+ *
+ * For short-ranged Hamiltonians in a `Geometry::Cuboid`, the box is split into a grid of
+ * domains with side lengths no shorter than a user-provided interaction `cutoff`. The number of
+ * domains in each direction is even, so that domains of equal parity ("color") are separated
+ * by at least one full domain width, also across periodic boundaries.
+ * All domains of a given color are swept concurrently, each by a worker owning its
+ * own copy of the accepted and trial states. Each domain is swept with its own random number
+ * stream, seeded from the main generator, so that results do not depend on the number of threads
+ * or on how domains are scheduled.
+ * Trial moves that would take an atom (or the mass center of a molecule) out of its domain are
+ * rejected, whereby the proposal remains symmetric and the Metropolis criterion stays valid.
+ * After each color, accepted changes are copied to the main state and broadcast to all workers.
+ * The grid origin and the order of colors are randomized every sweep.
+ *
+ * The `cutoff` must be larger than the range of all interactions, including the extent of
+ * moved molecules and bonds. Only energy terms with local interactions are allowed, and
+ * nonbonded pair energies must vanish at the cutoff minus the molecular extent.
+ */
+class CheckerboardSweep {
+  public:
+    //! Displacement parameters for a participating molecule type
+    struct MoleculeDisplacement {
+        MoleculeData::index_type molid = 0;
+        double translational_displacement = 0.0; //!< Molecular translation (Å); ignored for atomic groups
+        double rotational_displacement = 0.0;     //!< Molecular rotation (rad); ignored for atomic groups
+        Point directions = {1.0, 1.0, 1.0};       //!< Translational directions
+    };
+
+  private:
+    //! Movable unit: an atom (relative index in group) or a full molecular group
+    struct Item {
+        Change::index_type group_index;
+        std::optional<Change::index_type> relative_atom_index; //!< Set for atomic groups; empty for molecules
+        const MoleculeDisplacement* displacement;
+    };
+
+    //! Thread-local copy of the system
+    struct Worker {
+        std::unique_ptr<MetropolisMonteCarlo::State> state;       //!< Accepted state
+        std::unique_ptr<MetropolisMonteCarlo::State> trial_state; //!< Trial state
+        std::map<Change::index_type, Change::GroupChange> accepted_changes; //!< Accumulated during a color
+        double sum_of_energy_changes = 0.0;                                 //!< Accumulated during a color
+        unsigned long number_of_attempted_moves = 0;
+        unsigned long number_of_accepted_moves = 0;
+    };
+
+    double cutoff = 0.0;                                  //!< Minimum domain side length (Å)
+    std::vector<MoleculeDisplacement> molecule_displacements;
+    std::vector<std::unique_ptr<Worker>> workers;         //!< One worker per thread
+    Eigen::Vector3i number_of_domains = {1, 1, 1};        //!< Domain grid used in latest sweep
+    Point grid_offset = {0.0, 0.0, 0.0};                  //!< Random grid origin of latest sweep
+    unsigned int number_of_sweeps = 0;
+
+    void checkHamiltonian(const Energy::Hamiltonian& hamiltonian) const; //!< Throw if non-local energy terms
+    void checkInteractionRange(MetropolisMonteCarlo::State& state) const; //!< Throw if pair energies exceed cutoff
+    void updateDomainGrid(const Space& spc, Random& random);             //!< New grid dimensions and origin
+    int domainIndex(const Space& spc, const Point& position) const;      //!< Domain containing position
+    int domainColor(int domain_index) const;                             //!< Parity color of domain [0:8[
+    std::vector<std::vector<Item>> assignItemsToDomains(const Space& spc) const;
+    void sweepDomain(Worker& worker, Random& random, const std::vector<Item>& items, int domain_index) const;
+    bool displace(Worker& worker, Random& random, const Item& item, int domain_index) const; //!< False if leaving domain
+    Change collectChanges(std::map<Change::index_type, Change::GroupChange>& changes) const;
+
+  public:
+    CheckerboardSweep(const json& j, const json& input, const MetropolisMonteCarlo::State& state);
+    void synchronize(const MetropolisMonteCarlo::State& state); //!< Deep copy state into all workers
+    double sweep(MetropolisMonteCarlo::State& state, MetropolisMonteCarlo::State& trial_state,
+                 Random& random); //!< Parallel sweep; returns sum of accepted energy changes (kT)
+    void to_json(json& j) const;
+};
+
 /**
  * @brief Entropy change due to particle fluctuations
  *
@@ -6,6 +6,7 @@
 #include "chainmove.h"
 #include "forcemove.h"
 #include "montecarlo.h"
+#include "energy.h"
 #include "smart_montecarlo.h"
 #include "regions.h"
 #include "aux/iteratorsupport.h"
@@ -14,6 +15,10 @@
 #include <range/v3/view/counted.hpp>
 #include <range/v3/algorithm/count.hpp>
 #include <range/v3/view/transform.hpp>
+#include <exception>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace Faunus::Move {
 
@@ -96,10 +101,22 @@ double MoveBase::bias([[maybe_unused]] Change& change, [[maybe_unused]] double o
     return 0.0;
 }
 
+/**
+ * If true, `bias()` may be called *before* the new energy is known which allows
+ * for early rejection of moves. Moves whose bias depend on the energies must override this.
+ */
+bool MoveBase::energyIndependentBias() const { return true; }
+
 void MoveBase::_accept([[maybe_unused]] Change& change) {}
 
 void MoveBase::_reject([[maybe_unused]] Change& change) {}
 
+/**
+ * Moves keeping private copies of the system can use this to update them incrementally.
+ * The change refers to the accepted state, which at this point is identical to the trial state.
+ */
+void MoveBase::notifySystemChange([[maybe_unused]] const Change& change) {}
+
 MoveBase::MoveBase(Space& spc, std::string_view name, std::string_view cite) : cite(cite), name(name), spc(spc) {}
 
 void MoveBase::setRepeat(const int new_repeat) { repeat = new_repeat; }
@@ -120,20 +137,77 @@ ReplayMove::ReplayMove(Space& spc, std::string name, std::string cite) : MoveBas
 
 ReplayMove::ReplayMove(Space& spc) : ReplayMove(spc, "replay", "") {}
 
-void ReplayMove::_to_json(json& j) const { j["file"] = reader->filename; }
+void ReplayMove::_to_json(json& j) const {
+    j = {{"file", filename}, {"start", start}, {"stride", stride}};
+    if (reader) {
+        j["buffer"] = buffer_size;
+    }
+    if (stop >= 0) {
+        j["stop"] = stop;
+    }
+}
 
-void ReplayMove::_from_json(const json& j) { reader = std::make_unique<XTCReader>(j.at("file").get<std::string>()); }
+void ReplayMove::_from_json(const json& j) {
+    filename = j.at("file").get<std::string>();
+    buffer_size = j.value("buffer", 4);
+    start = j.value("start", 0);
+    stop = j.value("stop", -1);
+    stride = j.value("stride", 1);
+    if (buffer_size < 1 || start < 0 || stride < 1) {
+        throw ConfigurationError("invalid buffer size or frame range");
+    }
+    if (const auto suffix = filename.substr(filename.find_last_of('.') + 1); suffix == "traj" || suffix == "ztraj") {
+        space_trajectory_stream = std::make_unique<std::ifstream>(filename, std::ios::binary);
+        if (!*space_trajectory_stream) {
+            throw ConfigurationError("cannot open {}", filename);
+        }
+        space_trajectory = std::make_unique<FormatSpaceTrajectory>(*space_trajectory_stream, spc);
+        space_trajectory_frame = static_cast<std::size_t>(start);
+    } else {
+        reader = std::make_unique<XTCPrefetchReader>(filename, buffer_size, start, stop, stride);
+    }
+}
+
+/**
+ * Native space trajectories restore all particle and group properties, including
+ * group sizes, charges and particle ids.
+ */
+bool ReplayMove::readSpaceTrajectoryFrame() {
+    const auto end = stop < 0 ? space_trajectory->numberOfFrames()
+                              : std::min(space_trajectory->numberOfFrames(), static_cast<std::size_t>(stop));
+    if (space_trajectory_frame >= end) {
+        return false;
+    }
+    space_trajectory->load(spc, space_trajectory_frame);
+    space_trajectory_frame += static_cast<std::size_t>(stride);
+    return true;
+}
 
 void ReplayMove::_move(Change &change) {
+    if (space_trajectory) {
+        if (!end_of_trajectory) {
+            if (readSpaceTrajectoryFrame()) {
+                change.everything = true;
+            } else {
+                end_of_trajectory = true;
+                mcloop_logger->warn("No more frames to read from {}. Running on empty.", filename);
+            }
+        }
+        return;
+    }
     assert(reader);
     if (!end_of_trajectory) {
-        if (reader->read(frame.step, frame.timestamp, frame.box, spc.positions().begin(), spc.positions().end())) {
+        if (reader->read(frame)) {
+            if (frame.coordinates.size() != spc.particles.size()) {
+                throw std::runtime_error("wrong number of particles in the loaded XTC frame");
+            }
+            std::copy(frame.coordinates.begin(), frame.coordinates.end(), spc.positions().begin());
             spc.geometry.setLength(frame.box);
             change.everything = true;
         } else {
             // nothing to do, simulation shall stop
             end_of_trajectory = true;
-            mcloop_logger->warn("No more frames to read from {}. Running on empty.", reader->filename);
+            mcloop_logger->warn("No more frames to read from {}. Running on empty.", reader->filename());
         }
     }
 }
@@ -222,7 +296,7 @@ void AtomicTranslateRotate::_move(Change& change) {
         }
 
         if (translational_displacement > 0.0 or rotational_displacement > 0.0) {
-            change.groups.push_back(cdata); // add to list of moved groups
+            change.addGroup(cdata); // add to list of moved groups
         }
     } else {
         latest_particle = spc.particles.end();
@@ -305,16 +379,21 @@ AtomicTranslateRotate::~AtomicTranslateRotate() { saveHistograms(); }
  * @param spc Reference to trial or "new" space
  * @param hamiltonian Hamiltonian used for trial space
  * @param old_spc Reference to "old" space (rarely used by any move, except Speciation)
+ * @param input Full simulation input for moves that need private copies of the system
  */
 std::unique_ptr<MoveBase> createMove(const std::string& name, const json& properties, Space& spc,
-                                     Energy::Hamiltonian& hamiltonian, Space &old_spc) {
+                                     Energy::Hamiltonian& hamiltonian, Space& old_spc, const json& input) {
     try {
         std::unique_ptr<MoveBase> move;
         if (name == "moltransrot") {
             if (properties.contains("region")) {
                 return std::make_unique<SmarterTranslateRotate>(spc, properties);
             }
-            move = std::make_unique<TranslateRotate>(spc);
+            if (properties.value("trials", 1) > 1) {
+                move = std::make_unique<MultipleTryTranslateRotate>(spc, hamiltonian, input);
+            } else {
+                move = std::make_unique<TranslateRotate>(spc);
+            }
         } else if (name == "conformationswap") {
             move = std::make_unique<ConformationSwap>(spc);
         } else if (name == "transrot") {
@@ -365,16 +444,20 @@ void MoveCollection::addMove(std::shared_ptr<MoveBase>&& move) {
     }
     moves.vec.emplace_back(move);
     repeats.push_back(static_cast<double>(move->repeat));
+    user_repeats.push_back(repeats.back());
+    latest_totals.emplace_back();
+    recent_statistics.emplace_back();
     distribution = std::discrete_distribution<unsigned int>(repeats.begin(), repeats.end());
     number_of_moves_per_sweep = static_cast<unsigned int>(std::accumulate(repeats.begin(), repeats.end(), 0.0));
 }
 
-MoveCollection::MoveCollection(const json& list_of_moves, Space& spc, Energy::Hamiltonian& hamiltonian, Space &old_spc) {
+MoveCollection::MoveCollection(const json& list_of_moves, Space& spc, Energy::Hamiltonian& hamiltonian, Space& old_spc,
+                               const json& input) {
     assert(list_of_moves.is_array());
     for (const auto& j : list_of_moves) { // loop over move list
         const auto& [name, parameters] = jsonSingleItem(j);
         try {
-            addMove(createMove(name, parameters, spc, hamiltonian, old_spc));
+            addMove(createMove(name, parameters, spc, hamiltonian, old_spc, input));
         } catch (std::exception& e) {
             usageTip.pick(name);
             throw ConfigurationError("{}", e.what()).attachJson(j);
@@ -386,6 +469,151 @@ void to_json(json& j, const MoveCollection& propagator) { j = propagator.moves;
 
 const BasePointerVector<MoveBase>& MoveCollection::getMoves() const { return moves; }
 
+/**
+ * @param j Object with the number of `sweeps` to adapt during, the update `interval`,
+ *          `max_scaling` bounding the weights relative to the user given `repeat`s, and
+ *          `decay`, the weight of statistics from previous intervals
+ */
+void MoveCollection::setAdaptiveSchedule(const json& j) {
+    adaptive_sweeps = j.at("sweeps").get<unsigned int>();
+    adaptation_interval = std::max(j.value("interval", 10U), 1U);
+    maximum_scaling = j.value("max_scaling", 10.0);
+    if (maximum_scaling < 1.0) {
+        throw ConfigurationError("max_scaling must be equal to or larger than one");
+    }
+    decay = j.value("decay", 0.5);
+    if (decay < 0.0 || decay >= 1.0) {
+        throw ConfigurationError("decay must be in the interval [0, 1)");
+    }
+    schedule_frozen = (adaptive_sweeps == 0);
+#ifdef ENABLE_MPI
+    faunus_logger->warn("adaptive move schedule may desynchronize stochastic moves across MPI processes");
+#endif
+}
+
+void MoveCollection::notifySystemChange(const Change& change) {
+    for (auto& move : moves) {
+        move->notifySystemChange(change);
+    }
+}
+
+/**
+ * Weights are updated every `adaptation_interval` sweeps. After `adaptive_sweeps`, the
+ * schedule is frozen so that the move probabilities stay constant and detailed balance is
+ * obeyed during production.
+ */
+void MoveCollection::updateSchedule(const unsigned int sweep_number) {
+    if (adaptive_sweeps == 0 || schedule_frozen) {
+        return;
+    }
+    if (sweep_number % adaptation_interval == 0 || sweep_number >= adaptive_sweeps) {
+        adaptWeights();
+    }
+    if (sweep_number >= adaptive_sweeps) {
+        schedule_frozen = true;
+        faunus_logger->info("move schedule frozen after {} sweeps", sweep_number);
+    }
+}
+
+/**
+ * Statistics gathered since the previous update are added to `recent_statistics` after
+ * scaling the existing sums by `decay`. Behaviour from early, unequilibrated parts of
+ * the run is hence forgotten.
+ */
+void MoveCollection::updateRecentStatistics() {
+    for (size_t i = 0; i < moves.size(); ++i) {
+        const auto& move = *moves.vec[i];
+        const ScheduleStatistics totals{static_cast<double>(move.number_of_attempted_moves),
+                                        static_cast<double>(move.number_of_accepted_moves),
+                                        static_cast<double>(move.timer.duration().count())};
+        auto& recent = recent_statistics[i];
+        recent.attempts = decay * recent.attempts + (totals.attempts - latest_totals[i].attempts);
+        recent.accepted = decay * recent.accepted + (totals.accepted - latest_totals[i].accepted);
+        recent.time = decay * recent.time + (totals.time - latest_totals[i].time);
+        latest_totals[i] = totals;
+    }
+}
+
+/**
+ * The efficiency of each stochastic move is measured from `recent_statistics` as the number of accepted moves per
+ * unit time, where the time is taken from `MoveBase::timer` that includes the energy evaluation. Each user weight
+ * is scaled by the move's efficiency relative to the (weighted) average efficiency, and by a common normalization
+ * so that the total weight is unchanged. The scaling is clamped to [1 / `maximum_scaling`, `maximum_scaling`]
+ * so that no move is starved; the normalization obeying both constraints is found by bisection.
+ */
+void MoveCollection::adaptWeights() {
+    constexpr auto minimum_number_of_attempts = 10.0;
+    updateRecentStatistics();
+    std::vector<std::optional<double>> efficiencies(moves.size());
+    double weighted_efficiency_sum = 0.0;
+    double weight_sum = 0.0;
+    for (size_t i = 0; i < moves.size(); ++i) {
+        const auto& recent = recent_statistics[i];
+        if (user_repeats[i] > 0.0 && recent.attempts >= minimum_number_of_attempts && recent.time > 0.0) {
+            efficiencies[i] = recent.accepted / recent.time;
+            weighted_efficiency_sum += user_repeats[i] * efficiencies[i].value();
+            weight_sum += user_repeats[i];
+        }
+    }
+    if (weight_sum <= 0.0 || weighted_efficiency_sum <= 0.0) {
+        return; // not enough statistics yet
+    }
+    const auto mean_efficiency = weighted_efficiency_sum / weight_sum;
+    const auto minimum_scaling = 1.0 / maximum_scaling;
+    auto scaled_weights = [&](const double normalization) {
+        for (size_t i = 0; i < moves.size(); ++i) {
+            if (efficiencies[i]) {
+                const auto scaling = normalization * efficiencies[i].value() / mean_efficiency;
+                repeats[i] = user_repeats[i] * std::clamp(scaling, minimum_scaling, maximum_scaling);
+            } else {
+                repeats[i] = user_repeats[i];
+            }
+        }
+        return std::accumulate(repeats.begin(), repeats.end(), 0.0);
+    };
+    const auto target_weight = std::accumulate(user_repeats.begin(), user_repeats.end(), 0.0);
+    double lower = 0.0; // all adapted weights at their minimum
+    double upper = 1.0;
+    for (int iteration = 0; iteration < 64 && scaled_weights(upper) < target_weight; ++iteration) {
+        upper *= 2.0;
+    }
+    for (int iteration = 0; iteration < 100; ++iteration) {
+        const auto normalization = 0.5 * (lower + upper);
+        (scaled_weights(normalization) < target_weight ? lower : upper) = normalization;
+    }
+    scaled_weights(0.5 * (lower + upper));
+    distribution = std::discrete_distribution<unsigned int>(repeats.begin(), repeats.end());
+}
+
+/**
+ * In addition to the weights, the recent time per attempted and accepted move is reported
+ * for each move; these are the quantities underlying the efficiencies in `adaptWeights()`.
+ */
+json MoveCollection::scheduleInfo() const {
+    if (adaptive_sweeps == 0) {
+        return json();
+    }
+    json j = {{"sweeps", adaptive_sweeps}, {"interval", adaptation_interval}, {"max_scaling", maximum_scaling},
+              {"decay", decay},           {"frozen", schedule_frozen}};
+    auto& j_weights = j["weights"] = json::array();
+    for (size_t i = 0; i < moves.size(); ++i) {
+        const auto& recent = recent_statistics[i];
+        auto& j_move = j_weights.emplace_back();
+        j_move = {{"move", moves.vec[i]->getName()},
+                  {"repeat", user_repeats[i]},
+                  {"adapted repeat", repeats[i]},
+                  {"probability", distribution.probabilities().at(i)}};
+        if (recent.attempts > 0.0) {
+            j_move["time/attempt (µs)"] = recent.time / recent.attempts;
+        }
+        if (recent.accepted > 0.0) {
+            j_move["time/accept (µs)"] = recent.time / recent.accepted;
+        }
+    }
+    roundJSON(j, 3);
+    return j;
+}
+
 MoveCollection::move_iterator MoveCollection::sample() {
 #ifdef ENABLE_MPI
     auto& random_engine = MPI::mpi.random.engine; // parallel processes (tempering) must be in sync
@@ -472,6 +700,8 @@ double ParallelTempering::bias([[maybe_unused]] Change& change, double uold, dou
     return exchangeEnergy(unew - uold); // energy change in partner replica
 }
 
+bool ParallelTempering::energyIndependentBias() const { return false; }
+
 void ParallelTempering::_accept([[maybe_unused]] Change& change) {
     acceptance_map[partner->getPair(mpi.world)] += 1.0;
 }
@@ -561,7 +791,7 @@ void ChargeMove::_move(Change& change) {
         auto& particle = spc.particles.at(particle_index); // refence to particle
         charge_displacement = getChargeDisplacement(particle);
         particle.charge += charge_displacement;
-        change.groups.push_back(group_change); // add to list of moved groups
+        change.addGroup(group_change); // add to list of moved groups
     }
 }
 
@@ -865,7 +1095,6 @@ void QuadrantJump::_move(Change& change) {
     _sqd = 0.0;
 
     // pick random group from the system matching molecule type
-    // TODO: This can be slow -- implement look-up-table in Space
     auto mollist = spc.findMolecules(molid, Space::Selection::ACTIVE); // list of molecules w. 'molid'
     if (not ranges::cpp20::empty(mollist)) {
         auto it = slump.sample(mollist.begin(), mollist.end());
@@ -944,7 +1173,7 @@ void AtomicSwapCharge::_move(Change& change) {
         double oldcharge = p->charge;
         p->charge = fabs(oldcharge - 1);
         _sqd = fabs(oldcharge - 1) - oldcharge;
-        change.groups.push_back(cdata);   // add to list of moved groups
+        change.addGroup(cdata);           // add to list of moved groups
         _bias = _sqd * (pH - pKa) * std::numbers::ln10; // one may add bias here...
     }
 }
@@ -1131,9 +1360,306 @@ SmarterTranslateRotate::SmarterTranslateRotate(Space& spc, const json& j)
     , smartmc(spc, j.at("region")) {
     this->from_json(j);
 }
+
+/**
+ * @param spc Trial space to operate on
+ * @param hamiltonian Hamiltonian of the trial space; used to synchronize worker copies
+ * @param input Full simulation input; the `energy` section is used to construct worker Hamiltonians
+ */
+MultipleTryTranslateRotate::MultipleTryTranslateRotate(Space& spc, Energy::Hamiltonian& hamiltonian,
+                                                       const json& input)
+    : TranslateRotate(spc, "moltransrot", "")
+    , hamiltonian(hamiltonian)
+    , energy_input(input.at("energy")) {}
+
+MultipleTryTranslateRotate::~MultipleTryTranslateRotate() = default;
+
+void MultipleTryTranslateRotate::_from_json(const json& j) {
+    TranslateRotate::_from_json(j);
+    number_of_trials = j.at("trials").get<unsigned int>();
+    if (number_of_trials < 2) {
+        throw ConfigurationError("at least two trials required");
+    }
+    for (const auto& energy : hamiltonian) {
+        if (energy->name == "ewald") { // incremental updates assume a single trial per state
+            throw ConfigurationError("multiple trials cannot be used with Ewald summation");
+        }
+    }
+#ifdef _OPENMP
+    const int default_number_of_threads = omp_get_max_threads();
+#else
+    const int default_number_of_threads = 1;
+#endif
+    const auto number_of_threads = std::clamp(j.value("threads", default_number_of_threads), 1,
+                                              static_cast<int>(number_of_trials));
+    const auto original_log_level = faunus_logger->level();
+    faunus_logger->set_level(spdlog::level::off); // do not duplicate log info
+    workers.clear();
+    workers_outdated = true;
+    number_of_pending_changes = 0;
+    std::generate_n(std::back_inserter(workers), number_of_threads, [&] {
+        auto worker = std::make_unique<Worker>();
+        worker->spc = std::make_unique<Space>();
+        Faunus::from_json(json(spc), *worker->spc);
+        worker->pot = std::make_unique<Energy::Hamiltonian>(*worker->spc, energy_input);
+        worker->pot->state = Energy::Energybase::MonteCarloState::TRIAL;
+        return worker;
+    });
+    faunus_logger->set_level(original_log_level);
+}
+
+void MultipleTryTranslateRotate::_to_json(json& j) const {
+    TranslateRotate::_to_json(j);
+    j["trials"] = number_of_trials;
+    j["threads"] = workers.size();
+    if (!mean_selected_weight.empty()) {
+        j["⟨p(selected)⟩"] = mean_selected_weight.avg();
+    }
+}
+
+/**
+ * Random numbers are drawn in the same order as in `TranslateRotate`
+ */
+MultipleTryTranslateRotate::Trial MultipleTryTranslateRotate::randomTrial() {
+    Trial trial;
+    if (translational_displacement > 0.0) {
+        trial.displacement =
+            Faunus::randomUnitVector(slump, translational_direction) * translational_displacement * slump();
+    }
+    if (rotational_displacement > pc::epsilon_dbl) {
+        trial.rotation_axis = (fixed_rotation_axis.count() > 0) ? fixed_rotation_axis : Faunus::randomUnitVector(slump);
+        trial.angle = rotational_displacement * (slump() - 0.5);
+    }
+    return trial;
+}
+
+void MultipleTryTranslateRotate::applyTrial(Space::GroupType& group, const Trial& trial,
+                                            Geometry::BoundaryFunction boundary) const {
+    if (trial.displacement.squaredNorm() > 0.0) {
+        group.translate(trial.displacement, boundary);
+    }
+    if (trial.angle != 0.0) {
+        const Eigen::Quaterniond quaternion(Eigen::AngleAxisd(trial.angle, trial.rotation_axis));
+        group.rotate(quaternion, boundary);
+    }
+}
+
+/**
+ * Brings all worker copies in sync with the trial space which, at the beginning
+ * of a move, is identical to the accepted state. Only changes accepted since the previous
+ * synchronization, as well as the molecule perturbed by the previous attempt, are copied.
+ */
+void MultipleTryTranslateRotate::synchronizeWorkers() {
+    auto synchronize = [&](const Change& change) {
+        for (auto& worker : workers) {
+            worker->spc->sync(spc, change);
+            worker->pot->sync(&hamiltonian, change);
+        }
+    };
+    if (workers_outdated) {
+        Change change;
+        change.everything = true;
+        synchronize(change);
+        workers_outdated = false;
+    } else {
+        std::for_each(pending_changes.begin(), pending_changes.begin() + number_of_pending_changes, synchronize);
+    }
+    number_of_pending_changes = 0;
+}
+
+/**
+ * Pending changes are replayed in order. If there are more of them than groups, a full
+ * synchronization is cheaper and is used instead.
+ */
+void MultipleTryTranslateRotate::addPendingChange(const Change& change) {
+    if (workers_outdated) {
+        return;
+    }
+    if (change.everything || number_of_pending_changes >= spc.groups.size()) {
+        workers_outdated = true;
+        number_of_pending_changes = 0;
+        return;
+    }
+    if (number_of_pending_changes == pending_changes.size()) {
+        pending_changes.emplace_back();
+    }
+    pending_changes[number_of_pending_changes++] = change; // reuses allocated memory
+}
+
+void MultipleTryTranslateRotate::notifySystemChange(const Change& change) { addPendingChange(change); }
+
+/**
+ * Each trial is applied to a fresh copy of `group` in one of the workers and the resulting
+ * energies are calculated in parallel.
+ *
+ * @param group Starting configuration of the molecule
+ * @param trials Trial displacements relative to `group`
+ * @return Energy (kT) of each trial; NaN is mapped to infinity
+ */
+std::vector<double> MultipleTryTranslateRotate::trialEnergies(const Space::GroupType& group,
+                                                              const std::vector<Trial>& trials) {
+    Change change;
+    auto& group_change = change.groups.emplace_back();
+    group_change.group_index = spc.getGroupIndex(group);
+    group_change.all = true;
+
+    std::vector<double> energies(trials.size(), pc::infty);
+    std::exception_ptr exception = nullptr; // exceptions must not escape the parallel region
+#pragma omp parallel for schedule(dynamic) num_threads(workers.size())
+    for (int i = 0; i < static_cast<int>(trials.size()); ++i) {
+        try {
+#ifdef _OPENMP
+            auto& worker = *workers.at(omp_get_thread_num());
+#else
+            auto& worker = *workers.front();
+#endif
+            auto& trial_group = worker.spc->groups.at(group_change.group_index);
+            trial_group = group; // reset to starting configuration
+            applyTrial(trial_group, trials[i], worker.spc->geometry.getBoundaryFunc());
+            worker.pot->updateState(change);
+            const auto energy = worker.pot->energy(change);
+            energies[i] = std::isnan(energy) ? pc::infty : energy;
+        } catch (...) {
+#pragma omp critical
+            exception = std::current_exception();
+        }
+    }
+    addPendingChange(change); // worker copies of the group have been perturbed
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+    return energies;
+}
+
+/**
+ * @return ln Σ exp(-u_i) evaluated without overflow; negative infinity if all energies are infinite
+ */
+double MultipleTryTranslateRotate::logSumExp(const std::vector<double>& energies) {
+    const auto minimum_energy = *std::min_element(energies.begin(), energies.end());
+    if (!std::isfinite(minimum_energy)) {
+        return pc::neg_infty;
+    }
+    const auto sum = std::accumulate(energies.begin(), energies.end(), 0.0, [&](auto sum, auto energy) {
+        return sum + std::exp(-(energy - minimum_energy));
+    });
+    return -minimum_energy + std::log(sum);
+}
+
+void MultipleTryTranslateRotate::_move(Change& change) {
+    latest_displacement_squared = 0.0;
+    latest_rotation_angle_squared = 0.0;
+    log_weight_ratio = 0.0;
+    auto group = findRandomMolecule();
+    if (!group) {
+        return;
+    }
+    auto& molecule = group->get();
+    synchronizeWorkers();
+
+    // forward trials; the last element is the unperturbed, old configuration
+    std::vector<Trial> trials(number_of_trials + 1);
+    std::generate(trials.begin(), trials.end() - 1, [&] { return randomTrial(); });
+    auto energies = trialEnergies(molecule, trials);
+    const auto old_energy = energies.back();
+    unperturbed_energy = old_energy;
+    energies.pop_back();
+    trials.pop_back();
+    const auto log_new_weight = logSumExp(energies);
+    if (!std::isfinite(log_new_weight)) { // all trials are forbidden
+        return;
+    }
+
+    // select trial according to its Rosenbluth weight
+    std::vector<double> probabilities(energies.size());
+    std::transform(energies.begin(), energies.end(), probabilities.begin(),
+                   [&](auto energy) { return std::exp(-energy - log_new_weight); });
+    const auto selected = std::discrete_distribution<size_t>(probabilities.begin(), probabilities.end())(slump.engine);
+    mean_selected_weight += probabilities.at(selected);
+
+    const auto old_mass_center = molecule.mass_center;
+    applyTrial(molecule, trials.at(selected), spc.geometry.getBoundaryFunc());
+    checkMassCenter(molecule);
+    latest_displacement_squared = spc.geometry.sqdist(old_mass_center, molecule.mass_center);
+    latest_rotation_angle_squared = std::pow(trials.at(selected).angle, 2);
+
+    // reverse trials around the selected configuration, plus the old configuration
+    std::vector<Trial> reverse_trials(number_of_trials - 1);
+    std::generate(reverse_trials.begin(), reverse_trials.end(), [&] { return randomTrial(); });
+    auto reverse_energies = trialEnergies(molecule, reverse_trials);
+    reverse_energies.push_back(old_energy);
+    log_weight_ratio = log_new_weight - logSumExp(reverse_energies);
+
+    auto& change_data = change.groups.emplace_back();
+    change_data.group_index = spc.getGroupIndex(molecule);
+    change_data.all = true;
+    change_data.internal = false;
+}
+
+/**
+ * The acceptance probability min(1, W(n)/W(o)) replaces the usual Boltzmann factor,
+ * and the energy change seen by the Metropolis criterion is compensated for.
+ */
+double MultipleTryTranslateRotate::bias(Change&, double old_energy, double new_energy) {
+    // the unperturbed worker energy must match the accepted state, or the workers are out of sync
+    if (std::isfinite(old_energy) && std::isfinite(unperturbed_energy) &&
+        std::fabs(old_energy - unperturbed_energy) > 1e-6 * std::max(1.0, std::fabs(old_energy))) {
+        throw std::runtime_error(name + ": error aligning worker energies - this could be a bug...");
+    }
+    if (!std::isfinite(old_energy) || !std::isfinite(new_energy)) {
+        return -log_weight_ratio;
+    }
+    return -log_weight_ratio - (new_energy - old_energy);
+}
+
+bool MultipleTryTranslateRotate::energyIndependentBias() const { return false; }
 } // namespace Faunus::Move
 
 #ifdef DOCTEST_LIBRARY_INCLUDED
+TEST_CASE("[Faunus] MultipleTryTranslateRotate") {
+    using namespace Faunus;
+    const auto original_atoms = Faunus::atoms;
+    const auto original_molecules = Faunus::molecules;
+    const auto original_random = Faunus::random;
+    const auto original_move_random = Move::MoveBase::slump;
+    auto input = R"({
+        "atomlist": [{"A": {"sigma": 3.0, "eps": 0.5}}, {"B": {"sigma": 2.0, "eps": 0.5, "dp": 2.0}}],
+        "moleculelist": [{"dimer": {"structure": [{"A": [0.0, 0.0, 0.0]}, {"A": [3.0, 0.0, 0.0]}]}},
+                         {"salt": {"atoms": ["B"], "atomic": true}}],
+        "insertmolecules": [{"dimer": {"N": 20}}, {"salt": {"N": 20}}],
+        "geometry": {"type": "cuboid", "length": 30},
+        "energy": [{"nonbonded": {"default": [{"lennardjones": {"mixing": "LB"}}]}}],
+        "moves": [{"moltransrot": {"molecule": "dimer", "dp": 2.0, "dprot": 1.0, "trials": 4}},
+                  {"transrot": {"molecule": "salt"}}]
+    })"_json;
+
+    // identical results for a fixed seed, regardless of the number of threads; stale
+    // worker copies, e.g. after accepted `transrot` moves, would throw
+    auto run = [&](int number_of_threads) {
+        Faunus::atoms = input["atomlist"].get<decltype(Faunus::atoms)>();
+        Faunus::molecules = input["moleculelist"].get<decltype(Faunus::molecules)>();
+        Faunus::random = original_random;
+        Move::MoveBase::slump = original_move_random;
+        input["moves"][0]["moltransrot"]["threads"] = number_of_threads;
+        MetropolisMonteCarlo simulation(input);
+        for (int i = 0; i < 10; ++i) {
+            simulation.sweep();
+        }
+        CHECK(std::fabs(simulation.relativeEnergyDrift()) < 1e-6);
+        std::vector<Point> positions;
+        for (const auto& particle : simulation.getSpace().particles) {
+            positions.push_back(particle.pos);
+        }
+        return positions;
+    };
+    const auto serial_positions = run(1);
+    CHECK(serial_positions == run(3));
+
+    Faunus::atoms = original_atoms;
+    Faunus::molecules = original_molecules;
+    Faunus::random = original_random;
+    Move::MoveBase::slump = original_move_random;
+}
+
 TEST_CASE("[Faunus] TranslateRotate") {
     using namespace Faunus;
     CHECK(!atoms.empty());     // set in a previous test
@@ -1151,6 +1677,88 @@ TEST_CASE("[Faunus] TranslateRotate") {
     CHECK(j.at("repeat") == 2);
     CHECK(j.at("dprot") == 0.5);
 }
+
+namespace {
+/** Move with a fixed wall time and acceptance probability, but no effect on the system */
+class StubMove : public Faunus::Move::MoveBase {
+    void _move(Faunus::Change& change) override {
+        const auto end = std::chrono::steady_clock::now() + cost;
+        while (std::chrono::steady_clock::now() < end) {
+        }
+        change.everything = true;
+    }
+    void _to_json([[maybe_unused]] Faunus::json& j) const override {}
+    void _from_json([[maybe_unused]] const Faunus::json& j) override {}
+
+  public:
+    std::chrono::microseconds cost;
+    double acceptance;
+    StubMove(Faunus::Space& spc, std::string_view name, std::chrono::microseconds cost, double acceptance)
+        : MoveBase(spc, name, ""), cost(cost), acceptance(acceptance) {}
+};
+} // namespace
+
+TEST_CASE("[Faunus] MoveCollection - adaptive schedule") {
+    using namespace Faunus;
+    using namespace std::chrono_literals;
+    const auto original_move_random = Move::MoveBase::slump;
+    Space spc;
+    Energy::Hamiltonian hamiltonian(spc, json::array());
+    Move::MoveCollection moves(json::array(), spc, hamiltonian, spc, json::object());
+    auto cheap = std::make_shared<StubMove>(spc, "cheap", 10us, 0.9);
+    auto costly = std::make_shared<StubMove>(spc, "costly", 200us, 0.1);
+    cheap->setRepeat(5);
+    costly->setRepeat(5);
+    moves.addMove(std::shared_ptr<Move::MoveBase>(cheap));
+    moves.addMove(std::shared_ptr<Move::MoveBase>(costly));
+    moves.setAdaptiveSchedule({{"sweeps", 60}, {"interval", 5}, {"max_scaling", 4.0}});
+
+    auto run_sweeps = [&](unsigned int first_sweep, unsigned int last_sweep) {
+        for (auto sweep = first_sweep; sweep <= last_sweep; ++sweep) {
+            for (auto& move : moves.repeatedStochasticMoves()) {
+                Change change;
+                move->move(change);
+                if (Move::MoveBase::slump() < dynamic_cast<StubMove&>(*move).acceptance) {
+                    move->accept(change);
+                } else {
+                    move->reject(change);
+                }
+            }
+            moves.updateSchedule(sweep);
+        }
+    };
+    auto adapted_repeats = [&] {
+        const auto j = moves.scheduleInfo().at("weights");
+        return std::pair(j.at(0).at("adapted repeat").get<double>(), j.at(1).at("adapted repeat").get<double>());
+    };
+    auto check_bounds = [](const std::pair<double, double>& repeats) {
+        CHECK(repeats.first + repeats.second == doctest::Approx(10.0).epsilon(0.001)); // total weight is kept
+        CHECK(std::min(repeats.first, repeats.second) >= doctest::Approx(5.0 / 4.0).epsilon(0.001));
+        CHECK(std::max(repeats.first, repeats.second) <= doctest::Approx(5.0 * 4.0).epsilon(0.001));
+    };
+
+    run_sweeps(1, 30);
+    auto repeats = adapted_repeats();
+    CHECK(repeats.first > 5.0); // cheap move with high acceptance is favoured
+    CHECK(repeats.second < 5.0);
+    check_bounds(repeats);
+    CHECK(moves.scheduleInfo().at("weights").at(0).contains("time/accept (µs)"));
+
+    std::swap(cheap->cost, costly->cost); // early behaviour must be forgotten
+    std::swap(cheap->acceptance, costly->acceptance);
+    run_sweeps(31, 60);
+    repeats = adapted_repeats();
+    CHECK(repeats.first < 5.0);
+    CHECK(repeats.second > 5.0);
+    check_bounds(repeats);
+    CHECK(moves.scheduleInfo().at("frozen") == true);
+
+    std::swap(cheap->cost, costly->cost); // no further adaptation after `sweeps`
+    std::swap(cheap->acceptance, costly->acceptance);
+    run_sweeps(61, 80);
+    CHECK(adapted_repeats() == repeats);
+    Move::MoveBase::slump = original_move_random;
+}
 #endif
 
 namespace Faunus::Move {
@@ -1168,7 +1776,7 @@ void ConformationSwap::_from_json(const json& j) {
     const auto molecule_name = j.at("molecule").get<std::string>();
     const auto molecule = Faunus::findMoleculeByName(molecule_name);
     molid = molecule.id();
-    if (molecule.conformations.size() < 2) {
+    if (molecule.numConformations() < 2) {
         throw ConfigurationError("minimum two conformations required for {}", molecule_name);
     }
     checkConformationSize(); // do conformations fit periodic boundaries?
@@ -1177,6 +1785,9 @@ void ConformationSwap::_from_json(const json& j) {
     if (copy_policy == CopyPolicy::INVALID) {
         throw ConfigurationError("invalid copy policy");
     }
+    if (molecule.conformation_library && copy_policy == CopyPolicy::PATCHES) {
+        throw ConfigurationError("packed conformations contain no patch information");
+    }
     setRepeat();
 }
 
@@ -1193,6 +1804,11 @@ void ConformationSwap::setRepeat() {
 void ConformationSwap::_move(Change& change) {
     auto groups = spc.findMolecules(molid, Space::Selection::ACTIVE);
     if (auto group = slump.sample(groups.begin(), groups.end()); group != groups.end()) {
+        if (auto& library = Faunus::molecules[molid].conformation_library) {
+            swapFromLibrary(*library, *group);
+            registerChanges(change, *group);
+            return;
+        }
         inserter.offset = group->mass_center; // insert on top of mass center
         auto particles = inserter(spc.geometry, Faunus::molecules[molid], spc.particles); // new conformation
         if (particles.size() == group->size()) {
@@ -1245,6 +1861,32 @@ void ConformationSwap::copyConformation(ParticleVector& particles, ParticleVecto
     });
 }
 
+/**
+ * Positions and charges are copied directly from the packed library, leaving all other
+ * particle properties untouched. Copy policy `all` therefore copies positions and charges.
+ */
+void ConformationSwap::swapFromLibrary(PackedConformations& library, Space::GroupType& group) {
+    if (library.numParticles() != group.size()) {
+        throw std::out_of_range(name + ": conformation atom count mismatch");
+    }
+    const auto index = library.sample(slump.engine);
+    if (copy_policy != CopyPolicy::CHARGES) {
+        conformation.assign(group.begin(), group.end()); // reuses capacity after first call
+        library.copyTo(index, conformation.begin(), true, false);
+        inserter.offset = group.mass_center; // insert on top of mass center
+        inserter.placeMolecularGroup(spc.geometry, conformation);
+        checkMassCenterDrift(group.mass_center, conformation); // throws if not OK
+        auto destination = group.begin();
+        for (const auto& particle : conformation) {
+            (destination++)->pos = particle.pos;
+        }
+    }
+    if (copy_policy != CopyPolicy::POSITIONS) {
+        library.copyTo(index, group.begin(), false, true);
+    }
+    group.conformation_id = static_cast<int>(index);
+}
+
 void ConformationSwap::registerChanges(Change& change, const Space::GroupType& group) const {
     auto& group_change = change.groups.emplace_back();
     group_change.group_index = spc.getGroupIndex(group); // index of moved group
@@ -1306,16 +1948,28 @@ void ConformationSwap::checkConformationSize() const {
         return std::sqrt(max_squared_distance);
     }; // find internal maximum distance in a set of positions
 
-    size_t conformation_id = 0;
-    for (const auto& conformation : Faunus::molecules.at(molid).conformations.data) {
-        const auto positions = conformation | ranges::cpp20::views::transform(&Particle::pos);
+    auto check_conformation = [&](const ParticleVector& particles, size_t conformation_id) {
+        const auto positions = particles | ranges::cpp20::views::transform(&Particle::pos);
         const auto max_separation = find_max_distance(positions);
         if (max_separation > max_allowed_separation) {
             faunus_logger->warn("particles in conformation {} separated by {:.3f} Å which *may* break periodic "
                                 "boundaries. If so, you'll know.",
                                 conformation_id, max_separation);
         }
-        conformation_id++;
+    };
+
+    const auto& molecule = Faunus::molecules.at(molid);
+    if (molecule.conformation_library) {
+        ParticleVector particles(molecule.conformation_library->numParticles());
+        for (size_t conformation_id = 0; conformation_id < molecule.conformation_library->size(); ++conformation_id) {
+            molecule.conformation_library->copyTo(conformation_id, particles.begin(), true, false);
+            check_conformation(particles, conformation_id);
+        }
+    } else {
+        size_t conformation_id = 0;
+        for (const auto& particles : molecule.conformations.data) {
+            check_conformation(particles, conformation_id++);
+        }
     }
 }
 
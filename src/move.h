@@ -67,6 +67,8 @@ class MoveBase {
     void setRepeat(int repeat);
     virtual double bias(Change& change, double old_energy,
                         double new_energy); //!< Extra energy not captured by the Hamiltonian
+    virtual bool energyIndependentBias() const; //!< True if `bias()` ignores the old and new energies
+    virtual void notifySystemChange(const Change& change); //!< Called for every accepted change, by any move
     MoveBase(Space& spc, std::string_view name, std::string_view cite);
     inline virtual ~MoveBase() = default;
     bool isStochastic() const; //!< True if move should be called stochastically
@@ -79,13 +81,23 @@ void to_json(json&, const MoveBase&);
 /**
  * @brief Replay simulation from a trajectory
  *
- * Particles' positions are updated in every step based on coordinates read from the trajectory. Currently only
- * XTCReader is supported.
+ * Particles' positions are updated in every step based on coordinates read from the trajectory.
+ * XTC frames are decoded ahead in a background thread by XTCPrefetchReader and set positions and box only.
+ * Native space trajectories (.traj/.ztraj, see FormatSpaceTrajectory) restore all particle and group
+ * properties as well as the implicit reservoir.
  */
 class ReplayMove : public MoveBase {
-    std::unique_ptr<XTCReader> reader = nullptr; //!< trajectory reader
-    TrajectoryFrame frame;                       //!< recently read frame (w/o coordinates)
+    std::string filename;                                //!< trajectory file name
+    std::unique_ptr<XTCPrefetchReader> reader = nullptr; //!< trajectory reader running in background thread
+    TrajectoryFrame frame;                               //!< recently read frame
+    std::unique_ptr<std::ifstream> space_trajectory_stream;      //!< input for native space trajectories
+    std::unique_ptr<FormatSpaceTrajectory> space_trajectory;     //!< native space trajectory (.traj/.ztraj)
+    std::size_t space_trajectory_frame = 0;                      //!< next space trajectory frame to load
     bool end_of_trajectory = false;              //!< flag raised when end of trajectory was reached
+    int buffer_size = 4;                         //!< number of frames decoded ahead
+    int start = 0;                               //!< first frame to replay (zero-based)
+    int stop = -1;                               //!< stop before this frame; negative = end of file
+    int stride = 1;                              //!< replay every stride'th frame
     // FIXME resolve always accept / always reject on the Faunus level
     const double force_accept = -1e12; //!< a very negative value of energy difference to force-accept the move
 
@@ -93,6 +105,7 @@ class ReplayMove : public MoveBase {
     void _to_json(json&) const override;
     void _from_json(const json&) override;
     double bias(Change&, double, double) override;
+    bool readSpaceTrajectoryFrame(); //!< Load next frame in range; false at end
 
   protected:
     using MoveBase::spc;
@@ -222,12 +235,9 @@ class TranslateRotate : public MoveBase {
     using OptionalGroup = std::optional<std::reference_wrapper<Space::GroupType>>;
     int molid = -1; //!< Molecule ID of the molecule(s) to move
     void _to_json(json& j) const override;
+    void _from_json(const json& j) override;
     TranslateRotate(Space& spc, std::string name, std::string cite);
 
-  private:
-    Average<double> mean_squared_displacement;
-    Average<double> mean_squared_rotation_angle;
-
     double latest_displacement_squared = 0.0;
     double latest_rotation_angle_squared = 0.0;
     double translational_displacement = 0.0;   //!< User defined displacement parameter
@@ -236,11 +246,15 @@ class TranslateRotate : public MoveBase {
     Point fixed_rotation_axis = {0, 0, 0};     //!< Axis of rotation. 0,0,0 == random.
 
     virtual OptionalGroup findRandomMolecule();
+    void checkMassCenter(const Space::GroupType& group) const; // sanity check of move
+
+  private:
+    Average<double> mean_squared_displacement;
+    Average<double> mean_squared_rotation_angle;
+
     double translateMolecule(Space::GroupType& group);
     double rotateMolecule(Space::GroupType& group);
-    void checkMassCenter(const Space::GroupType& group) const; // sanity check of move
 
-    void _from_json(const json& j) override;
     void _move(Change& change) override;
     void _accept(Change&) override;
     void _reject(Change&) override;
@@ -269,6 +283,66 @@ class SmarterTranslateRotate : public TranslateRotate {
     SmarterTranslateRotate(Space& spc, const json& j);
 };
 
+/**
+ * @brief Multiple-try Metropolis version of molecular translation and rotation
+ *
+ * For each attempt, `k` trial displacements of the same molecule are generated and their
+ * energies evaluated concurrently against the unchanged environment, each thread using a
+ * private copy of the system. One trial, `n`, is selected with probability proportional to its
+ * Boltzmann factor, i.e. its Rosenbluth weight. To satisfy detailed balance, `k-1` reverse trials are
+ * generated around `n` and, together with the old configuration, `o`, used to
+ * calculate the reverse Rosenbluth weight. The move is accepted with probability
+ * min(1, W(n)/W(o)) which is imposed via `bias()`.
+ *
+ * More details: Frenkel & Smit, "Understanding Molecular Simulation", chapter 13.
+ *
+ * @note The thread copies are synchronized with the full system before each attempt.
+ */
+class MultipleTryTranslateRotate : public TranslateRotate {
+  private:
+    //! Trial displacement relative to a starting configuration
+    struct Trial {
+        Point displacement = {0.0, 0.0, 0.0};
+        double angle = 0.0;
+        Point rotation_axis = {1.0, 0.0, 0.0};
+    };
+
+    //! Private system copy used by a single thread
+    struct Worker {
+        std::unique_ptr<Space> spc;
+        std::unique_ptr<Energy::Hamiltonian> pot;
+    };
+
+    Energy::Hamiltonian& hamiltonian;               //!< Hamiltonian of the trial space
+    json energy_input;                              //!< Input used to construct worker Hamiltonians
+    std::vector<std::unique_ptr<Worker>> workers;   //!< One per thread
+    std::vector<Change> pending_changes;            //!< Changes not yet copied to workers; capacity is reused
+    size_t number_of_pending_changes = 0;           //!< Valid elements in `pending_changes`
+    bool workers_outdated = true;                   //!< Workers require a full synchronization
+    unsigned int number_of_trials = 1;              //!< Number of trials, k, per attempt
+    double log_weight_ratio = 0.0;                  //!< ln(W(n)/W(o)) for latest attempt
+    double unperturbed_energy = 0.0;                //!< Worker energy of the molecule before the move
+    Average<double> mean_selected_weight;           //!< Average Boltzmann probability of selected trial
+
+    Trial randomTrial();
+    void applyTrial(Space::GroupType& group, const Trial& trial, Geometry::BoundaryFunction boundary) const;
+    void synchronizeWorkers();
+    void addPendingChange(const Change& change);
+    std::vector<double> trialEnergies(const Space::GroupType& group, const std::vector<Trial>& trials);
+    static double logSumExp(const std::vector<double>& energies); //!< ln Σ exp(-u_i)
+
+    void _to_json(json& j) const override;
+    void _from_json(const json& j) override;
+    void _move(Change& change) override;
+    double bias(Change& change, double old_energy, double new_energy) override;
+    bool energyIndependentBias() const override;
+
+  public:
+    void notifySystemChange(const Change& change) override;
+    MultipleTryTranslateRotate(Space& spc, Energy::Hamiltonian& hamiltonian, const json& input);
+    ~MultipleTryTranslateRotate() override;
+};
+
 /**
  * @brief Move that will swap conformation of a molecule
  *
@@ -288,8 +362,10 @@ class ConformationSwap : public MoveBase {
   private:
     CopyPolicy copy_policy;
     RandomInserter inserter;
-    int molid = -1; //!< Molecule ID to operate on
+    int molid = -1;               //!< Molecule ID to operate on
+    ParticleVector conformation;  //!< Buffer for conformations from packed library
     void copyConformation(ParticleVector& source_particle, ParticleVector::iterator destination) const;
+    void swapFromLibrary(PackedConformations& library, Space::GroupType& group); //!< Swap w. packed library
     void _to_json(json& j) const override;
     void _from_json(const json& j) override;
     void _move(Change& change) override;
@@ -464,6 +540,7 @@ class ParallelTempering : public MoveBase {
     void _accept(Change& change) override;
     void _reject(Change& change) override;
     double bias(Change& change, double uold, double unew) override; //!< Energy change in partner replica
+    bool energyIndependentBias() const override;
     double exchangeEnergy(double energy_change);                    //!< Exchange energy with partner
     void exchangeState(Change& change);                             //!< Exchange positions, charges, volume etc.
     void exchangeGroupSizes(Space::GroupVector& groups, int partner_rank);
@@ -481,7 +558,7 @@ class ParallelTempering : public MoveBase {
  * @throw if invalid name or input parameters
  */
 std::unique_ptr<MoveBase> createMove(const std::string& name, const json& properties, Space& spc,
-                                     Energy::Hamiltonian& hamiltonian);
+                                     Energy::Hamiltonian& hamiltonian, Space& old_spc, const json& input);
 
 /**
  * @brief Class storing a list of MC moves with their probability weights and
@@ -492,14 +569,36 @@ class MoveCollection {
     unsigned int number_of_moves_per_sweep;                //!< Sum of all weights
     BasePointerVector<MoveBase> moves;                     //!< list of moves
     std::vector<double> repeats;                           //!< list of repeats (weights) for `moves`
+    std::vector<double> user_repeats;                      //!< list of repeats as given by the user
     std::discrete_distribution<unsigned int> distribution; //!< Probability distribution for `moves`
     using move_iterator = decltype(moves.vec)::iterator;   //!< Iterator to move pointer
     move_iterator sample();                                //!< Pick move from a weighted, random distribution
 
+    /** Move statistics used for adapting weights; time in microseconds, including energy evaluation */
+    struct ScheduleStatistics {
+        double attempts = 0.0;
+        double accepted = 0.0;
+        double time = 0.0;
+    };
+    std::vector<ScheduleStatistics> latest_totals;      //!< Cumulative move statistics at the latest update
+    std::vector<ScheduleStatistics> recent_statistics;  //!< Exponentially decaying sums over update intervals
+    unsigned int adaptive_sweeps = 0;     //!< Number of initial sweeps where weights are adapted; zero = disabled
+    unsigned int adaptation_interval = 1; //!< Number of sweeps between weight updates
+    double maximum_scaling = 10.0;        //!< Bound on weight scaling relative to user weights
+    double decay = 0.5;                   //!< Weight of previous intervals in `recent_statistics`
+    bool schedule_frozen = false;         //!< True once adaptation has ended
+    void updateRecentStatistics();        //!< Add statistics since the latest update and decay older ones
+    void adaptWeights();                  //!< Scale user weights by recent acceptances per unit time
+
   public:
-    MoveCollection(const json& list_of_moves, Space& spc, Energy::Hamiltonian& hamiltonian, Space &old_spc);
+    MoveCollection(const json& list_of_moves, Space& spc, Energy::Hamiltonian& hamiltonian, Space& old_spc,
+                   const json& input);
     void addMove(std::shared_ptr<MoveBase>&& move);                 //!< Register new move with correct weight
     const BasePointerVector<MoveBase>& getMoves() const;            //!< Get list of moves
+    void setAdaptiveSchedule(const json& j);                        //!< Enable cost-aware weights
+    void updateSchedule(unsigned int sweep_number);                 //!< Adapt weights if due; call once per sweep
+    void notifySystemChange(const Change& change);                  //!< Pass accepted change to all moves
+    json scheduleInfo() const;                                      //!< Current schedule; empty if not adaptive
     friend void to_json(json& j, const MoveCollection& propagator); //!< Generate json output
 
     /**
@@ -263,8 +263,20 @@ PYBIND11_MODULE(pyfaunus, m) {
         .def("to_dict",
              [](Analysis::CombinedAnalysis& self) {
                  json j;
-                 Faunus::to_json(j, self);
+                 Analysis::to_json(j, self);
                  return py::dict(j);
              })
         .def("sample", &Analysis::CombinedAnalysis::sample);
+
+    // Binary column files written by analyses
+    m.def(
+        "readColumns",
+        [](const std::string& filename) {
+            py::dict columns;
+            for (const auto& [name, values] : ColumnReader(filename).read()) {
+                columns[py::str(name)] = py::array_t<double>(values.size(), values.data());
+            }
+            return columns;
+        },
+        "filename"_a, "Read .fcol or .zfcol file into a dict of numpy arrays");
 }
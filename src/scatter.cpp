@@ -42,6 +42,37 @@ TEST_CASE("Benchmark") {
 }
 #endif
 
+TEST_CASE("[Faunus] DebyeHistogramFormula") {
+    std::vector<Point> positions(200);
+    std::for_each(positions.begin(), positions.end(), [](auto& position) { position = 20.0 * Point::Random(); });
+    const double q_min = 0.05, q_max = 1.0, q_step = 0.05, bin_width = 0.001;
+
+    SUBCASE("All pairs") {
+        DebyeFormula<FormFactorUnity<double>, double> pairwise(q_min, q_max, q_step, 1e9);
+        DebyeHistogramFormula<double> histogram(q_min, q_max, q_step, bin_width);
+        pairwise.sample(positions);
+        histogram.sample(positions);
+        const auto expected = pairwise.getIntensity();
+        const auto intensity = histogram.getIntensity();
+        REQUIRE_EQ(intensity.size(), expected.size());
+        for (auto [q, I] : intensity) {
+            CHECK(I == Approx(expected.at(q)).epsilon(1e-3));
+        }
+    }
+    SUBCASE("Cutoff and cell list") {
+        const double cutoff = 8.0, volume = 40.0 * 40.0 * 40.0;
+        DebyeFormula<FormFactorUnity<double>, double> pairwise(q_min, q_max, q_step, cutoff);
+        DebyeHistogramFormula<double> histogram(q_min, q_max, q_step, bin_width, cutoff);
+        pairwise.sample(positions, 1.0, volume);
+        histogram.sample(positions, 1.0, volume);
+        const auto expected = pairwise.getIntensity();
+        for (auto [q, I] : histogram.getIntensity()) {
+            CHECK(I == Approx(expected.at(q)).epsilon(1e-3));
+        }
+    }
+    CHECK_THROWS(DebyeHistogramFormula<double>(q_min, q_max, q_step, 0.0));
+}
+
 TEST_CASE("[Faunus] StructureFactorIPBC") {
     size_t cnt = 0;
     Point box = {80.0, 80.0, 80.0};
@@ -3,6 +3,9 @@
 #include <fstream>
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 namespace Faunus {
 
@@ -204,6 +207,231 @@ template <class Tformfactor, std::floating_point T = float> class DebyeFormula {
 };
 #pragma GCC diagnostic pop
 
+/**
+ * @brief Calculate scattering intensity, I(q), using the Debye formula on a pair distance histogram
+ *
+ * Pair distances are binned with resolution `dr` into a histogram that is averaged over all samples
+ * and transformed to I(q) only when requested. Sampling is O(N^2), or O(N) using a cell list
+ * if a cutoff is given, and is independent of the number of mesh points, M, while the transform
+ * is O(bins·M). Only point scatterers with unity form factor are supported.
+ *
+ * Binning displaces each pair distance by at most `dr/2`. Since |d(sin x / x)/dx| < 0.44, the
+ * error of each pair term, sin(qr)/(qr), is bounded by 0.22·q·dr, so that `dr` should be chosen
+ * such that q_max·dr ≪ 1. As with `DebyeFormula`, distances are calculated without periodicity.
+ *
+ * The JSON object is scanned for the following keywords:
+ *
+ * - `qmin` minimum q value (1/angstrom)
+ * - `qmax` maximum q value (1/angstrom)
+ * - `dq` q mesh spacing (1/angstrom)
+ * - `dr` histogram bin width (angstrom); default 0.01
+ * - `cutoff` cutoff distance (angstrom); *Experimental!*
+ */
+template <std::floating_point T = double> class DebyeHistogramFormula {
+    static constexpr T r_cutoff_infty = 1e9; //<! a cutoff distance in angstrom considered to be infinity
+    T q_mesh_min, q_mesh_max, q_mesh_step;   //<! q_mesh parameters in inverse angstrom
+    int number_of_mesh_points;               //!< Number of q values
+    T bin_width;                             //!< Histogram resolution (angstrom)
+    T r_cutoff;                              //!< cut-off distance for scattering contributions (angstrom)
+    std::vector<double> pair_histogram;      //!< Sum of weight/N for all pairs in each distance bin
+    double sum_of_weights = 0.0;             //!< Sum of sample weights
+    double sum_of_density_weights = 0.0;     //!< Sum of weight·N/V used for the cut-off correction
+
+    T q_mesh(int m) const { return q_mesh_min + m * q_mesh_step; }
+
+    static void addToHistogram(std::vector<double>& histogram, size_t bin, double value) {
+        if (bin >= histogram.size()) {
+            histogram.resize(bin + 1, 0.0);
+        }
+        histogram[bin] += value;
+    }
+
+    static void mergeHistograms(std::vector<double>& target, const std::vector<double>& source) {
+        if (source.size() > target.size()) {
+            target.resize(source.size(), 0.0);
+        }
+        std::transform(source.begin(), source.end(), target.begin(), target.begin(), std::plus<double>());
+    }
+
+    size_t bin(T squared_distance) const { return static_cast<size_t>(std::sqrt(squared_distance) / bin_width); }
+
+    /** Bin all pairs, O(N^2) */
+    template <class Tpositions> void binAllPairs(const Tpositions& positions, double value) {
+        const int N = static_cast<int>(positions.size());
+#pragma omp parallel default(shared)
+        {
+            std::vector<double> private_histogram;
+#pragma omp for schedule(dynamic)
+            for (int i = 0; i < N - 1; ++i) {
+                for (int j = i + 1; j < N; ++j) {
+                    addToHistogram(private_histogram, bin((positions[i] - positions[j]).squaredNorm()), value);
+                }
+            }
+#pragma omp critical
+            mergeHistograms(pair_histogram, private_histogram);
+        }
+    }
+
+    /** Bin pairs within the cutoff using a (non-periodic) cell list with cell length equal to the cutoff */
+    template <class Tpositions> void binPairsWithinCutoff(const Tpositions& positions, double value) {
+        using CellIndex = Eigen::Matrix<std::int64_t, 3, 1>;
+        constexpr std::int64_t max_cells = std::int64_t(1) << 20; // per dimension
+        Point origin = positions[0];
+        for (const auto& position : positions) {
+            origin = origin.cwiseMin(position);
+        }
+        auto cell_index = [&](const Point& position) -> CellIndex {
+            return ((position - origin) / r_cutoff).array().floor().template cast<std::int64_t>();
+        };
+        auto cell_key = [](const CellIndex& cell) { return (cell.x() * max_cells + cell.y()) * max_cells + cell.z(); };
+
+        std::unordered_map<std::int64_t, std::vector<int>> cells;
+        for (int i = 0; i < static_cast<int>(positions.size()); ++i) {
+            const auto cell = cell_index(positions[i]);
+            if ((cell.array() >= max_cells).any()) {
+                throw std::range_error("DebyeHistogramFormula: cutoff too small compared to system size");
+            }
+            cells[cell_key(cell)].push_back(i);
+        }
+        std::vector<const std::vector<int>*> cell_members; // for parallel iteration
+        std::vector<CellIndex> cell_indices;
+        for (const auto& [key, members] : cells) {
+            cell_members.push_back(&members);
+            cell_indices.push_back(cell_index(positions[members.front()]));
+        }
+
+        // half of the 26 neighbours, so that each pair of cells is visited once
+        std::vector<CellIndex> forward_offsets;
+        for (std::int64_t dx = -1; dx <= 1; ++dx) {
+            for (std::int64_t dy = -1; dy <= 1; ++dy) {
+                for (std::int64_t dz = -1; dz <= 1; ++dz) {
+                    if (dx > 0 || (dx == 0 && (dy > 0 || (dy == 0 && dz > 0)))) {
+                        forward_offsets.emplace_back(dx, dy, dz);
+                    }
+                }
+            }
+        }
+
+        const T squared_cutoff = r_cutoff * r_cutoff;
+        const int number_of_cells = static_cast<int>(cell_members.size());
+#pragma omp parallel default(shared)
+        {
+            std::vector<double> private_histogram;
+            auto add_pair = [&](int i, int j) {
+                const T squared_distance = (positions[i] - positions[j]).squaredNorm();
+                if (squared_distance < squared_cutoff) {
+                    addToHistogram(private_histogram, bin(squared_distance), value);
+                }
+            };
+#pragma omp for schedule(dynamic)
+            for (int c = 0; c < number_of_cells; ++c) {
+                const auto& members = *cell_members[c];
+                for (size_t i = 0; i < members.size(); ++i) { // pairs within cell
+                    for (size_t j = i + 1; j < members.size(); ++j) {
+                        add_pair(members[i], members[j]);
+                    }
+                }
+                for (const auto& offset : forward_offsets) { // pairs with neighbouring cells
+                    const CellIndex neighbour = cell_indices[c] + offset;
+                    if ((neighbour.array() < 0).any()) {
+                        continue;
+                    }
+                    if (auto it = cells.find(cell_key(neighbour)); it != cells.end()) {
+                        for (auto i : members) {
+                            for (auto j : it->second) {
+                                add_pair(i, j);
+                            }
+                        }
+                    }
+                }
+            }
+#pragma omp critical
+            mergeHistograms(pair_histogram, private_histogram);
+        }
+    }
+
+  public:
+    DebyeHistogramFormula(T q_min, T q_max, T q_step, T bin_width, T r_cutoff = r_cutoff_infty)
+        : bin_width(bin_width), r_cutoff(r_cutoff) {
+        if (q_step <= 0 || q_min <= 0 || q_max <= 0 || q_min > q_max) {
+            throw std::range_error("DebyeHistogramFormula: Invalid mesh parameters for q");
+        }
+        if (bin_width <= 0 || r_cutoff <= 0) {
+            throw std::range_error("DebyeHistogramFormula: Bin width and cutoff must be positive");
+        }
+        q_mesh_min = q_min;
+        q_mesh_max = q_max;
+        q_mesh_step = q_step;
+        number_of_mesh_points = numeric_cast<int>(1.0 + std::floor((q_max - q_min) / q_step));
+    }
+
+    explicit DebyeHistogramFormula(const json& j)
+        : DebyeHistogramFormula(j.at("qmin").get<double>(), j.at("qmax").get<double>(), j.at("dq").get<double>(),
+                                j.value("dr", 0.01), j.value("cutoff", r_cutoff_infty)) {}
+
+    /**
+     * @brief Add pair distances to histogram
+     * @param positions Vector of scattering positions
+     * @param weight weight of sampled configuration in biased simulations
+     * @param volume simulation volume (angstrom cubed) used only for cut-off correction
+     */
+    template <class Tpositions> void sample(const Tpositions& positions, const T weight = 1, const T volume = -1) {
+        if (positions.empty()) {
+            return;
+        }
+        const auto N = static_cast<double>(positions.size());
+        if (r_cutoff < r_cutoff_infty) {
+            binPairsWithinCutoff(positions, weight / N);
+            if (volume > 0) {
+                sum_of_density_weights += weight * N / volume;
+            }
+        } else {
+            binAllPairs(positions, weight / N);
+        }
+        sum_of_weights += weight;
+    }
+
+    T getBinWidth() const { return bin_width; }
+
+    /**
+     * @return a tuple of min, max, and step parameters of a q-mash
+     */
+    auto getQMeshParameters() const { return std::make_tuple(q_mesh_min, q_mesh_max, q_mesh_step); }
+
+    /**
+     * @return a map containing q (key) and average intensity (value)
+     */
+    std::map<T, T> getIntensity() const {
+        std::map<T, T> averaged_intensity;
+        std::vector<double> intensities(number_of_mesh_points, 0.0);
+        const int number_of_bins = static_cast<int>(pair_histogram.size());
+#pragma omp parallel for default(shared)
+        for (int m = 0; m < number_of_mesh_points; ++m) {
+            if (sum_of_weights <= 0.0) {
+                continue;
+            }
+            const double q = q_mesh(m);
+            double pair_sum = 0.0;
+            for (int bin = 0; bin < number_of_bins; ++bin) {
+                if (pair_histogram[bin] != 0.0) {
+                    const double qr = q * (bin + 0.5) * bin_width; // bin center
+                    pair_sum += pair_histogram[bin] * std::sin(qr) / qr;
+                }
+            }
+            double correction = 0.0;
+            if (r_cutoff < r_cutoff_infty) {
+                correction = 4.0 * pc::pi * sum_of_density_weights / std::pow(q, 3) *
+                             (q * r_cutoff * std::cos(q * r_cutoff) - std::sin(q * r_cutoff));
+            }
+            intensities[m] = (2.0 * pair_sum + sum_of_weights + correction) / sum_of_weights;
+        }
+        for (int m = 0; m < number_of_mesh_points; ++m) {
+            averaged_intensity.emplace(q_mesh(m), static_cast<T>(intensities[m]));
+        }
+        return averaged_intensity;
+    }
+};
+
 /**
  * A policy for collecting samples. To be used together with StructureFactor class templates.
  *
@@ -15,10 +15,42 @@ void Change::GroupChange::sort() {
     std::sort(relative_atom_indices.begin(), relative_atom_indices.end());
 }
 
+/**
+ * Allocated memory is kept so that a `Change` object can be reused in the MC loop without
+ * touching the heap: the group vector keeps its capacity and the atom index buffers of the
+ * cleared groups are stored for reuse by `addGroup()`.
+ */
 void Change::clear() {
-    *this = Change();
+    everything = false;
+    volume_change = false;
+    matter_change = false;
+    moved_to_moved_interactions = true;
+    for (auto& group_change : groups) {
+        if (group_change.relative_atom_indices.capacity() > 0 && spare_atom_indices.size() < groups.capacity()) {
+            group_change.relative_atom_indices.clear();
+            spare_atom_indices.push_back(std::move(group_change.relative_atom_indices));
+        }
+    }
+    groups.clear();
     assert(empty());
 }
+
+Change::GroupChange& Change::addGroup(const GroupChange& group_change) {
+    auto& added = groups.emplace_back();
+    if (!spare_atom_indices.empty()) {
+        added.relative_atom_indices = std::move(spare_atom_indices.back());
+        spare_atom_indices.pop_back();
+    }
+    added.group_index = group_change.group_index;
+    added.dNatomic = group_change.dNatomic;
+    added.dNswap = group_change.dNswap;
+    added.internal = group_change.internal;
+    added.all = group_change.all;
+    added.rigid_segment = group_change.rigid_segment;
+    added.relative_atom_indices.assign(group_change.relative_atom_indices.begin(),
+                                       group_change.relative_atom_indices.end());
+    return added;
+}
 bool Change::empty() const { return not(volume_change || everything || matter_change || !groups.empty()); }
 
 Change::operator bool() const { return !empty(); }
@@ -83,6 +115,9 @@ void to_json(json& j, const Change::GroupChange& group_change) {
     j = {{"all", group_change.all},           {"internal", group_change.internal},
          {"dNswap", group_change.dNswap},     {"dNatomic", group_change.dNatomic},
          {"index", group_change.group_index}, {"atoms", group_change.relative_atom_indices}};
+    if (group_change.rigid_segment) {
+        j["rigid segment"] = true;
+    }
 }
 
 void to_json(json& j, const Change& change) {
@@ -101,12 +136,35 @@ TEST_CASE("[Faunus] Change") {
     CHECK(change);
     change.clear();
     CHECK(change.empty());
+
+    SUBCASE("storage is recycled after clear()") {
+        Change::GroupChange group_change;
+        group_change.group_index = 2;
+        group_change.internal = true;
+        group_change.relative_atom_indices = {3, 5};
+        const auto* indices = change.addGroup(group_change).relative_atom_indices.data();
+        const auto* groups = change.groups.data();
+        change.clear();
+        CHECK(change.empty());
+        CHECK(change.groups.capacity() >= 1);
+        group_change.relative_atom_indices = {7};
+        const auto& added = change.addGroup(group_change);
+        CHECK(change.groups.data() == groups);
+        CHECK(added.relative_atom_indices.data() == indices);
+        CHECK(added.relative_atom_indices == std::vector<Change::index_type>{7});
+        CHECK(added.group_index == 2);
+        CHECK(added.internal);
+        CHECK_FALSE(added.rigid_segment);
+        CHECK(change.moved_to_moved_interactions);
+    }
 }
 
 void Space::clear() {
     particles.clear();
     groups.clear();
     implicit_reservoir.clear();
+    molecule_group_indices.clear();
+    number_of_indexed_groups = 0;
 }
 
 /**
@@ -148,7 +206,18 @@ Space::GroupType& Space::addGroup(MoleculeData::index_type molid, const Particle
             throw std::runtime_error("indivisible by atomic group size: "s + moldata.name);
         }
     }
-    return groups.emplace_back(group);
+    auto& inserted_group = groups.emplace_back(group);
+    if (number_of_indexed_groups + 1 == groups.size()) { // extend up-to-date lookup table
+        const auto id = static_cast<std::size_t>(molid);
+        if (id >= molecule_group_indices.size()) {
+            molecule_group_indices.resize(id + 1);
+        }
+        molecule_group_indices[id].push_back(groups.size() - 1);
+        number_of_indexed_groups = groups.size();
+    } else {
+        updateMoleculeLookup();
+    }
+    return inserted_group;
 }
 
 /**
@@ -182,6 +251,7 @@ void Space::sync(const Space &other, const Change &change) {
         implicit_reservoir = other.implicit_reservoir;                  // copy all implicit molecules
         particles = other.particles;                                    // copy all positions
         groups = other.groups;                                          // copy all groups
+        updateMoleculeLookup();                                         // rebuild molecule lookup table
         assert(particles.begin() != other.particles.begin());           // check deep copy problem
         assert(groups.front().begin() != other.groups.front().begin()); // check deep copy problem
     } else {
@@ -337,6 +407,31 @@ std::size_t Space::getGroupIndex(const Space::GroupType& group) const {
     throw std::out_of_range("invalid group index");
 }
 
+/**
+ * @return Indices in `groups` of all groups with the given molecule id, in ascending order
+ * @warning The lookup table must be up to date, see `updateMoleculeLookup()`
+ */
+const std::vector<std::size_t>& Space::groupIndicesOfMolecule(MoleculeData::index_type molid) const {
+    assert(number_of_indexed_groups == groups.size());
+    if (molid >= 0 && static_cast<std::size_t>(molid) < molecule_group_indices.size()) {
+        return molecule_group_indices[molid];
+    }
+    static const std::vector<std::size_t> no_groups;
+    return no_groups;
+}
+
+void Space::updateMoleculeLookup() {
+    molecule_group_indices.clear();
+    for (std::size_t group_index = 0; group_index < groups.size(); ++group_index) {
+        const auto id = static_cast<std::size_t>(groups[group_index].id);
+        if (id >= molecule_group_indices.size()) {
+            molecule_group_indices.resize(id + 1);
+        }
+        molecule_group_indices[id].push_back(group_index);
+    }
+    number_of_indexed_groups = groups.size();
+}
+
 std::size_t Space::getFirstParticleIndex(const GroupType& group) const {
     if (group.capacity() > 0 && !particles.empty()) {
         const auto distance = std::distance<ParticleVector::const_iterator>(particles.cbegin(), group.begin());
@@ -420,6 +515,7 @@ void from_json(const json &j, Space &spc) {
                     throw ConfigurationError("load error");
                 }
             }
+            spc.updateMoleculeLookup();
         }
 
         if (auto it = j.find("implicit_reservoir"); it != j.end() && it->is_array()) {
@@ -496,6 +592,7 @@ TEST_CASE("[Faunus] Space") {
         spc.groups.at(0).id = 0;
         spc.groups.at(1).id = 1;
         spc.groups.at(2).id = 0;
+        spc.updateMoleculeLookup(); // molecule ids were changed directly
 
         for (size_t i = 0; i < spc.particles.size(); i++)
             spc.particles[i].charge = double(i);
@@ -527,6 +624,21 @@ TEST_CASE("[Faunus] Space") {
             vals.push_back(static_cast<int>(particle.charge));
         }
         CHECK(vals == std::vector<int>({1, 2, 6, 7, 8}));
+
+        // molecule lookup table
+        CHECK(spc.groupIndicesOfMolecule(0) == std::vector<std::size_t>{0, 2});
+        CHECK(spc.groupIndicesOfMolecule(1) == std::vector<std::size_t>{1});
+        CHECK(spc.groupIndicesOfMolecule(5).empty());
+        auto inactive = spc.findMolecules(1, Space::Selection::INACTIVE);
+        CHECK(std::distance(inactive.begin(), inactive.end()) == 1);
+        CHECK(&(*inactive.begin()) == &spc.groups[1]);
+        auto all = spc.findMolecules(0, Space::Selection::ALL);
+        CHECK(std::distance(all.begin(), all.end()) == 2);
+        spc.addGroup(0, pvec); // lookup table must be refreshed
+        CHECK(spc.groupIndicesOfMolecule(0) == std::vector<std::size_t>{0, 2, 3});
+        const Space copy = spc; // copies carry a valid table and are safe for concurrent look-ups
+        CHECK(copy.groupIndicesOfMolecule(0) == std::vector<std::size_t>{0, 2, 3});
+        CHECK(spc.numMolecules<Space::GroupType::ACTIVE>(0) == 3);
     }
 }
 
@@ -25,6 +25,9 @@ namespace Faunus {
  *
  * - If `GroupChange::all==true` then `relative_atom_indices` may be left empty. This is to
  *   avoid constucting a large size N vector of indices.
+ * - If `GroupChange::rigid_segment==true` then all distances and relative orientations among the
+ *   particles in `relative_atom_indices` are unchanged, and energy terms may skip interactions
+ *   and bonds solely within this subset.
  */
 struct Change {
     using index_type = std::size_t;
@@ -40,6 +43,7 @@ struct Change {
         bool dNswap = false;    //!< The number of atoms has changed as a result of a swap move
         bool internal = false;  //!< The internal energy or configuration has changed
         bool all = false;       //!< All particles in the group have changed (leave relative_atom_indices empty)
+        bool rigid_segment = false; //!< Particles in relative_atom_indices moved as one rigid body (requires internal)
         std::vector<index_type> relative_atom_indices; //!< A subset of particles changed (sorted; empty if `all`=true)
 
         bool operator<(const GroupChange& other) const; //!< Comparison operator based on `group_index`
@@ -56,10 +60,14 @@ struct Change {
     //! List of changed atom index relative to first particle in system
     std::vector<index_type> touchedParticleIndex(const std::vector<Group>&) const;
 
-    void clear();                                                             //!< Clear all change data
+    void clear();                                                             //!< Clear all change data (keeps capacity)
+    GroupChange& addGroup(const GroupChange& group_change); //!< Append copy, recycling storage released by `clear()`
     bool empty() const;                                                       //!< Check if change object is empty
     explicit operator bool() const;                                           //!< True if object is not empty
     void sanityCheck(const std::vector<Group>& group_vector) const;           //!< Sanity check on contained object data
+
+  private:
+    std::vector<std::vector<index_type>> spare_atom_indices; //!< Index buffers released by `clear()`
 } __attribute__((aligned(32)));
 
 void to_json(json& j, const Change::GroupChange& group_change); //!< Serialize Change data to json
@@ -102,6 +110,17 @@ class Space {
     std::vector<ChangeTrigger> changeTriggers; //!< Call when a Change object is applied (unused)
     std::vector<SyncTrigger> onSyncTriggers; //!< Every element called after two Space objects are synched with `sync()`
 
+    /**
+     * @brief Lookup table with indices of all groups (active and inactive) of each molecule type
+     *
+     * The table is built whenever Space adds, removes or replaces groups (`addGroup()`, `sync()`,
+     * `clear()`, `from_json()`); look-ups never modify it and are thus safe from concurrent readers. Groups never
+     * change molecule type, so copies of Space carry a valid table. Activation and deactivation is handled by
+     * filtering on look-up. Code appending directly to `groups` must call `updateMoleculeLookup()`.
+     */
+    std::vector<std::vector<std::size_t>> molecule_group_indices;
+    std::size_t number_of_indexed_groups = 0; //!< `groups.size()` at latest build of the lookup table
+
   public:
     ParticleVector particles;                            //!< All particles are stored here!
     GroupVector groups;                                  //!< All groups are stored here (i.e. molecules)
@@ -130,6 +149,9 @@ class Space {
     json info();
 
     std::size_t getGroupIndex(const GroupType& group) const;         //!< Get index of given group in the group vector
+    const std::vector<std::size_t>&
+    groupIndicesOfMolecule(MoleculeData::index_type molid) const; //!< Index of all groups of a molecule type
+    void updateMoleculeLookup(); //!< Rebuild molecule look-up table; call after modifying `groups` directly
     std::size_t getFirstParticleIndex(const GroupType& group) const; //!< Index of first particle in group
     std::size_t getFirstActiveParticleIndex(
         const GroupType& group) const; //!< Index of first particle w. respect to active particles
@@ -198,8 +220,13 @@ class Space {
     //! Mutable iterable range of all particle positions
     auto positions() { return ranges::cpp20::views::transform(particles, &Particle::pos); }
 
-    static std::function<bool(const GroupType&)> getGroupFilter(MoleculeData::index_type molid,
-                                                                const Selection& selection) {
+    /**
+     * @brief Predicate to filter groups by molecule id and selection
+     *
+     * The returned lambda captures only the molecule id and selection; unlike a `std::function`
+     * it never allocates, which matters as `findMolecules()` is called in every move.
+     */
+    static auto getGroupFilter(MoleculeData::index_type molid, const Selection& selection) {
         auto is_active = [](const GroupType& group) { return group.size() == group.capacity(); };
 
         auto is_neutral = [](RequireParticleIterator auto begin, RequireParticleIterator auto end) {
@@ -208,45 +235,46 @@ class Space {
             return (fabs(charge) < 1e-6);
         }; //!< determines if range of particles is neutral
 
-        std::function<bool(const GroupType&)> f; //!< Lambda to filter groups according to selection
-
-        switch (selection) {
-        case (Selection::ALL):
-            f = []([[maybe_unused]] auto& group) { return true; };
-            break;
-        case (Selection::INACTIVE):
-            f = [=](auto& group) { return !is_active(group); };
-            break;
-        case (Selection::ACTIVE):
-            f = [=](auto& group) { return is_active(group); };
-            break;
-        case (Selection::ALL_NEUTRAL):
-            f = [=](auto& group) { return is_neutral(group.begin(), group.trueend()); };
-            break;
-        case (Selection::INACTIVE_NEUTRAL):
-            f = [=](auto& group) { return !is_active(group) && is_neutral(group.begin(), group.trueend()); };
-            break;
-        case (Selection::ACTIVE_NEUTRAL):
-            f = [=](auto& group) { return is_active(group) && is_neutral(group.begin(), group.end()); };
-            break;
-        }
-        return [f, molid](auto& group) { return group.id == molid && f(group); };
+        return [=](const GroupType& group) {
+            if (group.id != molid) {
+                return false;
+            }
+            switch (selection) {
+            case (Selection::ALL):
+                return true;
+            case (Selection::INACTIVE):
+                return !is_active(group);
+            case (Selection::ACTIVE):
+                return is_active(group);
+            case (Selection::ALL_NEUTRAL):
+                return is_neutral(group.begin(), group.trueend());
+            case (Selection::INACTIVE_NEUTRAL):
+                return !is_active(group) && is_neutral(group.begin(), group.trueend());
+            case (Selection::ACTIVE_NEUTRAL):
+                return is_active(group) && is_neutral(group.begin(), group.end());
+            }
+            return false;
+        };
     }
 
     /**
-     * @brief Finds all groups of type `molid` (complexity: order N)
+     * @brief Finds all groups of type `molid` (complexity: order number of `molid` groups)
      * @param molid Molecular id to look for
      * @param selection Selection
      * @return range with all groups of molid
      */
     auto findMolecules(MoleculeData::index_type molid, Selection selection = Selection::ACTIVE) {
         auto group_filter = getGroupFilter(molid, selection);
-        return groups | ranges::cpp20::views::filter(group_filter);
+        auto to_group = [this](const std::size_t group_index) -> GroupType& { return groups[group_index]; };
+        return groupIndicesOfMolecule(molid) | ranges::cpp20::views::transform(to_group) |
+               ranges::cpp20::views::filter(group_filter);
     }
 
     auto findMolecules(MoleculeData::index_type molid, Selection selection = Selection::ACTIVE) const {
         auto group_filter = getGroupFilter(molid, selection);
-        return groups | ranges::cpp20::views::filter(group_filter);
+        auto to_group = [this](const std::size_t group_index) -> const GroupType& { return groups[group_index]; };
+        return groupIndicesOfMolecule(molid) | ranges::cpp20::views::transform(to_group) |
+               ranges::cpp20::views::filter(group_filter);
     }
 
     auto activeParticles() { return groups | ranges::cpp20::views::join; }       //!< Range with all active particles
@@ -288,7 +316,7 @@ class Space {
         ranges::cpp20::views::filter([atomid](const Particle& particle) { return particle.id == atomid; });
     }
 
-    size_t countAtoms(AtomData::index_type atomid) const; //!< Count active particles
+    size_t countAtoms(AtomData::index_type atomid) const; //!< Count active particles (complexity: order N)
 
     /**
      * @brief Count number of molecules matching criteria
@@ -297,10 +325,9 @@ class Space {
      * @return Number of molecules matching molid and mask
      */
     template <unsigned int mask> auto numMolecules(MoleculeData::index_type molid) const {
-        auto filter = [&](const GroupType& group) {
-            return (group.id == molid) ? group.template match<mask>() : false;
-        };
-        return std::count_if(groups.begin(), groups.end(), filter);
+        const auto& group_indices = groupIndicesOfMolecule(molid);
+        return std::count_if(group_indices.begin(), group_indices.end(),
+                             [&](auto group_index) { return groups[group_index].template match<mask>(); });
     }
 
     void sync(const Space& other, const Change& change); //!< Copy differing data from other Space using Change object
@@ -4,6 +4,7 @@
 #include "range/v3/range/conversion.hpp"
 #include <algorithm>
 #include <range/v3/algorithm/all_of.hpp>
+#include <range/v3/algorithm/any_of.hpp>
 #include <range/v3/view/take.hpp>
 #include <range/v3/view/sample.hpp>
 #include <doctest/doctest.h>
@@ -171,6 +172,25 @@ bool ReactionValidator::canProduceAtomicGroups(const ReactionData& reaction) con
 
 // ----------------------------------------------
 
+void GroupDeActivator::setCavityInserter(std::shared_ptr<const CavityInserter> inserter) {
+    cavity_inserter = std::move(inserter);
+}
+
+/**
+ * With a cavity inserter, the position is drawn within an empty cell. Should all cells be
+ * occupied, the position is drawn uniformly as the move is then rejected by the cavity bias.
+ */
+Point GroupDeActivator::randomPosition(const Geometry::GeometryBase& geometry, Random& random) const {
+    if (cavity_inserter && cavity_inserter->emptyVolumeFraction() > 0.0) {
+        return cavity_inserter->randomEmptyPosition(random);
+    }
+    Point position;
+    geometry.randompos(position, random);
+    return position;
+}
+
+// ----------------------------------------------
+
 /**
  * Randomly assign a new mass center and random orientation
  */
@@ -178,8 +198,7 @@ void MolecularGroupDeActivator::setPositionAndOrientation(Group& group) const {
     auto& geometry = spc.geometry;
 
     // translate to random position within simulation cell
-    Point new_mass_center;
-    geometry.randompos(new_mass_center, random); // place COM randomly in simulation box
+    const Point new_mass_center = randomPosition(geometry, random); // place COM randomly in simulation box
     Point displacement = geometry.vdist(new_mass_center, group.massCenter()->get());
     group.translate(displacement, geometry.getBoundaryFunc());
 
@@ -284,7 +303,7 @@ GroupDeActivator::ChangeAndBias AtomicGroupDeActivator::activate(Group& group,
     for (int i = 0; i < number_to_insert.value(); i++) {
         group.activate(group.end(), group.end() + 1); // activate one particle
         auto last_atom = group.end() - 1;
-        spc.geometry.randompos(last_atom->pos, random); // give it a random position
+        last_atom->pos = randomPosition(spc.geometry, random); // give it a random position
         spc.geometry.getBoundaryFunc()(last_atom->pos); // apply PBC if needed
         change_data.relative_atom_indices.push_back(std::distance(group.begin(), last_atom)); // index relative to group
     }
@@ -343,6 +362,9 @@ void SpeciationMove::_to_json(json& j) const {
     for (auto [molid, size] : average_reservoir_size) {
         j["implicit_reservoir"][molecules.at(molid).name] = size.avg();
     }
+    if (cavity_inserter) {
+        j["cavity"] = {{"empty volume fraction", mean_empty_volume_fraction.avg()}};
+    }
 }
 
 /**
@@ -508,6 +530,7 @@ void SpeciationMove::_move(Change& change) {
         if (reaction_validator.isPossible(*reaction)) {
             atomicSwap(change);
             deactivateReactants(change);
+            bias_energy += cavityBias(change);
             activateProducts(change);
             std::sort(change.groups.begin(), change.groups.end()); // change groups *must* be sorted!
             if (change) {
@@ -542,6 +565,58 @@ void SpeciationMove::updateGroupMassCenters(const Change& change) const {
     });
 }
 
+/**
+ * The cavity grid is built from the trial configuration after deactivating the reactants,
+ * which is also the configuration from which the reverse move activates them. Each activated
+ * point (atom of an atomic group or mass center of a molecular group) is drawn from the fraction,
+ * f, of empty cells, and the reverse move can regenerate a deactivated point only if it lies
+ * within an empty cell. With n deactivated and m activated points, the bias is thus (n - m) ln f.
+ *
+ * @param change Change holding the deactivated groups; activations must not have been made
+ * @returns Bias energy (kT); zero if cavity bias is disabled, infinite if the reverse move is impossible
+ */
+double SpeciationMove::cavityBias(const Change& change) {
+    namespace rv = ranges::cpp20::views;
+    if (!cavity_inserter) {
+        return 0.0;
+    }
+    cavity_inserter->update(spc.geometry.getLength(), spc.activeParticles());
+    const auto empty_fraction = cavity_inserter->emptyVolumeFraction();
+    mean_empty_volume_fraction += empty_fraction;
+
+    int number_of_deactivated_points = 0;
+    for (const auto& group_change : change.groups) {
+        const auto& group = spc.groups.at(group_change.group_index);
+        if (group_change.dNatomic) { // deactivated atoms are kept just beyond the active range
+            for (const auto index : group_change.relative_atom_indices) {
+                if (!cavity_inserter->isEmpty((group.begin() + index)->pos)) {
+                    return pc::infty;
+                }
+                ++number_of_deactivated_points;
+            }
+        } else if (group.isMolecular() && group.empty() && group_change.all) {
+            if (!cavity_inserter->isEmpty(group.mass_center)) {
+                return pc::infty;
+            }
+            ++number_of_deactivated_points;
+        }
+    }
+
+    auto explicit_products = reaction->getProducts().second | rv::filter(ReactionData::not_implicit_group);
+    int number_of_activated_points = 0;
+    for (const auto [molid, number_to_insert] : explicit_products) {
+        number_of_activated_points += number_to_insert;
+    }
+
+    if (number_of_activated_points > 0 && empty_fraction == 0.0) {
+        return pc::infty;
+    }
+    if (number_of_activated_points == number_of_deactivated_points) {
+        return 0.0;
+    }
+    return static_cast<double>(number_of_deactivated_points - number_of_activated_points) * std::log(empty_fraction);
+}
+
 /**
  * The acceptance/rejection of the move is affected by the equilibrium constant,
  * but unaffected by the change in internal bond energy
@@ -593,6 +668,23 @@ SpeciationMove::SpeciationMove(Space& spc, Space& old_spc, std::string_view name
 SpeciationMove::SpeciationMove(Space& spc, Space& old_spc)
     : SpeciationMove(spc, old_spc, "rcmc", "doi:10/fqcpg3") {}
 
-void SpeciationMove::_from_json([[maybe_unused]] const json& j) {}
+void SpeciationMove::_from_json(const json& j) {
+    if (const auto cell_length = j.value("cavity", 0.0); cell_length > 0.0) {
+        if (spc.geometry.type != Geometry::Variant::CUBOID) {
+            throw ConfigurationError("cavity bias requires a cuboidal geometry");
+        }
+        cavity_inserter = std::make_shared<CavityInserter>(cell_length);
+        for (const auto& molecule : Faunus::molecules) {
+            auto is_reactive = [&](const ReactionData& reaction) {
+                return reaction.participatingAtomsAndMolecules().second.count(molecule.id()) > 0;
+            };
+            if (!molecule.isImplicit() && ranges::cpp20::any_of(Faunus::reactions, is_reactive)) {
+                cavity_inserter->checkCellSize(molecule);
+            }
+        }
+        molecular_group_bouncer->setCavityInserter(cavity_inserter);
+        atomic_group_bouncer->setCavityInserter(cavity_inserter);
+    }
+}
 
 } // namespace Faunus::Move
@@ -27,11 +27,16 @@ class ReactionValidator {
  * Helper base class for (de)activating groups in speciation move
  */
 class GroupDeActivator {
+  protected:
+    std::shared_ptr<const CavityInserter> cavity_inserter; //!< If set, activated positions are in empty cells
+    Point randomPosition(const Geometry::GeometryBase& geometry, Random& random) const; //!< Position for activation
+
   public:
     using ChangeAndBias = std::pair<Change::GroupChange, double>; //!< Group change and bias energy
     using OptionalInt = std::optional<int>;
     virtual ChangeAndBias activate(Group& group, OptionalInt num_particles = std::nullopt) = 0;
     virtual ChangeAndBias deactivate(Group& group, OptionalInt num_particles = std::nullopt) = 0;
+    void setCavityInserter(std::shared_ptr<const CavityInserter> inserter); //!< Activate into empty cells only
     virtual ~GroupDeActivator() = default;
 };
 
@@ -112,6 +117,9 @@ namespace Faunus::Move {
  *    - deactivate reactants
  *    - activate products
  *
+ * With cavity bias, atoms of atomic groups and mass centers of molecular groups are activated
+ * only in empty cells of a grid built after deactivating the reactants; see `cavityBias()`.
+ *
  * @todo Split atom-swap functionality to separate helper class
  */
 class SpeciationMove : public MoveBase {
@@ -124,6 +132,9 @@ class SpeciationMove : public MoveBase {
     std::unique_ptr<Speciation::GroupDeActivator> molecular_group_bouncer; //!< (de)activator for molecular groups
     std::unique_ptr<Speciation::GroupDeActivator> atomic_group_bouncer;    //!< (de)activator for atomic groups
 
+    std::shared_ptr<CavityInserter> cavity_inserter;                      //!< Set if insertions are cavity biased
+    Average<double> mean_empty_volume_fraction;                            //!< Average fraction of empty cells
+
     std::map<MoleculeData::index_type, Average<double>>
         average_reservoir_size; //!< Average number of implicit molecules
 
@@ -142,6 +153,7 @@ class SpeciationMove : public MoveBase {
     void deactivateMolecularGroups(Change& change);
     void activateMolecularGroups(Change& change);
     void updateGroupMassCenters(const Change& change) const; //!< Update affected molecular mass centers
+    double cavityBias(const Change& change);                 //!< Update cavity grid and return bias (kT)
     void swapParticleProperties(Particle& particle, int new_atomid) const;
     SpeciationMove(Space& spc, Space& old_spc, std::string_view name, std::string_view cite);
 